@@ -1,5 +1,6 @@
 #include <Wire.h>
 #include "config.h"
+#include "util_i2cbus.h"
 #include "display_oled.h"
 #include "sensor_max30102.h"
 #include "sensor_max30205.h"
@@ -8,6 +9,11 @@
 #include "net_wifiweb.h"
 #include "net_ota.h"
 #include "net_ble.h"
+#include "util_scheduler.h"
+#include "app_tasks.h"
+#include "dsp_trend.h"
+#include "log_flash.h"
+#include "util_stats.h"
 
 DisplayOLED     oled;
 Max30102Sensor  spo2;
@@ -20,30 +26,50 @@ Settings        settings;
 BLEMetrics      ble;
 #endif
 
-TwoWire& BUS = Wire;
+I2CBus          bus;
+Scheduler       sched;
+VitalTrends     trends;         // 10-minute sparklines for the OLED trend page
+#ifdef ENABLE_FLASH_LOG
+FlashLog        flashLog;       // ECG + vitals history in flash
+#endif
+
+// Task periods (ms). Lower priority number = more urgent.
+// MAX30102 FIFO drain + compute: 50 Hz, or 10 Hz with the FIFO interrupt
+// (poll() reads only once INT is asserted, every 17 samples = 340 ms)
+const uint32_t SPO2_PERIOD_MS = MAX30102_INT_PIN >= 0 ? 100 : 20;
+const uint32_t TEMP_PERIOD_MS = TEMP_READ_PERIOD_MS;
+const uint32_t WEB_PERIOD_MS  = 5;      // HTTP + SSE pump
+const uint32_t BLE_PERIOD_MS  = BLE_POLL_MS;   // change-driven notifications
+const uint32_t OTA_PERIOD_MS  = 50;
+const uint32_t TREND_PERIOD_MS = 1000;
+
+int  uiTask = -1;                       // period follows oled.framePeriodMs()
 
-uint32_t lastUiMs = 0;
-const uint32_t UI_PERIOD_MS = 20;
+void renderUi();
+void sampleTrends();
+
+// Current vitals, with the same "not valid" conventions as the sensors.
+struct Vitals {
+  bool  hasFinger = false, hasTemp = false;
+  int   bpm = -1, o2 = -1, sqi = 0;
+  float pi = 0.0f, tempC = NAN;
+};
 
 void setup() {
   Serial.begin(115200);
-  delay(200);
 
   settings.begin();
 
-  BUS.begin(I2C_SDA, I2C_SCL);
-  BUS.setClock(100000);       // keep bus gentle for multiple devices
+  bus.begin(Wire, I2C_SDA, I2C_SCL, I2C_BUS_HZ);
 
-  oled.begin(BUS);
+  oled.begin(bus);
   oled.splash();
 
-  // (optional) scanI2C(BUS);
-
 #ifdef ENABLE_MAX30102
-  spo2.begin(BUS);
+  spo2.begin(bus);
 #endif
 #ifdef ENABLE_MAX30205
-  tprobe.begin(BUS);
+  tprobe.begin(bus);
 #endif
 #ifdef ENABLE_AD8232
   ecg.begin(ECG_PIN, ECG_SAMPLE_HZ, ECG_LOP_PIN, ECG_LON_PIN);
@@ -64,63 +90,136 @@ void setup() {
 #endif
   oled.detectSummary(has30102, has30205);
 
+#ifdef ENABLE_FLASH_LOG
+#ifdef ENABLE_AD8232
+  flashLog.begin(&ecg, settings.nextBootId());
+#else
+  flashLog.begin(nullptr, settings.nextBootId());
+#endif
+  web.attachLog(&flashLog);
+#endif
+
   // Wi-Fi + Web + OTA
   web.attachMetricsSource(&spo2, &tprobe);
   web.attachECG(&ecg);                      // <-- add
+  web.attachBus(&bus);
+  web.attachDisplay(&oled);
+  ota.begin(DEFAULT_HOSTNAME, OTA_PASSWORD);  // listens from the first link or the AP on
+  web.attachOTA(&ota);
   web.beginAuto(settings, DEFAULT_AP_SSID, DEFAULT_AP_PASS, DEFAULT_HOSTNAME);
-  ota.begin(DEFAULT_HOSTNAME, OTA_PASSWORD);
 
 #ifdef ENABLE_BLE
+#ifdef ENABLE_AD8232
+  ble.attachSensors(&spo2, &tprobe, &ecg);
+#else
   ble.attachSensors(&spo2, &tprobe);
+#endif
   ble.begin(DEFAULT_HOSTNAME);
 #endif
 
-  Serial.println("Setup complete.");
-}
+  // Sensor work: on its own tasks, or scheduled from loop() below.
+  appTasksBegin(&ecg, &spo2, &tprobe);
 
-void loop() {
+  // Scheduled work; the ECG is sampled by its own timer unless polling.
+#ifndef ENABLE_RTOS_TASKS
+#if defined(ENABLE_AD8232) && !defined(ECG_ACQ_TIMER)
+  sched.add("ecg",  [](void*){ ecg.update(); }, nullptr, 1000000UL / ECG_SAMPLE_HZ, 0);
+#endif
 #ifdef ENABLE_MAX30102
-  spo2.update();
+  sched.add("spo2", [](void*){ spo2.update(); }, nullptr, SPO2_PERIOD_MS * 1000, 1);
 #endif
 #ifdef ENABLE_MAX30205
-  tprobe.update();
+  sched.add("temp", [](void*){ tprobe.update(); }, nullptr, TEMP_PERIOD_MS * 1000, 3);
 #endif
-#ifdef ENABLE_AD8232
-  ecg.update();         // <-- add
 #endif
-
-  web.handle();
-  ota.handle();
+  sched.add("web",  [](void*){ web.handle(); }, nullptr, WEB_PERIOD_MS * 1000, 2, 50000);
+  uiTask = sched.add("ui", [](void*){ renderUi(); }, nullptr, OLED_FAST_MS * 1000, 4);
+  trends.begin(millis());
+  sched.add("trend", [](void*){ sampleTrends(); }, nullptr, TREND_PERIOD_MS * 1000, 5);
 #ifdef ENABLE_BLE
-  ble.handle();
+  sched.add("ble",  [](void*){ ble.handle(); }, nullptr, BLE_PERIOD_MS * 1000, 5);
+#ifdef ENABLE_AD8232
+  sched.add("bleecg", [](void*){ ble.pumpEcg(); }, nullptr, BLE_ECG_PERIOD_MS * 1000, 3);
+#endif
 #endif
+  sched.add("ota",  [](void*){ ota.handle(); }, nullptr, OTA_PERIOD_MS * 1000, 6);
+#ifdef ENABLE_FLASH_LOG
+  sched.add("log",  [](void*){ flashLog.pollEcg(); }, nullptr, LOG_POLL_MS * 1000UL, 6);
+#endif
+#ifdef SCHED_DEBUG
+  sched.add("stats", [](void*){
+              sched.printStats(Serial); sched.resetStats();
+              Serial.printf("oled: %lu B/s\n", (unsigned long)oled.bytesPerSec());
+            }, nullptr, SCHED_DEBUG_PERIOD_MS * 1000UL, 7);
+#endif
+#if defined(ENABLE_STATS) && STATS_SERIAL_MS > 0
+  sched.add("probes", [](void*){ statsPrint(Serial); }, nullptr, STATS_SERIAL_MS * 1000UL, 7);
+#endif
+  sched.begin();
+
+  Serial.println("Setup complete.");
+}
 
-  uint32_t now = millis();
-  if (now - lastUiMs >= UI_PERIOD_MS) {
-    lastUiMs = now;
+void loop() {
+  sched.loop();
+}
 
+static Vitals readVitals() {
+  Vitals v;
 #ifdef ENABLE_MAX30102
-    bool    hasFinger   = spo2.hasFinger();
-    bool    beatRecent  = spo2.beatRecently();
-    int     bpm         = spo2.bpmRounded();
-    int     o2          = spo2.spo2Rounded();
-    float   pi          = spo2.perfusionIndex();
-#else
-    bool    hasFinger   = false;
-    bool    beatRecent  = false;
-    int     bpm         = -1;
-    int     o2          = -1;
-    float   pi          = 0.0f;
+  v.hasFinger  = spo2.hasFinger();
+  v.bpm        = spo2.bpmRounded();
+  v.o2         = spo2.spo2Rounded();
+  v.pi         = spo2.perfusionIndex();
+  v.sqi        = spo2.signalQuality();
 #endif
-
 #ifdef ENABLE_MAX30205
-    bool    hasTemp     = tprobe.hasTemp();
-    float   tempC       = tprobe.tempC();
-#else
-    bool    hasTemp     = false;
-    float   tempC       = NAN;
+  v.hasTemp    = tprobe.hasTemp();
+  v.tempC      = tprobe.tempC();
 #endif
+  return v;
+}
 
-    oled.render(beatRecent, bpm, o2, hasTemp, tempC, hasFinger, pi);
+void renderUi() {
+  if (oled.holding()) return;        // boot summary still up
+  switch (oled.page()) {
+    case DisplayOLED::PAGE_WAVE:
+#ifdef ENABLE_AD8232
+      oled.renderWave(&ecg, &spo2);
+#else
+      oled.renderWave(nullptr, &spo2);
+#endif
+      break;
+    case DisplayOLED::PAGE_TRENDS:
+      oled.renderTrends(trends);
+      break;
+    default: {
+      Vitals v = readVitals();
+      oled.render(v.bpm, v.o2, v.hasTemp, v.tempC, v.hasFinger, v.pi);
+      break;
+    }
   }
+  sched.setPeriod(uiTask, oled.framePeriodMs() * 1000);
+}
+
+// 1 Hz: OLED trend buckets and the flash log's vitals record
+void sampleTrends() {
+  Vitals v = readVitals();
+  trends.sample(v.bpm, v.o2, v.hasTemp, v.tempC, millis());
+
+#ifdef ENABLE_FLASH_LOG
+  LogVitals lv;
+  lv.pulse   = v.bpm;
+  lv.spo2    = v.o2;
+  lv.finger  = v.hasFinger;
+  lv.pi      = v.pi;
+  lv.sqi     = (uint8_t)v.sqi;
+  lv.hasTemp = v.hasTemp;
+  lv.tempC   = v.tempC;
+#ifdef ENABLE_AD8232
+  lv.ecgBpm   = ecg.ecgBpm() > 0 ? ecg.ecgBpm() : -1;
+  lv.leadsOff = ecg.leadsOff();
+#endif
+  flashLog.addVitals(lv);
+#endif
 }
@@ -0,0 +1,107 @@
+// app_tasks.cpp
+#include "app_tasks.h"
+
+#if defined(ENABLE_RTOS_TASKS) && !defined(ECG_ACQ_TIMER)
+#error "ENABLE_RTOS_TASKS needs ECG_ACQ_TIMER (the ECG is sampled by its timer, not a task)"
+#endif
+
+static TaskHandle_t s_loop = nullptr;
+
+#ifdef ENABLE_RTOS_TASKS
+static AD8232Sensor*   s_ecg  = nullptr;
+static Max30102Sensor* s_spo2 = nullptr;
+static Max30205Sensor* s_tp   = nullptr;
+static TaskHandle_t    s_acq  = nullptr;
+static TaskHandle_t    s_dsp  = nullptr;
+
+#if defined(ENABLE_MAX30102) && MAX30102_INT_PIN >= 0
+#define ACQ_ON_INT
+// MAX30102 FIFO almost-full ISR hook
+static void IRAM_ATTR wakeAcq() {
+  BaseType_t woken = pdFALSE;
+  if (s_acq) vTaskNotifyGiveFromISR(s_acq, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+#endif
+
+// Fixed cadence with vTaskDelayUntil: no drift, and a late wake-up does not
+// shift later ones. With the MAX30102 interrupt the task sleeps instead
+// until INT, the next temperature read or the FIFO backstop read.
+static void acqTask(void*) {
+#ifndef ACQ_ON_INT
+  TickType_t wake = xTaskGetTickCount();
+#endif
+  uint32_t tempDue = millis();
+  for (;;) {
+#ifdef ENABLE_MAX30102
+    if (s_spo2) s_spo2->poll();
+#endif
+#ifdef ENABLE_MAX30205
+    if (s_tp && (int32_t)(millis() - tempDue) >= 0) {
+      tempDue += TEMP_READ_PERIOD_MS;
+      s_tp->update();
+    }
+#endif
+#ifdef ACQ_ON_INT
+    int32_t waitMs = MAX30102_INT_POLL_MS;
+#ifdef ENABLE_MAX30205
+    if ((int32_t)(tempDue - millis()) < waitMs) waitMs = (int32_t)(tempDue - millis());
+#endif
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs > 0 ? waitMs : 0));
+#else
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(ACQ_TASK_PERIOD_MS));
+#endif
+  }
+}
+
+static void dspTask(void*) {
+  TickType_t wake = xTaskGetTickCount();
+  for (;;) {
+#ifdef ENABLE_AD8232
+    if (s_ecg) s_ecg->process();
+#endif
+#ifdef ENABLE_MAX30102
+    if (s_spo2) s_spo2->process();
+#endif
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(DSP_TASK_PERIOD_MS));
+  }
+}
+#endif // ENABLE_RTOS_TASKS
+
+void appTasksBegin(AD8232Sensor* ecg, Max30102Sensor* spo2, Max30205Sensor* tprobe) {
+  s_loop = xTaskGetCurrentTaskHandle();
+#ifdef ENABLE_RTOS_TASKS
+  s_ecg = ecg; s_spo2 = spo2; s_tp = tprobe;
+  // single core: no pinning needed, priorities decide
+  if (xTaskCreate(acqTask, "acq", ACQ_TASK_STACK, nullptr, ACQ_TASK_PRIO, &s_acq) != pdPASS)
+    Serial.println("Tasks: acq create failed");
+#ifdef ACQ_ON_INT
+  Max30102Sensor::onInterrupt(wakeAcq);
+#endif
+  if (xTaskCreate(dspTask, "dsp", DSP_TASK_STACK, nullptr, DSP_TASK_PRIO, &s_dsp) != pdPASS)
+    Serial.println("Tasks: dsp create failed");
+#else
+  (void)ecg; (void)spo2; (void)tprobe;
+#endif
+}
+
+// ESP-IDF reports stack sizes and high-water marks in bytes.
+static int addInfo(AppTaskInfo* out, int n, int max, TaskHandle_t h,
+                   const char* name, uint32_t stack) {
+  if (!h || n >= max) return n;
+  out[n].name       = name;
+  out[n].prio       = (uint8_t)uxTaskPriorityGet(h);
+  out[n].stackBytes = stack;
+  out[n].stackFree  = (uint32_t)uxTaskGetStackHighWaterMark(h);
+  return n + 1;
+}
+
+int appTaskInfo(AppTaskInfo* out, int max) {
+  int n = 0;
+#ifdef ENABLE_RTOS_TASKS
+  n = addInfo(out, n, max, s_acq, "acq", ACQ_TASK_STACK);
+  n = addInfo(out, n, max, s_dsp, "dsp", DSP_TASK_STACK);
+#endif
+  n = addInfo(out, n, max, s_loop, "loop", (uint32_t)getArduinoLoopTaskStackSize());
+  return n;
+}
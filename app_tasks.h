@@ -0,0 +1,28 @@
+// app_tasks.h
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "sensor_max30102.h"
+#include "sensor_max30205.h"
+#include "sensor_ad8232.h"
+
+// Optional FreeRTOS split (ENABLE_RTOS_TASKS):
+//   acq  (ACQ_TASK_PRIO)  MAX30102 FIFO -> raw ring, MAX30205 reads
+//                         (woken by the FIFO interrupt with MAX30102_INT_PIN)
+//   dsp  (DSP_TASK_PRIO)  ECG block filter + QRS, MAX30102 SpO2/BPM/PI
+//   loop (1, Arduino)     scheduler: web, OLED, BLE, OTA
+// The ECG itself is sampled by its esp_timer callback into a raw ring.
+// Stages hand off through the lock-free sample rings, so a slow HTTP
+// client or OTA only delays the loop task.
+// Without ENABLE_RTOS_TASKS appTasksBegin() just records the loop task so
+// stack reporting works the same.
+void appTasksBegin(AD8232Sensor* ecg, Max30102Sensor* spo2, Max30205Sensor* tprobe);
+
+struct AppTaskInfo {
+  const char* name;
+  uint8_t     prio;
+  uint32_t    stackBytes;     // allocated
+  uint32_t    stackFree;      // high-water mark: least free bytes ever
+};
+// Fills up to max entries, returns the count.
+int appTaskInfo(AppTaskInfo* out, int max);
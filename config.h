@@ -4,23 +4,89 @@
 // --------- I2C pins for Abrobot ESP32-C3 OLED board ----------
 #define I2C_SDA 5
 #define I2C_SCL 6
+// 400 kHz Fast-mode. Fast-mode Plus (1 MHz) is not an option on this bus:
+// the MAX30102 and MAX30205 are rated for 400 kHz only.
+#define I2C_BUS_HZ 400000
 
 // --------- OLED window (inside 128x64 RAM) ----------
 static const int OLED_XOFF = 30;
 static const int OLED_YOFF = 12;
 static const int OLED_W    = 70;   // was 72; we use 70 for nicer margins
 static const int OLED_H    = 40;
+// Frame pacing: fast while the signal bar animates, slow when only the
+// numbers can change (they update about once a second).
+static const uint32_t OLED_FAST_MS = 20;
+static const uint32_t OLED_IDLE_MS = 200;
+// ECG/pleth sweep page: one sweep across the window, and its frame period.
+static const uint32_t OLED_WAVE_MS       = 2800;
+static const uint32_t OLED_WAVE_FRAME_MS = 40;    // 25 fps
+// Sensor summary screen at boot (setup() does not wait for it)
+static const uint32_t OLED_SUMMARY_MS = 1200;
+// Button that cycles the OLED pages (BOOT button on most C3 boards), -1 = none
+#define OLED_BUTTON_PIN 9
 
 // --------- Feature switches ----------
 #define ENABLE_MAX30102
+// MAX30102 INT (open drain, active low) on a GPIO: the FIFO almost-full
+// interrupt (17 samples) then gates the FIFO reads instead of a 50 Hz poll,
+// with a read every MAX30102_INT_POLL_MS as a backstop. -1 = poll.
+#define MAX30102_INT_PIN     -1
+#define MAX30102_INT_POLL_MS 500
 #define ENABLE_MAX30205
 // Enable BLE broadcasting of metrics
 #define ENABLE_BLE
+// BLE (net_ble.h): values are checked every BLE_POLL_MS and notified when
+// they change, no more often than BLE_MIN_NOTIFY_MS; unchanged values are
+// repeated every BLE_HEARTBEAT_MS.
+#define BLE_POLL_MS        250
+#define BLE_MIN_NOTIFY_MS  1000
+#define BLE_HEARTBEAT_MS   5000
+// ECG waveform characteristic (with ENABLE_AD8232): requested ATT MTU,
+// pump period and notifications per pump.
+#define BLE_MTU            517
+#define BLE_ECG_PERIOD_MS  10
+#define BLE_ECG_MAX_FRAMES 4
+
+// --------- Scheduler (util_scheduler.h) ----------
+// Print per-task run time / lateness / deadline misses every period.
+// #define SCHED_DEBUG
+#define SCHED_DEBUG_PERIOD_MS 10000
+// Let the idle task light-sleep between releases (needs a core with
+// power management enabled; Wi-Fi then runs in modem-sleep).
+// #define SCHED_LIGHT_SLEEP
+
+// --------- Instrumentation (util_stats.h) ----------
+// Cycle-counter timing histograms of the hot paths for /api/stats.
+// Comment out to compile every probe out.
+#define ENABLE_STATS
+#define STATS_SERIAL_MS 0           // also print them on Serial every N ms (0 = off)
+
+// --------- FreeRTOS task split (app_tasks.h) ----------
+// Sensors on an acquisition task, filtering on a DSP task, network/UI on
+// loop(). Needs ECG_ACQ_TIMER. Comment out to run everything from loop().
+// #define ENABLE_RTOS_TASKS
+#define ACQ_TASK_PRIO        10
+#define ACQ_TASK_STACK       3072   // bytes
+#define ACQ_TASK_PERIOD_MS   20     // MAX30102 FIFO poll
+#define TEMP_READ_PERIOD_MS  500    // MAX30205
+#define DSP_TASK_PRIO        5
+#define DSP_TASK_STACK       4096
+#define DSP_TASK_PERIOD_MS   10
+#define ECG_RAW_SAMPLES      512    // raw ECG between timer and DSP (~1 s at 500 Hz)
 
 // --------- Wi-Fi / Web ----------
 #define DEFAULT_AP_SSID     "ESP32C3-Health"
 #define DEFAULT_AP_PASS     ""              // empty = open AP
 #define DEFAULT_HOSTNAME    "esp32c3-health" // mDNS for STA mode
+// Station connection (net_wifi.h), all in the background: give up on an
+// attempt after WIFI_CONNECT_TIMEOUT_MS, retry after WIFI_BACKOFF_MIN_MS
+// doubling up to WIFI_BACKOFF_MAX_MS, and bring the config AP up beside
+// the station after WIFI_AP_FALLBACK_MS without a link.
+#define WIFI_CONNECT_TIMEOUT_MS 10000
+#define WIFI_BACKOFF_MIN_MS     1000
+#define WIFI_BACKOFF_MAX_MS     60000
+#define WIFI_AP_FALLBACK_MS     15000
+#define NTP_SERVER          "pool.ntp.org"  // set the clock once online ("" = off)
 
 // --------- OTA ----------
 #define OTA_PASSWORD        ""              // set a password before deploying!
@@ -31,6 +97,38 @@ static constexpr float DC_PI_GUARD   = 12000.0f;  // DC min to compute PI
 static constexpr float PI_BAR_FULL   = 10.0f;     // 10% => full bar
 static constexpr float PI_CLAMP_MAX  = 30.0f;     // clamp absurd spikes for UI
 static constexpr uint32_t PI_HOLD_MS = 1500;      // hold last PI when DC dips
+// Pulse rate from autocorrelation of the IR window (dsp_pulserate.h) once a
+// second. Comment out to use the per-sample peak detector instead.
+#define PPG_RATE_ACF
+static constexpr float PPG_RATE_MIN_CONF   = 0.5f;  // min correlation to accept a rate
+static constexpr uint32_t PPG_RATE_HOLD_MS = 3000;  // hold the last one through dips
+// Signal quality index 0..100 (Max30102Sensor::signalQuality()). Windows
+// below SQI_MIN do not update pulse/SpO2; the last good SpO2 is held for
+// SQI_HOLD_MS (the rate for PPG_RATE_HOLD_MS), then hidden.
+static constexpr int SQI_MIN          = 50;
+static constexpr uint32_t SQI_HOLD_MS = 5000;
+
+// --------- MAX30102 LED current / sample rate ----------
+// LED codes are 0.2 mA per step. PPG_AGC steers each channel's raw DC into
+// PPG_DC_LOW..PPG_DC_HIGH (18-bit ADC counts) once a second; samples are
+// scaled back to PPG_LED_INIT, so DC_NOFINGER and the DSP see the same
+// levels as at a fixed PPG_LED_INIT. Comment out for a fixed current.
+#define PPG_AGC
+static constexpr uint8_t PPG_LED_INIT  = 0x50;     // 16 mA, also the reference
+static constexpr uint8_t PPG_LED_MIN   = 0x08;     // 1.6 mA (keeps scaled samples < 22 bits)
+static constexpr uint8_t PPG_LED_MAX   = 0xFF;     // 51 mA
+static constexpr int32_t PPG_DC_LOW    = 60000;
+static constexpr int32_t PPG_DC_HIGH   = 200000;
+static constexpr int32_t PPG_DC_TARGET = 120000;
+// Proximity mode after PPG_PROX_AFTER_MS without a finger (IR only at
+// PPG_PROX_LED, 12.5 samples/s polled every PPG_PROX_POLL_MS), and 200 sps
+// with 4x averaging from a window below SQI_MIN until PPG_HIGH_HOLD_MS
+// without one. Comment out to stay at 100 sps.
+#define PPG_POWER_MODES
+static constexpr uint8_t  PPG_PROX_LED      = 0x10;  // 3.2 mA
+static constexpr uint32_t PPG_PROX_AFTER_MS = 3000;
+static constexpr uint32_t PPG_PROX_POLL_MS  = 250;
+static constexpr uint32_t PPG_HIGH_HOLD_MS  = 10000;
 
 // --------- ECG (AD8232) ----------
 #define ENABLE_AD8232
@@ -42,10 +140,27 @@ static constexpr uint32_t PI_HOLD_MS = 1500;      // hold last PI when DC dips
 #define ECG_LOP_PIN       -1     // e.g., 7
 #define ECG_LON_PIN       -1     // e.g., 8
 
+// Acquisition: sample from a hardware-timer callback at an exact rate,
+// independent of loop(). Comment out to poll from loop() instead.
+#define ECG_ACQ_TIMER
+
 // Sample rate and buffer
-#define ECG_SAMPLE_HZ     250    // Hz
-#define ECG_RING_SAMPLES  1000   // ~4s at 250 Hz
+#define ECG_SAMPLE_HZ     500    // Hz (diagnostic captures: up to 1000)
+#define ECG_RING_SAMPLES  2048   // ~4s at 500 Hz (power of two)
+
+// Filtering: 0.5-40 Hz band-pass plus a mains notch (50 or 60 Hz).
+// Coefficients are computed at compile time for ECG_SAMPLE_HZ.
+#define ECG_MAINS_HZ      50
+
+// Flash log (log_flash.h): ECG + 1 Hz vitals on the LittleFS ("spiffs")
+// partition, oldest segments deleted first. Read back with /api/log.
+#define ENABLE_FLASH_LOG
+#define LOG_ECG_HZ         250    // logged ECG rate; ECG_SAMPLE_HZ must be a multiple
+#define LOG_SEG_BLOCKS     16     // 4 KB blocks per segment file (64 KB)
+#define LOG_RESERVE_BYTES  32768  // free space left to LittleFS
+#define LOG_POLL_MS        250    // ECG ring -> log block (ring holds ~4 s)
 
-// High-pass filter for baseline drift (0..1, higher = slower cutoff)
-#define ECG_HP_ALPHA      0.995f
+// Live ECG push (/api/ecg/stream, Server-Sent Events)
+#define ECG_SSE_MAX_CLIENTS  2
+#define ECG_SSE_PERIOD_MS    40     // batch new samples every 40 ms
 
@@ -1,29 +1,117 @@
 #include "display_oled.h"
+#include "util_stats.h"
 
-void DisplayOLED::begin(TwoWire& bus) {
-  (void)bus;
-  u8g2.setBusClock(100000);
+I2CBus* U8G2_SSD1306_128X64_BUS::bus = nullptr;
+
+// u8x8 byte callback: collect one transfer, send it as a single bus write
+static uint8_t oledByteCb(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr) {
+  static uint8_t buf[64];
+  static size_t  len = 0;
+  I2CBus* bus = U8G2_SSD1306_128X64_BUS::bus;
+  uint8_t addr = u8x8_GetI2CAddress(u8x8) >> 1;   // u8x8 keeps the 8-bit form
+
+  switch (msg) {
+    case U8X8_MSG_BYTE_INIT:
+    case U8X8_MSG_BYTE_SET_DC:
+      break;
+    case U8X8_MSG_BYTE_START_TRANSFER:
+      len = 0;
+      break;
+    case U8X8_MSG_BYTE_SEND: {
+      const uint8_t* p = (const uint8_t*)argPtr;
+      while (argInt--) {
+        if (len == sizeof(buf)) {        // longer than any u8g2 chunk; send as is
+          if (bus) bus->write(I2CBus::DEV_OLED, addr, buf, len);
+          len = 0;
+        }
+        buf[len++] = *p++;
+      }
+      break;
+    }
+    case U8X8_MSG_BYTE_END_TRANSFER:
+      if (bus && len) bus->write(I2CBus::DEV_OLED, addr, buf, len);
+      len = 0;
+      break;
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+U8G2_SSD1306_128X64_BUS::U8G2_SSD1306_128X64_BUS() : U8G2() {
+  u8g2_Setup_ssd1306_i2c_128x64_noname_f(&u8g2, U8G2_R0, oledByteCb, u8x8_gpio_and_delay_arduino);
+}
+
+// Page button (active low). Presses are counted in the ISR and applied by
+// page() from the UI task.
+static volatile uint8_t  s_presses = 0;
+static volatile uint32_t s_lastPressMs = 0;
+
+static void IRAM_ATTR onButton() {
+  uint32_t now = millis();
+  if (now - s_lastPressMs < 200) return;       // debounce
+  s_lastPressMs = now;
+  s_presses++;
+}
+
+void DisplayOLED::begin(I2CBus& bus) {
+  U8G2_SSD1306_128X64_BUS::bus = &bus;   // clock is set by the bus
   u8g2.begin();
   u8g2.setContrast(255);
+#if OLED_BUTTON_PIN >= 0
+  pinMode(OLED_BUTTON_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(OLED_BUTTON_PIN), onButton, FALLING);
+#endif
+}
+
+DisplayOLED::Page DisplayOLED::page() {
+  uint8_t n = s_presses;
+  if (n) {
+    s_presses -= n;
+    setPage((Page)((_page + n) % PAGE_COUNT));
+  }
+  return _page;
+}
+
+void DisplayOLED::setPage(Page p) {
+  if (p >= PAGE_COUNT) p = PAGE_VITALS;
+  _page = p;
+  _full = true;
+}
+
+uint32_t DisplayOLED::framePeriodMs() const {
+  switch (_page) {
+    case PAGE_WAVE:   return OLED_WAVE_FRAME_MS;
+    case PAGE_TRENDS: return OLED_IDLE_MS;
+    default:          return _animating ? OLED_FAST_MS : OLED_IDLE_MS;
+  }
+}
+
+// New page (or first frame): blank the buffer and resend the whole window.
+void DisplayOLED::_startPage() {
+  u8g2.clearBuffer();
+  _line1[0] = _line2[0] = 0;
+  _barShown = -1;
+  _animating = false;
+  _waveSrc = -1;
+  _waveLabel[0] = 0;
+  _trendGen = 0xFFFFFFFF;
 }
 
+// Single frame: setup() carries on while it is shown.
 void DisplayOLED::splash() {
   u8g2.clearBuffer();
   u8g2.setFont(u8g2_font_5x8_tf);
   u8g2.drawStr(OLED_XOFF, OLED_YOFF + 8,  "ESP32-C3 Boot...");
-  for (int i=0; i<=OLED_W; i+=5){
-    u8g2.drawFrame(OLED_XOFF, OLED_YOFF+16, OLED_W, 10);
-    u8g2.drawBox  (OLED_XOFF, OLED_YOFF+16, i,      10);
-    u8g2.drawStr  (OLED_XOFF, OLED_YOFF + 30, "Booting");
-    u8g2.drawStr  (OLED_XOFF, OLED_YOFF + 38, "device");
-    u8g2.sendBuffer();
-    delay(120);
-  }
-  delay(300);
-  u8g2.clearBuffer(); u8g2.sendBuffer();
+  u8g2.drawFrame(OLED_XOFF, OLED_YOFF+16, OLED_W, 10);
+  u8g2.drawStr  (OLED_XOFF, OLED_YOFF + 30, "Booting");
+  u8g2.drawStr  (OLED_XOFF, OLED_YOFF + 38, "device");
+  u8g2.sendBuffer();
+  _full = true;
 }
 
-// NEW: show quick sensor presence status for ~1.2s
+// Sensor presence, left up for OLED_SUMMARY_MS (see holding()) while the
+// sensors already run.
 void DisplayOLED::detectSummary(bool has30102, bool has30205) {
   u8g2.clearBuffer();
   u8g2.setFont(u8g2_font_6x12_tf);
@@ -37,20 +125,30 @@ void DisplayOLED::detectSummary(bool has30102, bool has30205) {
   u8g2.drawStr(OLED_XOFF, OLED_YOFF + 26, line);
 
   u8g2.sendBuffer();
-  delay(1200);  // brief pause so user can read it
+  _holdUntilMs = millis() + OLED_SUMMARY_MS;
+  _full = true;
 }
 
-void DisplayOLED::render(bool beatRecently, int bpm, int spo2, bool hasTemp, float tempC,
-                         bool hasFinger, float perfIndex) {
-  u8g2.clearBuffer();
+bool DisplayOLED::holding() {
+  if (_holdUntilMs && (int32_t)(millis() - _holdUntilMs) >= 0) _holdUntilMs = 0;
+  return _holdUntilMs != 0;
+}
+
+void DisplayOLED::render(int bpm, int spo2, bool hasTemp, float tempC, bool hasFinger,
+                         float perfIndex) {
+  STAT_SCOPE(STAT_OLED);
   u8g2.setFont(u8g2_font_6x12_tf);
+  if (_full) _startPage();
 
   char line[28];
 
-  // Line 1: Pulse (hide numbers if no recent beat)
-  if (!beatRecently) snprintf(line, sizeof(line), "Pulse: -- bpm");
+  // Line 1: Pulse (hide numbers without a valid rate)
+  if (bpm < 0)       snprintf(line, sizeof(line), "Pulse: -- bpm");
   else               snprintf(line, sizeof(line), "Pulse: %3d bpm", bpm);
-  u8g2.drawStr(OLED_XOFF, OLED_YOFF + 12, line);
+  if (strcmp(line, _line1) != 0) {
+    strlcpy(_line1, line, sizeof(_line1));
+    _drawText(OLED_YOFF + 12, _line1);
+  }
 
   // Line 2: O2 + Temp (compact)
   if (spo2 < 0 && !hasTemp) {
@@ -62,17 +160,282 @@ void DisplayOLED::render(bool beatRecently, int bpm, int spo2, bool hasTemp, flo
   } else {
     snprintf(line, sizeof(line), "O2:%2d T:%2.1f", spo2, tempC);
   }
-  u8g2.drawStr(OLED_XOFF, OLED_YOFF + 24, line);
+  if (strcmp(line, _line2) != 0) {
+    strlcpy(_line2, line, sizeof(_line2));
+    _drawText(OLED_YOFF + 24, _line2);
+  }
 
   // Line 3: Signal bar only (full = good). Map 0..10% PI to empty..full
-  u8g2.drawFrame(OLED_XOFF, OLED_YOFF + 40, OLED_W, 5);
+  int target = 0;
   if (hasFinger && perfIndex > 0.0f) {
     float norm = perfIndex / PI_BAR_FULL;
     if (norm < 0.0f) norm = 0.0f;
     if (norm > 1.0f) norm = 1.0f;
-    int barW = (int)(OLED_W * norm);
-    u8g2.drawBox(OLED_XOFF, OLED_YOFF + 40, barW, 5);
+    target = (int)(OLED_W * norm);
+  }
+  // glide towards the target; keep the fast frame rate until it arrives
+  int w = target;
+  if (_barShown >= 0) {
+    int d = target - _barShown;
+    int step = abs(d) / 4 + 1;
+    w = (abs(d) <= step) ? target : _barShown + (d > 0 ? step : -step);
   }
+  if (w != _barShown) _drawBar(w);
+  _animating = (w != target);
 
-  u8g2.sendBuffer();
+  _flush();
+  _full = false;
+}
+
+void DisplayOLED::_drawText(int baseline, const char* s) {
+  int y0 = baseline - u8g2.getAscent();
+  int y1 = baseline - u8g2.getDescent();     // descent is negative
+  u8g2.setDrawColor(0);
+  u8g2.drawBox(OLED_XOFF, y0, OLED_W, y1 - y0 + 1);
+  u8g2.setDrawColor(1);
+  u8g2.drawStr(OLED_XOFF, baseline, s);
+  _markRect(OLED_XOFF, y0, OLED_XOFF + OLED_W - 1, y1);
+}
+
+void DisplayOLED::_drawBar(int w) {
+  const int y = OLED_YOFF + 40, h = 5;
+  u8g2.setDrawColor(0);
+  u8g2.drawBox(OLED_XOFF, y, OLED_W, h);
+  u8g2.setDrawColor(1);
+  u8g2.drawFrame(OLED_XOFF, y, OLED_W, h);
+  if (w > 0) u8g2.drawBox(OLED_XOFF, y, w, h);
+  _barShown = w;
+  _markRect(OLED_XOFF, y, OLED_XOFF + OLED_W - 1, y + h - 1);
+}
+
+void DisplayOLED::_markRect(int x0, int y0, int x1, int y1) {
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 > 127) x1 = 127;
+  if (y1 > 63) y1 = 63;
+  if (x0 > x1 || y0 > y1) return;
+  uint16_t cols = (uint16_t)(((1u << (x1 / 8 + 1)) - 1) & ~((1u << (x0 / 8)) - 1));
+  for (int r = y0 / 8; r <= y1 / 8; r++) _dirty[r] |= cols;
+}
+
+// Send runs of dirty tiles row by row; a full frame is the window only.
+void DisplayOLED::_flush() {
+  if (_full) _markRect(OLED_XOFF, OLED_YOFF, OLED_XOFF + OLED_W - 1, OLED_YOFF + OLED_H - 1);
+  for (int r = 0; r < 8; r++) {
+    uint16_t cols = _dirty[r];
+    int c = 0;
+    while (cols && c < 16) {
+      if (!(cols & (1u << c))) { c++; continue; }
+      int c0 = c;
+      while (c < 16 && (cols & (1u << c))) c++;
+      u8g2.updateDisplayArea(c0, r, c - c0, 1);
+      _bytesWin += (uint32_t)(c - c0) * 8;
+      cols &= (uint16_t)~(((1u << c) - 1) & ~((1u << c0) - 1));
+    }
+    _dirty[r] = 0;
+  }
+
+  uint32_t now = millis();
+  if (now - _winStartMs >= 1000) {
+    _bytesLast  = _bytesWin;
+    _bytesWin   = 0;
+    _winStartMs = now;
+  }
+}
+
+// ---------------- wave page ----------------
+
+void DisplayOLED::renderWave(AD8232Sensor* ecg, Max30102Sensor* ppg) {
+  STAT_SCOPE(STAT_OLED);
+  if (_full) _startPage();
+
+  int8_t src = -1;
+  if (ecg && ecg->present() && !ecg->leadsOff()) src = 0;
+  else if (ppg && ppg->present())               src = 1;
+
+  if (src != _waveSrc) {
+    // new source: blank the trace and start a sweep at the current sample
+    _waveSrc = src;
+    u8g2.setDrawColor(0);
+    u8g2.drawBox(OLED_XOFF, WAVE_TOP, OLED_W, WAVE_H);
+    u8g2.setDrawColor(1);
+    _markRect(OLED_XOFF, WAVE_TOP, OLED_XOFF + OLED_W - 1, WAVE_TOP + WAVE_H - 1);
+    uint32_t fs = (src == 0) ? (uint32_t)ecg->sampleRate() : (uint32_t)Max30102Sensor::SAMPLE_HZ;
+    _decim = (int)(fs * OLED_WAVE_MS / 1000 / OLED_W);
+    if (_decim < 1) _decim = 1;
+    _waveNext = (src == 0) ? ecg->sampleIndex() : (src == 1 ? ppg->rawIndex() : 0);
+    _waveX = 0; _colN = 0; _prevY = -1;
+    _scaleLo = 0; _scaleHi = 0;            // set by the first column
+  }
+
+  // label: source and its heart rate
+  char label[16];
+  if (src == 0)      snprintf(label, sizeof(label), "ECG %3d", ecg->ecgBpm());
+  else if (src == 1) snprintf(label, sizeof(label), "PPG %3d", ppg->bpmRounded() > 0 ? ppg->bpmRounded() : 0);
+  else               snprintf(label, sizeof(label), "no signal");
+  if (strcmp(label, _waveLabel) != 0) {
+    strlcpy(_waveLabel, label, sizeof(_waveLabel));
+    u8g2.setFont(u8g2_font_5x8_tf);
+    u8g2.setDrawColor(0);
+    u8g2.drawBox(OLED_XOFF, OLED_YOFF, OLED_W, 9);
+    u8g2.setDrawColor(1);
+    u8g2.drawStr(OLED_XOFF, OLED_YOFF + 7, _waveLabel);
+    _markRect(OLED_XOFF, OLED_YOFF, OLED_XOFF + OLED_W - 1, OLED_YOFF + 8);
+  }
+
+  if (src >= 0) {
+    // bounded work per frame: at most WAVE_MAX_COLS columns of samples
+    size_t want = (size_t)(WAVE_MAX_COLS * _decim - _colN);
+    uint64_t head = (src == 0) ? ecg->sampleIndex() : ppg->rawIndex();
+    if (head > _waveNext + 2 * want) { _waveNext = head - want; _colN = 0; }   // fell behind: skip
+
+    static const size_t MAXN = 128;
+    if (want > MAXN) want = MAXN;
+    int32_t v[MAXN];
+    size_t n = 0;
+    uint64_t first;
+    if (src == 0) {
+      int16_t raw[MAXN];
+      n = ecg->readSince(_waveNext, raw, want, first);
+      for (size_t i = 0; i < n; i++) v[i] = raw[i];
+    } else {
+      Max30102Sensor::RawSample raw[MAXN];
+      n = ppg->readRaw(_waveNext, raw, want, first);
+      for (size_t i = 0; i < n; i++) v[i] = -raw[i].ir;   // pleth: more blood = less IR
+    }
+    if (n) _waveNext = first + n;
+
+    for (size_t i = 0; i < n; i++) {
+      if (_colN == 0) { _colLo = _colHi = v[i]; }
+      else { if (v[i] < _colLo) _colLo = v[i]; if (v[i] > _colHi) _colHi = v[i]; }
+      if (++_colN == _decim) { _waveColumn(_colLo, _colHi, v[i]); _colN = 0; }
+    }
+  }
+
+  _flush();
+  _full = false;
+}
+
+int DisplayOLED::_waveY(int32_t v) const {
+  int32_t span = _scaleHi - _scaleLo;
+  if (span <= 0) span = 1;
+  int y = WAVE_TOP + (int)((int64_t)(_scaleHi - v) * (WAVE_H - 1) / span);
+  if (y < WAVE_TOP) y = WAVE_TOP;
+  if (y > WAVE_TOP + WAVE_H - 1) y = WAVE_TOP + WAVE_H - 1;
+  return y;
+}
+
+void DisplayOLED::_waveColumn(int32_t lo, int32_t hi, int32_t last) {
+  const int32_t minSpan = (_waveSrc == 0) ? 80 : 40;   // don't blow noise up to full height
+
+  // autoscale: grow at once, shrink to the last sweep's range on wrap
+  if (_scaleHi <= _scaleLo) { _scaleLo = lo - minSpan / 2; _scaleHi = hi + minSpan / 2; _seenLo = lo; _seenHi = hi; }
+  if (lo < _scaleLo) _scaleLo = lo;
+  if (hi > _scaleHi) _scaleHi = hi;
+  if (lo < _seenLo) _seenLo = lo;
+  if (hi > _seenHi) _seenHi = hi;
+
+  int x = OLED_XOFF + _waveX;
+  int yHi = _waveY(hi), yLo = _waveY(lo);
+  if (_prevY >= 0) {                    // join to the previous column
+    if (_prevY < yHi) yHi = _prevY;
+    if (_prevY > yLo) yLo = _prevY;
+  }
+
+  u8g2.setDrawColor(0);
+  for (int g = 0; g < 4; g++) {         // this column + a 3-px gap ahead
+    int gx = OLED_XOFF + (_waveX + g) % OLED_W;
+    u8g2.drawVLine(gx, WAVE_TOP, WAVE_H);
+    _markRect(gx, WAVE_TOP, gx, WAVE_TOP + WAVE_H - 1);
+  }
+  u8g2.setDrawColor(1);
+  u8g2.drawVLine(x, yHi, yLo - yHi + 1);
+  _prevY = _waveY(last);
+
+  if (++_waveX == OLED_W) {
+    _waveX = 0;
+    _prevY = -1;
+    int32_t span = _seenHi - _seenLo;
+    int32_t pad  = (span < minSpan ? minSpan - span : 0) / 2 + span / 10;
+    _scaleLo = _seenLo - pad;
+    _scaleHi = _seenHi + pad;
+    _seenLo = INT32_MAX; _seenHi = INT32_MIN;
+  }
+}
+
+// ---------------- trends page ----------------
+
+void DisplayOLED::renderTrends(const VitalTrends& t) {
+  STAT_SCOPE(STAT_OLED);
+  if (_full) _startPage();
+  u8g2.setFont(u8g2_font_5x8_tf);
+
+  const int rowH = 13;
+  const int16_t cur[3] = { t.lastBpm, t.lastSpo2, t.lastTemp10 };
+  const MinMaxTrend<TREND_COLS>* tr[3] = { &t.bpm, &t.spo2, &t.temp10 };
+
+  uint32_t gen = t.bpm.generation() + t.spo2.generation() + t.temp10.generation();
+  bool redrawLines = (gen != _trendGen);
+  _trendGen = gen;
+
+  for (int i = 0; i < 3; i++) {
+    int y = OLED_YOFF + i * rowH;
+    if (redrawLines) {
+      _sparkline(y, rowH - 2, *tr[i], i == 2 ? 5 : 4);   // min span: 4 bpm, 4 %, 0.5 C
+    }
+    if (redrawLines || cur[i] != _trendVals[i]) {
+      _trendVals[i] = cur[i];
+      char txt[8];
+      if (cur[i] < 0)   snprintf(txt, sizeof(txt), "--");
+      else if (i == 2)  snprintf(txt, sizeof(txt), "%d.%d", cur[i] / 10, cur[i] % 10);
+      else if (i == 1)  snprintf(txt, sizeof(txt), "%d%%", cur[i]);
+      else              snprintf(txt, sizeof(txt), "%d", cur[i]);
+      int tx = OLED_XOFF + TREND_COLS + 2;
+      u8g2.setDrawColor(0);
+      u8g2.drawBox(tx, y, OLED_XOFF + OLED_W - tx, rowH - 1);
+      u8g2.setDrawColor(1);
+      u8g2.drawStr(tx, y + 9, txt);
+      _markRect(tx, y, OLED_XOFF + OLED_W - 1, y + rowH - 2);
+    }
+  }
+
+  _flush();
+  _full = false;
+}
+
+// One bucket per column, drawn as its min..max; scaled to the visible range.
+void DisplayOLED::_sparkline(int y, int h, const MinMaxTrend<TREND_COLS>& tr, int16_t minSpan) {
+  int x0 = OLED_XOFF;
+  u8g2.setDrawColor(0);
+  u8g2.drawBox(x0, y, TREND_COLS, h);
+  u8g2.setDrawColor(1);
+  _markRect(x0, y, x0 + TREND_COLS - 1, y + h - 1);
+
+  int n = tr.count();
+  int16_t lo = INT16_MAX, hi = INT16_MIN;
+  for (int i = 0; i < n; i++) {
+    const MinMaxTrend<TREND_COLS>::Bucket& b = tr.at(i);
+    if (!b.valid) continue;
+    if (b.lo < lo) lo = b.lo;
+    if (b.hi > hi) hi = b.hi;
+  }
+  if (lo > hi) {                         // nothing yet: baseline only
+    u8g2.drawHLine(x0, y + h - 1, TREND_COLS);
+    return;
+  }
+  if (hi - lo < minSpan) { int16_t m = (int16_t)((lo + hi) / 2); lo = m - minSpan / 2; hi = lo + minSpan; }
+
+  int xs = x0 + TREND_COLS - n;          // right-aligned: newest at the right edge
+  for (int i = 0; i < n; i++) {
+    const MinMaxTrend<TREND_COLS>::Bucket& b = tr.at(i);
+    if (!b.valid) continue;
+    int yTop = y + (int)((int32_t)(hi - b.hi) * (h - 1) / (hi - lo));
+    int yBot = y + (int)((int32_t)(hi - b.lo) * (h - 1) / (hi - lo));
+    u8g2.drawVLine(xs + i, yTop, yBot - yTop + 1);
+  }
+}
+
+uint32_t DisplayOLED::bytesPerSec() const {
+  // a window that has not rolled over for a while means nothing was sent
+  return (millis() - _winStartMs > 2000) ? 0 : _bytesLast;
 }
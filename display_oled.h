@@ -1,18 +1,96 @@
 #pragma once
-#include <Wire.h>
 #include <U8g2lib.h>
 #include "config.h"
+#include "util_i2cbus.h"
+#include "dsp_trend.h"
+#include "sensor_ad8232.h"
+#include "sensor_max30102.h"
+
+// SSD1306 128x64 full-buffer U8g2 that talks through the shared I2CBus:
+// each u8g2 transfer (command list or <= 32 data bytes) becomes one locked
+// bus write, so sensor reads interleave with a frame going out.
+class U8G2_SSD1306_128X64_BUS : public U8G2 {
+public:
+  U8G2_SSD1306_128X64_BUS();
+  static I2CBus* bus;
+};
 
 class DisplayOLED {
 public:
-  void begin(TwoWire& bus);
+  enum Page : uint8_t { PAGE_VITALS, PAGE_WAVE, PAGE_TRENDS, PAGE_COUNT };
+
+  void begin(I2CBus& bus);
   void splash();
 
-  // NEW: brief sensor status screen after splash
+  // Sensor status screen after splash; returns at once, holding() is true
+  // while it should stay up.
   void detectSummary(bool has30102, bool has30205);
+  bool holding();
+
+  // Change-driven: only fields that differ from the last frame are redrawn,
+  // and only their tile rows of the visible window are sent.
+  void render(int bpm, int spo2, bool hasTemp, float tempC, bool hasFinger,
+              float perfIndex);
+
+  // Sweeping ECG trace (pleth from the MAX30102 IR channel while the
+  // leads are off or the ECG is disabled). Each frame consumes new samples,
+  // min/max-decimated to one column per OLED_WAVE_MS/OLED_W, and sends only
+  // the tile columns it touched. At most WAVE_MAX_COLS columns per frame, so
+  // CPU time and bus bytes per frame are bounded; a longer stall skips ahead.
+  void renderWave(AD8232Sensor* ecg, Max30102Sensor* ppg);
+
+  // 10-minute min/max sparklines of BPM, SpO2 and temperature, redrawn when
+  // a trend bucket closes or a current value changes.
+  void renderTrends(const VitalTrends& t);
+
+  // Page selection; OLED_BUTTON_PIN presses advance it.
+  Page page();                         // applies pending button presses
+  void setPage(Page p);
+
+  // Suggested delay to the next frame for the current page.
+  uint32_t framePeriodMs() const;
+  uint32_t bytesPerSec() const;        // display data pushed, last full second
 
-  void render(bool beatRecently, int bpm, int spo2, bool hasTemp, float tempC,
-              bool hasFinger, float perfIndex);
 private:
-  U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2 {U8G2_R0, U8X8_PIN_NONE, I2C_SCL, I2C_SDA};
+  U8G2_SSD1306_128X64_BUS u8g2;
+
+  // what is on the panel now
+  char    _line1[20] = "";
+  char    _line2[20] = "";
+  int     _barShown  = -1;             // drawn bar width (px), -1 = nothing drawn
+  bool    _full      = true;           // redraw + send everything next frame
+  uint32_t _holdUntilMs = 0;           // detectSummary() shown until (0 = none)
+  bool    _animating = false;
+  uint16_t _dirty[8] = {0};            // per tile row, bit per 8-px tile column
+  Page    _page      = PAGE_VITALS;
+
+  // wave page
+  static const int WAVE_MAX_COLS = 6;
+  static const int WAVE_TOP = OLED_YOFF + 9;    // trace area below the label
+  static const int WAVE_H   = OLED_H - 9;
+  int8_t   _waveSrc  = -1;             // 0 = ECG, 1 = pleth, -1 = none yet
+  uint64_t _waveNext = 0;              // next sample index to consume
+  int      _waveX    = 0;              // sweep column
+  int      _decim    = 1, _colN = 0;
+  int32_t  _colLo = 0, _colHi = 0, _colLast = 0;
+  int32_t  _scaleLo = 0, _scaleHi = 1; // mapping for this sweep
+  int32_t  _seenLo = 0, _seenHi = 0;   // range seen in this sweep
+  int      _prevY = -1;
+  char     _waveLabel[16] = "";
+
+  // trends page
+  uint32_t _trendGen = 0xFFFFFFFF;
+  int16_t  _trendVals[3] = {0, 0, 0};
+
+  // bytes/s accounting
+  uint32_t _bytesWin = 0, _bytesLast = 0, _winStartMs = 0;
+
+  void _drawText(int baseline, const char* s);
+  void _drawBar(int w);
+  void _markRect(int x0, int y0, int x1, int y1);
+  void _flush();
+  void _startPage();
+  void _waveColumn(int32_t lo, int32_t hi, int32_t last);
+  int  _waveY(int32_t v) const;
+  void _sparkline(int y, int h, const MinMaxTrend<TREND_COLS>& tr, int16_t minSpan);
 };
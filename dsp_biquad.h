@@ -0,0 +1,163 @@
+// dsp_biquad.h
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Fixed-point biquad cascade with compile-time coefficients.
+// Coefficients are RBJ cookbook designs evaluated by constexpr code and
+// stored as Q2.30 (a0 normalised to 1). Samples run through the chain in
+// Q4 (12-bit ADC << 4) with int64 accumulators and first-order error
+// feedback, which keeps very low corners (0.5 Hz at 500 Hz) free of DC
+// offset and limit cycles. The ESP32-C3 has no FPU, so this replaces
+// soft-float per sample with a few 32x32->64 multiplies. That is a
+// target-only gain: on a host with an FPU the same stages in float are
+// faster (bench "ecgFilter"); on the C3 see the ecgSample probe in
+// /api/stats.
+//
+//   typedef FilterChain<BiquadHighpass<500, 50, 71>,     // 0.50 Hz, Q 0.71
+//                       BiquadNotch<500, 5000, 800>> F;  // 50 Hz, Q 8
+//
+// Stage parameters: sample rate (Hz), corner in centi-Hz, Q x 100.
+
+struct BiquadCoeffs { int32_t b0, b1, b2, a1, a2; };
+
+namespace biquad_detail {
+  // C++11-compatible constexpr math (single-return recursion).
+  constexpr double PI = 3.14159265358979323846;
+  constexpr double sinSeries(double x2, double term, int k, double acc) {
+    return (term < 1e-18 && term > -1e-18) ? acc
+         : sinSeries(x2, -term * x2 / ((2*k + 2) * (2*k + 3)), k + 1, acc + term);
+  }
+  constexpr double sin(double x) { return sinSeries(x * x, x, 0, 0.0); }   // |x| <= pi
+  constexpr double cos(double x) { return sin(PI / 2 - x); }               // 0 <= x <= pi
+  constexpr int32_t q30(double v) { return (int32_t)(v * 1073741824.0 + (v < 0 ? -0.5 : 0.5)); }
+
+  constexpr double w0(double fs, double f0) { return 2 * PI * f0 / fs; }
+  constexpr double alpha(double w, double q) { return sin(w) / (2 * q); }
+
+  constexpr BiquadCoeffs norm(double b0, double b1, double b2, double a0, double a1, double a2) {
+    return BiquadCoeffs{ q30(b0 / a0), q30(b1 / a0), q30(b2 / a0), q30(a1 / a0), q30(a2 / a0) };
+  }
+  constexpr BiquadCoeffs lowpass(double c, double a) {
+    return norm((1 - c) / 2, 1 - c, (1 - c) / 2, 1 + a, -2 * c, 1 - a);
+  }
+  constexpr BiquadCoeffs highpass(double c, double a) {
+    return norm((1 + c) / 2, -(1 + c), (1 + c) / 2, 1 + a, -2 * c, 1 - a);
+  }
+  constexpr BiquadCoeffs notch(double c, double a) {
+    return norm(1, -2 * c, 1, 1 + a, -2 * c, 1 - a);
+  }
+}
+
+template <int FS, int F0_CHZ, int Q_X100>
+struct BiquadLowpass {
+  static_assert(F0_CHZ > 0 && F0_CHZ < FS * 50, "corner must be below Nyquist");
+  static constexpr BiquadCoeffs coeffs() {
+    return biquad_detail::lowpass(biquad_detail::cos(biquad_detail::w0(FS, F0_CHZ / 100.0)),
+                                  biquad_detail::alpha(biquad_detail::w0(FS, F0_CHZ / 100.0), Q_X100 / 100.0));
+  }
+  static constexpr bool passesDC() { return true; }
+};
+
+template <int FS, int F0_CHZ, int Q_X100>
+struct BiquadHighpass {
+  static_assert(F0_CHZ > 0 && F0_CHZ < FS * 50, "corner must be below Nyquist");
+  static constexpr BiquadCoeffs coeffs() {
+    return biquad_detail::highpass(biquad_detail::cos(biquad_detail::w0(FS, F0_CHZ / 100.0)),
+                                   biquad_detail::alpha(biquad_detail::w0(FS, F0_CHZ / 100.0), Q_X100 / 100.0));
+  }
+  static constexpr bool passesDC() { return false; }
+};
+
+template <int FS, int F0_CHZ, int Q_X100>
+struct BiquadNotch {
+  static_assert(F0_CHZ > 0 && F0_CHZ < FS * 50, "notch must be below Nyquist");
+  static constexpr BiquadCoeffs coeffs() {
+    return biquad_detail::notch(biquad_detail::cos(biquad_detail::w0(FS, F0_CHZ / 100.0)),
+                                biquad_detail::alpha(biquad_detail::w0(FS, F0_CHZ / 100.0), Q_X100 / 100.0));
+  }
+  static constexpr bool passesDC() { return true; }
+};
+
+// Direct form I state for one stage.
+struct BiquadState {
+  int32_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+  int32_t err = 0;                          // truncation remainder fed back
+
+  template <typename S>
+  inline int32_t run(int32_t x) {
+    constexpr BiquadCoeffs c = S::coeffs();
+    int64_t acc = (int64_t)c.b0 * x + (int64_t)c.b1 * x1 + (int64_t)c.b2 * x2
+                - (int64_t)c.a1 * y1 - (int64_t)c.a2 * y2 + err;
+    int32_t y = (int32_t)(acc >> 30);
+    err = (int32_t)(acc - ((int64_t)y << 30));
+    x2 = x1; x1 = x;
+    y2 = y1; y1 = y;
+    return y;
+  }
+  // settle at the steady state for a constant input x
+  template <typename S>
+  inline int32_t prime(int32_t x) {
+    int32_t y = S::passesDC() ? x : 0;
+    x1 = x2 = x; y1 = y2 = y; err = 0;
+    return y;
+  }
+};
+
+template <typename... Stages> class FilterChain;
+
+template <>
+class FilterChain<> {
+public:
+  static const int FRAC_BITS = 4;
+  inline int32_t step(int32_t x) { return x; }
+  inline void    stepBlock(int32_t*, size_t) {}
+  inline int32_t prime(int32_t x) { return x; }
+};
+
+template <typename S, typename... Rest>
+class FilterChain<S, Rest...> {
+public:
+  static const int FRAC_BITS = 4;
+  static const int BLOCK_MAX = 64;
+
+  // One 12-bit-range sample in, filtered sample out (clamped to int12).
+  int16_t process(int16_t x) { return _out(step((int32_t)x << FRAC_BITS)); }
+
+  // In-place block filtering, stage by stage over the block, for the DSP
+  // task's batches. Same output as process(); not faster per sample on
+  // the host (bench "ecgFilter").
+  void processBlock(int16_t* buf, size_t n) {
+    int32_t tmp[BLOCK_MAX];
+    while (n) {
+      size_t m = n < (size_t)BLOCK_MAX ? n : (size_t)BLOCK_MAX;
+      for (size_t i = 0; i < m; i++) tmp[i] = (int32_t)buf[i] << FRAC_BITS;
+      stepBlock(tmp, m);
+      for (size_t i = 0; i < m; i++) buf[i] = _out(tmp[i]);
+      buf += m; n -= m;
+    }
+  }
+
+  // Start from steady state for input x instead of zero (no start-up step).
+  void reset(int16_t x) { prime((int32_t)x << FRAC_BITS); }
+
+  inline int32_t step(int32_t x) { return _rest.step(_st.template run<S>(x)); }
+  inline void stepBlock(int32_t* v, size_t n) {
+    BiquadState st = _st;
+    for (size_t i = 0; i < n; i++) v[i] = st.template run<S>(v[i]);
+    _st = st;
+    _rest.stepBlock(v, n);
+  }
+  inline int32_t prime(int32_t x) { return _rest.prime(_st.template prime<S>(x)); }
+
+private:
+  BiquadState          _st;
+  FilterChain<Rest...> _rest;
+
+  static inline int16_t _out(int32_t y) {
+    y >>= FRAC_BITS;
+    if (y >  2047) y =  2047;
+    if (y < -2048) y = -2048;
+    return (int16_t)y;
+  }
+};
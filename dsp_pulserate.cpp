@@ -0,0 +1,101 @@
+// dsp_pulserate.cpp
+#include "dsp_pulserate.h"
+#include <math.h>
+
+void PulseRateEstimator::reset() {
+  _head = 0; _n = 0;
+  _bpm = 0; _conf = 0;
+}
+
+void PulseRateEstimator::push(int32_t x) {
+  _buf[_head] = x;
+  _head = (_head + 1 == WIN) ? 0 : _head + 1;
+  if (_n < WIN) _n++;
+}
+
+// Window in time order minus its least-squares line, scaled to +-Q.
+int PulseRateEstimator::_prepare() {
+  int n = _n;
+  int start = _head - n;
+  if (start < 0) start += WIN;
+
+  // x = a + b*(i - c) with c the window centre; sums kept exact relative
+  // to the first sample so 18-bit inputs do not lose float precision
+  int32_t base = _buf[start];
+  int64_t sy = 0, sty = 0;
+  for (int i = 0, k = start; i < n; i++) {
+    int32_t y = _buf[k] - base;
+    sy  += y;
+    sty += (int64_t)i * y;
+    if (++k == WIN) k = 0;
+  }
+  float c   = 0.5f * (n - 1);
+  float mean = (float)sy / n;
+  float stt = (float)n * ((float)n * n - 1.0f) / 12.0f;      // sum (i-c)^2
+  float b   = ((float)sty - c * (float)sy) / stt;
+
+  float peak = 0;
+  for (int i = 0, k = start; i < n; i++) {
+    float d = (float)(_buf[k] - base) - mean - b * (i - c);
+    if (fabsf(d) > peak) peak = fabsf(d);
+    if (++k == WIN) k = 0;
+  }
+  if (peak <= 0) return 0;
+  float s = Q / peak;
+  for (int i = 0, k = start; i < n; i++) {
+    float d = (float)(_buf[k] - base) - mean - b * (i - c);
+    _x[i] = (int16_t)lrintf(d * s);
+    if (++k == WIN) k = 0;
+  }
+  return n;
+}
+
+bool PulseRateEstimator::update() {
+  _bpm = 0; _conf = 0;
+  if (_n < MIN_N) return false;
+  int n = _prepare();
+  if (!n) return false;
+
+  // every lag keeps at least half the window overlapping
+  int lagHi = LAG_MAX + 1;
+  if (lagHi > n / 2) lagHi = n / 2;
+  int lagLo = LAG_MIN - 1;
+
+  // energy of the leading x[0..n-k) and trailing x[k..n) parts, per lag
+  int32_t e0 = 0, e1 = 0;
+  for (int i = 0; i < n; i++) e0 += (int32_t)_x[i] * _x[i];
+  e1 = e0;
+  for (int k = 0; k < lagLo; k++) {
+    e0 -= (int32_t)_x[n - 1 - k] * _x[n - 1 - k];
+    e1 -= (int32_t)_x[k] * _x[k];
+  }
+
+  for (int k = lagLo; k <= lagHi; k++) {
+    int32_t acc = 0;
+    const int16_t* a = _x;
+    const int16_t* b = _x + k;
+    for (int i = 0, m = n - k; i < m; i++) acc += (int32_t)a[i] * b[i];
+    float den = sqrtf((float)e0 * (float)e1);
+    _r[k] = den > 0 ? (int32_t)(32767.0f * (float)acc / den) : 0;
+    e0 -= (int32_t)_x[n - 1 - k] * _x[n - 1 - k];
+    e1 -= (int32_t)_x[k] * _x[k];
+  }
+
+  // shortest local maximum within 85% of the highest one
+  int32_t best = 0;
+  for (int k = lagLo + 1; k < lagHi; k++)
+    if (_r[k] > _r[k - 1] && _r[k] >= _r[k + 1] && _r[k] > best) best = _r[k];
+  if (best <= 0) return false;
+  int pick = 0;
+  for (int k = lagLo + 1; k < lagHi && !pick; k++)
+    if (_r[k] > _r[k - 1] && _r[k] >= _r[k + 1] && _r[k] * 20 >= best * 17) pick = k;
+
+  float ym = _r[pick - 1], y0 = _r[pick], yp = _r[pick + 1];
+  float den = ym - 2.0f * y0 + yp;
+  float delta = den < 0 ? 0.5f * (ym - yp) / den : 0.0f;
+  float lag = pick + delta;
+  _bpm  = 60.0f * FS / lag;
+  _conf = y0 / 32767.0f;
+  if (_conf > 1.0f) _conf = 1.0f;
+  return true;
+}
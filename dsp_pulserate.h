@@ -0,0 +1,43 @@
+// dsp_pulserate.h
+#pragma once
+#include <stdint.h>
+
+// Pulse rate from the PPG by normalized autocorrelation over the last 8 s.
+// push() stores one 50 Hz sample (O(1)); update(), run about once a
+// second, removes the linear trend, quantizes the window to 12 bits and
+// correlates it at every lag for 40-220 bpm in 32-bit integer arithmetic
+// (~25k multiply-adds, no floats in the inner loop, no allocation).
+// The lag picked is the shortest one whose correlation is close to the
+// best, which keeps a strong 2T/3T peak from halving the rate and leaves
+// the weaker T/2 peak of a dicrotic notch alone; parabolic interpolation
+// then refines it to a fraction of a sample. The normalized correlation at
+// that lag (0..1) is reported as the confidence.
+class PulseRateEstimator {
+public:
+  static const int FS      = 50;                   // input rate, Hz
+  static const int WIN     = 8 * FS;               // analysis window
+  static const int MIN_N   = 4 * FS;               // first estimate after 4 s
+  static const int LAG_MIN = FS * 60 / 220;        // 220 bpm
+  static const int LAG_MAX = FS * 60 / 40 + 1;     // 40 bpm
+
+  void  reset();
+  void  push(int32_t x);
+  // Estimate from the current window; false (and confidence 0) if there
+  // is not enough data or no periodic component.
+  bool  update();
+
+  float bpm() const        { return _bpm; }         // 0 if none
+  float confidence() const { return _conf; }        // 0..1
+
+private:
+  static const int Q = 2047;                       // 12-bit signed samples
+  static_assert((int64_t)WIN * Q * Q < INT32_MAX, "lag sums must fit int32");
+
+  int32_t _buf[WIN];
+  int     _head = 0, _n = 0;
+  int16_t _x[WIN];                                 // detrended, quantized
+  int32_t _r[LAG_MAX + 2];                         // correlation, Q15
+  float   _bpm = 0, _conf = 0;
+
+  int _prepare();                                  // fills _x, returns its length
+};
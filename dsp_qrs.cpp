@@ -0,0 +1,159 @@
+#include "dsp_qrs.h"
+#include <string.h>
+
+void QrsDetector::begin(uint16_t fs) {
+  if (fs > MAX_FS) fs = MAX_FS;
+  if (fs < 100)    fs = 100;
+  _fs = fs;
+  _lpLen  = fs * 3 / 100;        // MA low-pass, first zero ~33 Hz, -3 dB ~15 Hz
+  _hpLen  = fs * 9 / 100;        // subtracting this MA gives a ~5 Hz high-pass
+  _mwiLen = fs * 15 / 100;       // 150 ms integration window
+  _dStep  = fs / 200 ? fs / 200 : 1;   // derivative taps spaced as at 200 Hz
+  _refractory = fs / 5;          // 200 ms
+  _twave      = fs * 36 / 100;   // 360 ms
+  _learnEnd   = fs * 2;          // 2 s threshold training
+
+  memset(_lpBuf, 0, sizeof(_lpBuf));   _lpI = 0;  _lpSum = 0;
+  memset(_hpBuf, 0, sizeof(_hpBuf));   _hpI = 0;  _hpSum = 0;
+  memset(_bp, 0, sizeof(_bp));
+  memset(_mwiBuf, 0, sizeof(_mwiBuf)); _mwiI = 0; _mwiSum = 0;
+  _n = 0;
+  _candVal = 0; _candN = 0;
+  _learnMax = 0; _learnSum = 0;
+  _spki = _npki = _thr1 = 0;
+  _sbVal = 0; _sbN = 0;
+  _haveBeat = false; _lastBeatN = 0; _lastQrsN = 0; _lastQrsPeak = 0;
+  _rrI = 0; _rrN = 0; _rrMeanN = 0; _lastRrMs = 0; _bpm = 0; _lastBeatSeen = 0;
+  _beats.reset();
+}
+
+void QrsDetector::process(int16_t x, uint64_t index) {
+  uint32_t n = _n;
+  _indexBase = index - n;
+
+  // low-pass: running moving average
+  _lpSum += x - _lpBuf[_lpI];
+  _lpBuf[_lpI] = x;
+  if (++_lpI == _lpLen) _lpI = 0;
+  int32_t lp = _lpSum / _lpLen;
+
+  // high-pass: centre tap of the long MA minus its mean
+  _hpSum += lp - _hpBuf[_hpI];
+  _hpBuf[_hpI] = lp;
+  int c = _hpI - _hpLen / 2; if (c < 0) c += _hpLen;
+  int32_t bp = _hpBuf[c] - _hpSum / _hpLen;
+  if (++_hpI == _hpLen) _hpI = 0;
+  if (bp >  32767) bp =  32767;
+  if (bp < -32768) bp = -32768;
+  _bp[n & (HIST - 1)] = (int16_t)bp;
+
+  // 5-point derivative (2x[n] + x[n-1] - x[n-3] - 2x[n-4]) / 8, then square
+  const int k = _dStep;
+  int32_t d = (2 * bp + _bp[(n - k) & (HIST - 1)]
+               - _bp[(n - 3 * k) & (HIST - 1)] - 2 * _bp[(n - 4 * k) & (HIST - 1)]) / 8;
+  if (d >  32767) d =  32767;
+  if (d < -32767) d = -32767;
+  uint32_t sq = (uint32_t)(d * d);
+
+  // moving-window integration
+  _mwiSum += sq;
+  _mwiSum -= _mwiBuf[_mwiI];
+  _mwiBuf[_mwiI] = sq;
+  if (++_mwiI == _mwiLen) _mwiI = 0;
+  uint32_t mwi = (uint32_t)(_mwiSum / (uint32_t)_mwiLen);
+
+  // peak picking: a candidate is confirmed once the integrator falls to half
+  if (mwi > _candVal) { _candVal = mwi; _candN = n; }
+  else if (_candVal && mwi < _candVal / 2) {
+    _onPeak(_candVal, _candN);
+    _candVal = mwi; _candN = n;
+  }
+
+  if (n < _learnEnd) {
+    if (mwi > _learnMax) _learnMax = mwi;
+    _learnSum += mwi;
+  } else if (n == _learnEnd) {
+    _spki = _learnMax / 3;
+    _npki = (uint32_t)(_learnSum / _learnEnd) / 2;
+    _updateThreshold();
+  } else if (_rrMeanN && _sbVal > _thr1 / 2 && n - _lastQrsN > _rrMeanN * 166 / 100) {
+    // search-back: no beat for 166% of the mean RR -> take the best noise peak
+    _acceptQrs(_sbVal, _sbN, true);
+  }
+
+  _n = n + 1;
+}
+
+void QrsDetector::_onPeak(uint32_t val, uint32_t n) {
+  if (n < _learnEnd) return;
+  uint32_t since = _haveBeat ? n - _lastQrsN : 0xFFFFFFFFu;
+  if (val > _thr1 && since > _refractory) {
+    // a small peak soon after a beat is most likely the T wave
+    if (since < _twave && val < _lastQrsPeak / 2) {
+      _npki = val / 8 + _npki - _npki / 8;
+      _updateThreshold();
+      return;
+    }
+    _acceptQrs(val, n, false);
+  } else {
+    _npki = val / 8 + _npki - _npki / 8;
+    _updateThreshold();
+    if (val > _sbVal && since > _refractory) { _sbVal = val; _sbN = n; }
+  }
+}
+
+void QrsDetector::_acceptQrs(uint32_t val, uint32_t n, bool searchBack) {
+  _spki = searchBack ? val / 4 + _spki - _spki / 4
+                     : val / 8 + _spki - _spki / 8;
+  _updateThreshold();
+  _lastQrsPeak = val;
+  _sbVal = 0;
+
+  // R peak = largest |band-pass| in the integration window ending at the
+  // integrator peak, shifted back by the low-pass and high-pass delays.
+  // A search-back peak at a slow rate can be older than the band-pass
+  // history; then only the part still held is searched, or none at all
+  // (the integrator peak stands in for the R peak).
+  uint32_t span = (uint32_t)(_mwiLen + 4 * _dStep);
+  uint32_t age  = _n - n;
+  uint32_t best = n;
+  if (age < HIST - 1) {
+    if (age + span > HIST - 1) span = HIST - 1 - age;
+    int32_t bestAbs = -1;
+    for (uint32_t i = n - span; i != n + 1; i++) {
+      int32_t v = _bp[i & (HIST - 1)];
+      if (v < 0) v = -v;
+      if (v > bestAbs) { bestAbs = v; best = i; }
+    }
+  }
+  uint32_t delay = (uint32_t)((_lpLen - 1) / 2 + _hpLen / 2);
+  uint32_t r = best - delay;
+
+  uint16_t rrMs = 0;
+  if (_haveBeat) {
+    uint32_t rr = (uint32_t)((r - _lastBeatN) * 1000u / _fs);
+    if (rr >= 250 && rr <= 3000) {
+      rrMs = (uint16_t)rr;
+      _rr[_rrI] = rrMs;
+      _rrI = (_rrI + 1) % RR_AVG;
+      if (_rrN < RR_AVG) _rrN++;
+      uint32_t sum = 0;
+      for (int i = 0; i < _rrN; i++) sum += _rr[i];
+      _bpm = (uint16_t)((60000u * _rrN + sum / 2) / sum);
+      _rrMeanN = sum / _rrN * _fs / 1000;
+    } else if (rr > 3000) {
+      _rrN = 0; _rrI = 0; _rrMeanN = 0;   // long pause (e.g. leads off): restart
+    }
+  }
+  _lastRrMs = rrMs;
+  _haveBeat = true;
+  _lastBeatN = r;
+  _lastQrsN = n;
+  _lastBeatSeen = n;
+  _beats.push(QrsBeat{ _indexBase + r, rrMs });
+}
+
+int QrsDetector::bpm() const {
+  if (!_bpm || _n - _lastBeatSeen > 3u * _fs) return 0;   // none, or no beat for 3 s
+  return _bpm;
+}
@@ -0,0 +1,70 @@
+// dsp_qrs.h
+#pragma once
+#include <stdint.h>
+#include "util_seqring.h"
+
+struct QrsBeat {
+  uint64_t sample;   // ECG sample index of the R peak
+  uint16_t rrMs;     // R-R interval to the previous beat (0 = none)
+};
+
+// Online Pan-Tompkins style QRS detector, integer arithmetic only.
+// Band-pass (moving-average low-pass minus a long moving average) ->
+// 5-point derivative -> square -> 150 ms moving-window integration ->
+// adaptive signal/noise thresholds with T-wave rejection and search-back.
+// Work per sample is O(1) and done inside the sample period; a beat is
+// reported once its integrated peak is confirmed, with the R-peak index
+// back-dated by the filter delay.
+class QrsDetector {
+public:
+  static const int MAX_FS = 1000;
+
+  void begin(uint16_t fs);
+  void process(int16_t x, uint64_t index);   // index = sample index of x
+
+  // Outputs, safe to read from other tasks.
+  int      bpm() const;                      // mean of last 8 RR, 0 if stale/none
+  uint16_t lastRrMs() const { return _lastRrMs; }
+  const SeqRing<QrsBeat, 16>& beats() const { return _beats; }
+
+private:
+  static const int LP_MAX   = MAX_FS * 3 / 100;
+  static const int HP_MAX   = MAX_FS * 9 / 100;
+  static const int MWI_MAX  = MAX_FS * 15 / 100;
+  static const int HIST     = 512;           // band-passed history (power of two)
+  static const int RR_AVG   = 8;
+
+  uint16_t _fs = 500;
+  int      _lpLen = 15, _hpLen = 45, _mwiLen = 75, _dStep = 2;
+  uint32_t _refractory = 100, _twave = 180, _learnEnd = 1000;
+
+  // filter state
+  int16_t  _lpBuf[LP_MAX] = {0};   int _lpI = 0;  int32_t _lpSum = 0;
+  int32_t  _hpBuf[HP_MAX] = {0};   int _hpI = 0;  int32_t _hpSum = 0;
+  int16_t  _bp[HIST] = {0};
+  uint32_t _mwiBuf[MWI_MAX] = {0}; int _mwiI = 0; uint64_t _mwiSum = 0;
+  volatile uint32_t _n = 0;        // samples processed
+
+  // peak picking on the integrated signal
+  uint32_t _candVal = 0, _candN = 0;
+  uint32_t _learnMax = 0; uint64_t _learnSum = 0;
+  uint32_t _spki = 0, _npki = 0, _thr1 = 0;
+  uint32_t _sbVal = 0, _sbN = 0;   // best noise peak since last beat (search-back)
+
+  // beats
+  bool     _haveBeat = false;
+  uint32_t _lastBeatN = 0;         // R-peak position, in processed samples
+  uint32_t _lastQrsN = 0;          // integrator peak of the last beat
+  uint32_t _lastQrsPeak = 0;
+  uint16_t _rr[RR_AVG] = {0};  int _rrI = 0, _rrN = 0;
+  uint32_t _rrMeanN = 0;           // mean RR in samples, for search-back
+  volatile uint16_t _lastRrMs = 0;
+  volatile uint16_t _bpm = 0;
+  volatile uint32_t _lastBeatSeen = 0;   // _n at last beat, for staleness
+  uint64_t _indexBase = 0;
+  SeqRing<QrsBeat, 16> _beats;
+
+  void _onPeak(uint32_t val, uint32_t n);
+  void _acceptQrs(uint32_t val, uint32_t n, bool searchBack);
+  void _updateThreshold() { _thr1 = (_spki > _npki) ? _npki + (_spki - _npki) / 4 : _npki; }
+};
@@ -0,0 +1,71 @@
+// dsp_trend.h
+#pragma once
+#include <stdint.h>
+
+// Min/max trend over fixed time buckets, for sparklines.
+// sample() is called at a steady rate (e.g. 1 Hz) with the current value;
+// every bucketMs the open bucket is closed into a ring of N. Buckets that
+// saw no valid value are kept as gaps.
+template <int N>
+class MinMaxTrend {
+public:
+  struct Bucket { int16_t lo, hi; bool valid; };
+
+  void begin(uint32_t bucketMs, uint32_t nowMs) {
+    _bucketMs = bucketMs; _start = nowMs;
+    _count = 0; _head = 0; _gen = 0; _open = Bucket{0, 0, false};
+  }
+
+  void sample(bool valid, int16_t v, uint32_t nowMs) {
+    if (nowMs - _start >= _bucketMs) {
+      _buf[_head] = _open;
+      _head = (_head + 1) % N;
+      if (_count < N) _count++;
+      _gen++;
+      _open = Bucket{0, 0, false};
+      _start += _bucketMs;
+      if (nowMs - _start >= _bucketMs) _start = nowMs;   // long stall: resync
+    }
+    if (!valid) return;
+    if (!_open.valid) { _open = Bucket{v, v, true}; return; }
+    if (v < _open.lo) _open.lo = v;
+    if (v > _open.hi) _open.hi = v;
+  }
+
+  int      count() const { return _count; }
+  // i = 0 is the oldest closed bucket
+  const Bucket& at(int i) const { return _buf[(_head - _count + i + N) % N]; }
+  uint32_t generation() const { return _gen; }   // bumps when a bucket closes
+  static constexpr int capacity() { return N; }
+
+private:
+  Bucket   _buf[N];
+  Bucket   _open = {0, 0, false};
+  int      _head = 0, _count = 0;
+  uint32_t _bucketMs = 1000, _start = 0, _gen = 0;
+};
+
+// 10-minute sparklines of the vitals, one column per bucket.
+static const int      TREND_COLS      = 48;
+static const uint32_t TREND_BUCKET_MS = 600000UL / TREND_COLS;   // 12.5 s
+
+struct VitalTrends {
+  MinMaxTrend<TREND_COLS> bpm;
+  MinMaxTrend<TREND_COLS> spo2;
+  MinMaxTrend<TREND_COLS> temp10;    // deg C x 10
+  int16_t lastBpm = -1, lastSpo2 = -1, lastTemp10 = -1;   // -1 = none
+
+  void begin(uint32_t nowMs) {
+    bpm.begin(TREND_BUCKET_MS, nowMs);
+    spo2.begin(TREND_BUCKET_MS, nowMs);
+    temp10.begin(TREND_BUCKET_MS, nowMs);
+  }
+  void sample(int b, int o2, bool hasTemp, float tempC, uint32_t nowMs) {
+    lastBpm    = (int16_t)(b  > 0 ? b  : -1);
+    lastSpo2   = (int16_t)(o2 > 0 ? o2 : -1);
+    lastTemp10 = (int16_t)(hasTemp ? (int)(tempC * 10.0f + 0.5f) : -1);
+    bpm.sample(lastBpm >= 0, lastBpm, nowMs);
+    spo2.sample(lastSpo2 >= 0, lastSpo2, nowMs);
+    temp10.sample(lastTemp10 >= 0, lastTemp10, nowMs);
+  }
+};
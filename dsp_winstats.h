@@ -0,0 +1,74 @@
+// dsp_winstats.h
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+// Sliding window with O(1) running statistics.
+// Keeps exact integer sums (sum, sum of squares) that are updated on push(),
+// so mean / stddev / AC-RMS cost the same whatever the window size.
+// Samples may be up to 22 bits: the MAX30102's 18-bit ADC output is scaled
+// to the PPG_LED_INIT current, which is up to PPG_LED_INIT / PPG_LED_MIN
+// (10x) at the lowest LED setting. N*N*max^2 must stay below 2^63 for the
+// variance numerator n*sumSq - sum^2 to be exact in int64, hence N <= 512.
+// tests/test_winstats.cpp checks this against the old per-tick helpers.
+template <int N>
+class WindowStats {
+  static_assert(N > 1 && N <= 512, "window size out of range for exact int64 sums of 22-bit samples");
+public:
+  void push(int32_t x) {
+    if (_filled == N) {
+      int32_t old = _buf[_head];
+      _sum   -= old;
+      _sumSq -= (int64_t)old * old;
+    } else {
+      _filled++;
+    }
+    _buf[_head] = x;
+    _sum   += x;
+    _sumSq += (int64_t)x * x;
+    _head = (_head + 1 == N) ? 0 : _head + 1;
+  }
+
+  void clear() { _head = 0; _filled = 0; _sum = 0; _sumSq = 0; }
+
+  int     count()    const { return _filled; }
+  bool    full()     const { return _filled == N; }
+  static constexpr int capacity() { return N; }
+
+  // Sample `ago` steps back from the newest one (0 = newest).
+  int32_t at(int ago) const {
+    int i = _head - 1 - ago;
+    while (i < 0) i += N;
+    return _buf[i];
+  }
+
+  int64_t sum()   const { return _sum; }
+  int64_t sumSq() const { return _sumSq; }
+
+  float mean() const {
+    return _filled ? (float)_sum / (float)_filled : 0.0f;
+  }
+  // Sample standard deviation (n-1), same as the old stddev() helper.
+  float stddev() const {
+    if (_filled < 2) return 0.0f;
+    return sqrtf((float)m2() / ((float)_filled * (float)(_filled - 1)));
+  }
+  // RMS around the window mean (population), same as the old ac_rms() helper.
+  float acRms() const {
+    if (_filled < 1) return 0.0f;
+    return sqrtf((float)m2() / ((float)_filled * (float)_filled));
+  }
+
+private:
+  int32_t _buf[N] = {0};
+  int     _head   = 0;
+  int     _filled = 0;
+  int64_t _sum    = 0;
+  int64_t _sumSq  = 0;
+
+  // n*sum(x^2) - (sum x)^2 == n^2 * population variance, exact in integers
+  int64_t m2() const {
+    int64_t v = (int64_t)_filled * _sumSq - _sum * _sum;
+    return v > 0 ? v : 0;
+  }
+};
@@ -0,0 +1,71 @@
+// host/Arduino.h
+#pragma once
+// Host stand-in for the Arduino core: just what the sensor, DSP and format
+// code uses. Time is the virtual clock in hal_host.h, so delay() returns
+// immediately and replays run faster than real time.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "hal_host.h"
+
+#define IRAM_ATTR
+#define PROGMEM
+
+#define LOW          0
+#define HIGH         1
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+#define FALLING      0x02
+#define RISING       0x01
+
+inline unsigned long millis() { return (unsigned long)(hal::nowUs() / 1000); }
+inline unsigned long micros() { return (unsigned long)hal::nowUs(); }
+inline void delay(unsigned long ms)            { hal::advanceUs((uint64_t)ms * 1000); }
+inline void delayMicroseconds(unsigned int us) { hal::advanceUs(us); }
+
+int  analogRead(uint8_t pin);
+inline void analogReadResolution(int) {}
+void pinMode(uint8_t pin, uint8_t mode);
+int  digitalRead(uint8_t pin);
+inline int  digitalPinToInterrupt(int pin) { return pin; }
+void attachInterrupt(int irq, void (*fn)(), int mode);
+
+using std::min;
+using std::max;
+#define constrain(x, lo, hi) ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(const uint8_t* data, size_t n) = 0;
+  size_t print(const char* s)            { return write((const uint8_t*)s, strlen(s)); }
+  size_t println(const char* s = "")     { return print(s) + print("\n"); }
+  size_t print(float v, int decimals = 2);
+  size_t println(float v, int decimals = 2) { return print(v, decimals) + print("\n"); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// Serial goes to stderr so a replay's CSV on stdout stays clean
+class HostSerial : public Print {
+public:
+  void   begin(unsigned long) {}
+  size_t write(const uint8_t* data, size_t n) override { return fwrite(data, 1, n, stderr); }
+};
+extern HostSerial Serial;
+
+// Cycle counter = nanoseconds of real (not virtual) time, so the
+// util_stats.h probes measure host run time.
+class EspClass {
+public:
+  uint32_t getCycleCount();
+  uint32_t getFreeHeap()    { return 0; }
+  uint32_t getMinFreeHeap() { return 0; }
+  void     restart()        { exit(0); }
+};
+extern EspClass ESP;
+inline uint32_t getCpuFrequencyMhz() { return 1000; }
@@ -0,0 +1,28 @@
+// host/Wire.h
+#pragma once
+#include <Arduino.h>
+
+// Host TwoWire: transactions go to the fake devices attached with
+// hal::attachI2C() (see fake_devices.h); an address with no device NACKs.
+class TwoWire {
+public:
+  bool    begin(int sda = -1, int scl = -1, uint32_t hz = 0) { (void)sda; (void)scl; (void)hz; return true; }
+  void    setClock(uint32_t hz) { _hz = hz; }
+  void    beginTransmission(uint8_t addr);
+  size_t  write(uint8_t b);
+  size_t  write(const uint8_t* data, size_t n);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t  requestFrom(uint8_t addr, size_t n, bool sendStop = true);
+  int     available() { return (int)(_rxLen - _rxPos); }
+  int     read() { return _rxPos < _rxLen ? _rx[_rxPos++] : -1; }
+
+private:
+  static const size_t BUF = 256;
+  uint32_t _hz = 100000;
+  uint8_t  _addr = 0;
+  uint8_t  _tx[BUF];
+  size_t   _txLen = 0;
+  uint8_t  _rx[BUF];
+  size_t   _rxLen = 0, _rxPos = 0;
+};
+extern TwoWire Wire;
@@ -0,0 +1,44 @@
+// host/beat_score.h
+#pragma once
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+// Beat-by-beat comparison of detected R peaks with ground truth, as in
+// ANSI/AAMI EC57: a detection within tolUs of a true beat is a true
+// positive (each beat matched at most once). Only beats in [fromUs, toUs)
+// count, so the detector's learning period and the unfinished end of a
+// run stay out.
+struct BeatScore {
+  int tp = 0, fn = 0, fp = 0;
+  float sensitivity() const { return tp + fn ? (float)tp / (tp + fn) : NAN; }
+  float ppv() const         { return tp + fp ? (float)tp / (tp + fp) : NAN; }
+  void  add(const BeatScore& o) { tp += o.tp; fn += o.fn; fp += o.fp; }
+};
+
+inline BeatScore scoreBeats(const std::vector<uint64_t>& truthUs, const std::vector<uint64_t>& gotUs,
+                            uint64_t fromUs, uint64_t toUs, uint64_t tolUs = 150000) {
+  BeatScore s;
+  size_t i = 0, j = 0;
+  while (i < truthUs.size() || j < gotUs.size()) {
+    bool haveT = i < truthUs.size(), haveG = j < gotUs.size();
+    if (haveT && haveG) {
+      uint64_t t = truthUs[i], g = gotUs[j];
+      uint64_t d = t > g ? t - g : g - t;
+      if (d <= tolUs) {
+        if (t >= fromUs && t < toUs) s.tp++;
+        i++; j++;
+        continue;
+      }
+      if (t < g) { if (t >= fromUs && t < toUs) s.fn++; i++; }
+      else       { if (g >= fromUs && g < toUs) s.fp++; j++; }
+    } else if (haveT) {
+      if (truthUs[i] >= fromUs && truthUs[i] < toUs) s.fn++;
+      i++;
+    } else {
+      if (gotUs[j] >= fromUs && gotUs[j] < toUs) s.fp++;
+      j++;
+    }
+  }
+  return s;
+}
@@ -0,0 +1,26 @@
+// host/esp_timer.h
+#pragma once
+#include <stdint.h>
+
+// esp_timer on the virtual clock: periodic callbacks fire from
+// hal::advanceUs() at their exact due times, in order.
+typedef int esp_err_t;
+#define ESP_OK   0
+#define ESP_FAIL -1
+
+typedef void (*esp_timer_cb_t)(void* arg);
+struct esp_timer;
+typedef esp_timer* esp_timer_handle_t;
+
+struct esp_timer_create_args_t {
+  esp_timer_cb_t callback;
+  void*          arg;
+  int            dispatch_method;
+  const char*    name;
+  bool           skip_unhandled_events;
+};
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t periodUs);
+esp_err_t esp_timer_stop(esp_timer_handle_t t);
+int64_t   esp_timer_get_time();
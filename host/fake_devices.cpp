@@ -0,0 +1,369 @@
+// host/fake_devices.cpp
+#include "fake_devices.h"
+#include "config.h"
+#include <esp_timer.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const float TWO_PI_F = 6.2831853f;
+
+static inline float gaussBump(float x, float mu, float sd) {
+  float z = (x - mu) / sd;
+  return expf(-0.5f * z * z);
+}
+
+// ---------- NoiseGen ----------
+
+float NoiseGen::uniform() {
+  _s ^= _s << 13; _s ^= _s >> 17; _s ^= _s << 5;
+  return (float)(_s >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+float NoiseGen::gauss() {
+  // sum of four uniforms: sd = sqrt(4/3), rescaled to ~1
+  return (uniform() + uniform() + uniform() + uniform()) * 0.8660254f;
+}
+
+// ---------- SynthPpg ----------
+
+// Firmware calibration (sensor_max30102.cpp): spo2 = -45.060 R^2 + 30.354 R
+// + 94.845. Take the root on the falling side of the parabola, where real
+// readings live (R ~0.4..1).
+float SynthPpg::ratioFor(float spo2) {
+  const float a = 45.060f, b = 30.354f;
+  float disc = b * b + 4.0f * a * (94.845f - spo2);
+  if (disc < 0) disc = 0;
+  return (b + sqrtf(disc)) / (2.0f * a);
+}
+
+float SynthPpg::_shape(float ph) {
+  return gaussBump(ph, 0.15f, 0.06f) + 0.35f * gaussBump(ph, 0.45f, 0.08f);
+}
+
+SynthPpg::SynthPpg(const SynthPpgParams& p) : _p(p), _noise(p.seed), _bpm(p.bpm) {
+  // normalise one beat to zero mean, unit RMS
+  const int N = 1000;
+  double sum = 0, sum2 = 0;
+  for (int i = 0; i < N; i++) { double v = _shape((float)i / N); sum += v; sum2 += v * v; }
+  double mean = sum / N;
+  _shapeMean = (float)mean;
+  _shapeRms = (float)sqrt(sum2 / N - mean * mean);
+}
+
+void SynthPpg::sample(uint64_t n, int32_t& red, int32_t& ir) {
+  const float fs = 50.0f;
+  for (; _n <= n; _n++) {
+    float t = _n / fs;
+    _bpm = _p.bpm + _p.bpmWander * sinf(TWO_PI_F * 0.05f * t);
+    _phase += _bpm / 60.0f / fs;
+    if (_phase >= 1.0f) _phase -= 1.0f;
+  }
+  if (!_p.finger) {
+    red = 1500 + (int32_t)(50.0f * _noise.gauss());
+    ir  = 2000 + (int32_t)(50.0f * _noise.gauss());
+    return;
+  }
+  float w = (_shape(_phase) - _shapeMean) / _shapeRms;          // unit RMS
+  float mIr  = _p.pi / 100.0f;                                  // AC RMS / DC
+  float mRed = mIr * ratioFor(_p.spo2);
+  // motion couples into the two channels differently (path length and
+  // venous blood), which is what breaks ratio-of-ratios
+  float aIr = 0, aRed = 0;
+  float t = n / 50.0f;
+  if (_p.motion > 0 && fmodf(t, 20.0f) >= 10.0f && fmodf(t, 20.0f) < 16.0f) {
+    float s1 = sinf(TWO_PI_F * 1.3f * t), s2 = sinf(TWO_PI_F * 2.1f * t + 1.0f);
+    aIr  = _p.motion * (s1 + 0.6f * s2);
+    aRed = _p.motion * (0.4f * s1 - 0.8f * s2);
+  }
+  float fIr  = _p.dcIr  * (1.0f + mIr  * (w + aIr  + _p.noise * _noise.gauss()));
+  float fRed = _p.dcRed * (1.0f + mIr  * aRed + mRed * (w + _p.noise * _noise.gauss()));
+  red = (int32_t)fRed;
+  ir  = (int32_t)fIr;
+}
+
+// ---------- SynthEcg ----------
+
+SynthEcg::SynthEcg(const SynthEcgParams& p) : _p(p), _noise(p.seed), _bpm(p.bpm) {
+  // first R at 0.35 of the first interval, one virtual beat before it
+  float rr = 60.0f / _rateAt(0);
+  _cur  = Beat{ 0.35 * rr, rr, false };
+  _prev = Beat{ _cur.r - rr, rr, false };
+  _truth.push_back((uint64_t)(_cur.r * 1e6));
+  _next = _after(_cur);
+}
+
+float SynthEcg::_rateAt(double t) const {
+  return _p.bpm + _p.bpmWander * sinf(TWO_PI_F * 0.05f * (float)t);
+}
+
+bool SynthEcg::_inWindow(double t, float every, float len) const {
+  return every > 0 && len > 0 && fmod(t, every) >= every - len;
+}
+
+// The beat after b, recorded as ground truth if it will be visible.
+SynthEcg::Beat SynthEcg::_after(const Beat& b) {
+  float rr = 60.0f / _rateAt(b.r);
+  if (_p.rrJitter > 0) rr *= 1.0f + _p.rrJitter * _noise.uniform();
+  bool ectopic = false;
+  if (_compensate) {
+    rr *= 1.4f;
+    _compensate = false;
+  } else if (_p.ectopicEvery > 0 && ++_beatNo % _p.ectopicEvery == 0) {
+    rr *= 0.6f;
+    ectopic = _compensate = true;
+  }
+  if (_p.pauseEveryS > 0 && floor(b.r / _p.pauseEveryS) != floor((b.r + rr) / _p.pauseEveryS))
+    rr = _p.pauseS > rr ? _p.pauseS : rr;
+  Beat n{ b.r + rr, rr, ectopic };
+  if (_p.stopS > 0 && n.r >= _p.stopS) n.r = 1e30;       // no more beats
+  bool hidden = _inWindow(n.r, _p.offEveryS, _p.offS) || _inWindow(n.r, _p.dropEveryS, _p.dropS);
+  if (n.r < 1e29 && !hidden) _truth.push_back((uint64_t)(n.r * 1e6));
+  return n;
+}
+
+// One beat around its R peak; P-R and Q-T scale with the R-R interval up
+// to 1.5 s. Ectopic beats have no P wave, a wide QRS and an inverted T.
+float SynthEcg::_wave(const Beat& b, double t) const {
+  float x  = (float)(t - b.r);
+  if (x < -1.0f || x > 1.0f) return 0.0f;
+  float rs = b.rr < 1.5f ? b.rr : 1.5f;
+  if (b.ectopic)
+    return 1.30f * gaussBump(x, 0.0f, 0.025f)
+         - 0.35f * gaussBump(x, 0.25f * rs + 0.03f, 0.060f);
+  return 0.12f * gaussBump(x, -0.20f * rs, 0.025f)
+       - 0.10f * gaussBump(x, -0.020f, 0.008f)
+       + 1.00f * gaussBump(x, 0.0f, 0.010f)
+       - 0.20f * gaussBump(x, 0.022f, 0.010f)
+       + _p.tAmp * gaussBump(x, 0.25f * rs, 0.045f);
+}
+
+int SynthEcg::adc(uint64_t tUs) {
+  double t = tUs * 1e-6;
+  while (_next.r < 1e29 && t > (_cur.r + _next.r) / 2) {
+    _prev = _cur;
+    _cur  = _next;
+    _next = _after(_cur);
+  }
+  _bpm = (_p.stopS > 0 && t >= _p.stopS) ? NAN : _rateAt(t);
+
+  if (_inWindow(t, _p.offEveryS, _p.offS)) return 4095;
+  float v = _wave(_prev, t) + _wave(_cur, t) + (_next.r < 1e29 ? _wave(_next, t) : 0.0f);
+  if (_inWindow(t, _p.dropEveryS, _p.dropS)) v = 0;
+  float y = 2048.0f + _p.rAmp * v
+          + _p.wander * sinf(TWO_PI_F * 0.05f * (float)t)
+          + _p.mains * sinf(TWO_PI_F * ECG_MAINS_HZ * (float)t)
+          + _p.noise * _noise.gauss();
+  if (y < 0) y = 0;
+  if (y > 4095) y = 4095;
+  return (int)y;
+}
+
+// ---------- CSV traces ----------
+
+bool CsvTrace::load(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  _v.clear();
+  _cols = 0;
+  char line[1024];
+  float row[64];
+  while (fgets(line, sizeof(line), f)) {
+    size_t n = 0;
+    bool ok = true;
+    char* p = line;
+    while (*p && n < 64) {
+      while (*p == ' ' || *p == '\t' || *p == ',' || *p == ';') p++;
+      if (*p == '\n' || *p == '\r' || !*p) break;
+      char* end;
+      row[n] = strtof(p, &end);
+      if (end == p) { ok = false; break; }
+      n++;
+      p = end;
+    }
+    if (!ok || !n) continue;
+    if (!_cols) _cols = n;
+    if (n != _cols) continue;
+    _v.insert(_v.end(), row, row + n);
+  }
+  fclose(f);
+  return rows() > 0;
+}
+
+void CsvPpg::sample(uint64_t n, int32_t& red, int32_t& ir) {
+  size_t row = (size_t)((double)n * _hz / 50.0) % _t.rows();
+  red = (int32_t)_t.at(row, _red);
+  ir  = (int32_t)_t.at(row, _ir);
+}
+
+int CsvEcg::adc(uint64_t tUs) {
+  size_t row = (size_t)((double)tUs * _hz / 1e6) % _t.rows();
+  float y = _t.at(row, _col) * _scale + _offset;
+  if (y < 0) y = 0;
+  if (y > 4095) y = 4095;
+  return (int)y;
+}
+
+static EcgSource* g_ecg = nullptr;
+static uint8_t    g_ecgPin = 0;
+
+static int ecgAdc(void*, uint8_t pin, uint64_t tUs) {
+  return (g_ecg && pin == g_ecgPin) ? g_ecg->adc(tUs) : 0;
+}
+
+void attachEcg(EcgSource* src, uint8_t pin) {
+  g_ecg = src;
+  g_ecgPin = pin;
+  hal::setAdc(ecgAdc, nullptr);
+}
+
+// ---------- FakeMax30102 ----------
+
+static const uint8_t R_INT_STATUS = 0x00, R_INT_EN1 = 0x02, A_FULL = 0x80;
+static const uint8_t R_FIFO_WR = 0x04, R_OVF = 0x05, R_FIFO_RD = 0x06,
+                     R_FIFO_DATA = 0x07, R_FIFO_CFG = 0x08, R_MODE = 0x09,
+                     R_SPO2_CFG = 0x0A, R_LED1_PA = 0x0C, R_LED2_PA = 0x0D,
+                     R_PART_ID = 0xFF;
+
+int FakeMax30102::_average() const {
+  int ave = _reg[R_FIFO_CFG] >> 5;
+  return ave >= 5 ? 32 : 1 << ave;
+}
+
+uint64_t FakeMax30102::_periodUs() const {
+  static const uint32_t SPS[8] = { 50, 100, 200, 400, 800, 1000, 1600, 3200 };
+  return 1000000ULL * _average() / SPS[(_reg[R_SPO2_CFG] >> 2) & 7];
+}
+
+void FakeMax30102::_catchUp() {
+  uint64_t now = hal::nowUs();
+  while (_running && _nextUs <= now) {
+    int32_t red0, ir0;
+    _src->sample((_nextUs - _startUs) / SOURCE_US - 1, red0, ir0);
+    _n++;
+    float sd = _src->readNoise() / sqrtf((float)_average());
+    float red = red0 * (_reg[R_LED1_PA] / (float)PPG_LED_INIT) + sd * _noise.gauss();
+    float ir  = ir0  * (_reg[R_LED2_PA] / (float)PPG_LED_INIT) + sd * _noise.gauss();
+    uint32_t r = (uint32_t)(red < 0 ? 0 : red > 0x3FFFF ? 0x3FFFF : red);
+    uint32_t i = (uint32_t)(ir  < 0 ? 0 : ir  > 0x3FFFF ? 0x3FFFF : ir);
+    if (_fill == DEPTH) {                      // rollover: drop the oldest
+      _rd = (_rd + 1) & (DEPTH - 1);
+      _byte = 0;
+      _fill--;
+      _lost++;
+      if (_ovf < 0x1F) _ovf++;
+    }
+    uint8_t* s = _fifo[_wr];
+    s[0] = r >> 16; s[1] = r >> 8; s[2] = r;
+    s[3] = i >> 16; s[4] = i >> 8; s[5] = i;
+    _wr = (_wr + 1) & (DEPTH - 1);
+    _fill++;
+    if (_fill == DEPTH - (_reg[R_FIFO_CFG] & 0x0F)) _reg[R_INT_STATUS] |= A_FULL;
+    _nextUs += _periodUs();
+  }
+  _updateInt();
+}
+
+void FakeMax30102::_updateInt() {
+  if (_intPin >= 0) hal::setPin(_intPin, (_reg[R_INT_STATUS] & _reg[R_INT_EN1]) ? 0 : 1);
+}
+
+void FakeMax30102::_tick(void* self) { static_cast<FakeMax30102*>(self)->_catchUp(); }
+
+void FakeMax30102::setIntPin(uint8_t pin) {
+  _intPin = pin;
+  esp_timer_create_args_t args = {};
+  args.callback = _tick;
+  args.arg = this;
+  args.name = "max30102";
+  esp_timer_handle_t t;
+  if (esp_timer_create(&args, &t) == ESP_OK) esp_timer_start_periodic(t, 1000);
+  _updateInt();
+}
+
+void FakeMax30102::_writeReg(uint8_t r, uint8_t v) {
+  switch (r) {
+    case R_FIFO_WR: _wr  = v & (DEPTH - 1); _fill = (_wr - _rd) & (DEPTH - 1); _byte = 0; return;
+    case R_OVF:     _ovf = v & 0x1F; return;
+    case R_FIFO_RD: _rd  = v & (DEPTH - 1); _fill = (_wr - _rd) & (DEPTH - 1); _byte = 0; return;
+    case R_MODE:
+      if (v & 0x40) {                          // soft reset: registers and FIFO to POR
+        memset(_reg, 0, sizeof(_reg));
+        _wr = _rd = _ovf = 0; _fill = 0; _byte = 0;
+        _running = false;
+        v &= ~0x40;                            // completes immediately
+      }
+      _reg[R_MODE] = v;
+      if ((v & 0x07) == 0x03 && !_running) {   // SpO2 mode: start sampling
+        _running = true;
+        _startUs = hal::nowUs();
+        _nextUs = _startUs + _periodUs();
+      } else if ((v & 0x07) != 0x03) {
+        _running = false;
+      }
+      return;
+    default: _reg[r] = v; return;
+  }
+}
+
+bool FakeMax30102::write(const uint8_t* data, size_t n) {
+  _catchUp();
+  if (!n) return true;                         // address probe
+  _ptr = data[0];
+  for (size_t k = 1; k < n; k++) {
+    _writeReg(_ptr, data[k]);
+    if (_ptr != R_FIFO_DATA) _ptr++;
+  }
+  return true;
+}
+
+uint8_t FakeMax30102::_readByte() {
+  switch (_ptr) {
+    case R_INT_STATUS: {                       // read clears, releasing INT
+      uint8_t v = _reg[R_INT_STATUS];
+      _reg[R_INT_STATUS] = 0;
+      _updateInt();
+      return v;
+    }
+    case R_FIFO_WR: return _wr;
+    case R_OVF:     return _ovf;
+    case R_FIFO_RD: return _rd;
+    case R_PART_ID: return 0x15;
+    case R_FIFO_DATA: {
+      if (!_fill) return 0;
+      uint8_t b = _fifo[_rd][_byte];
+      if (++_byte == 6) {                      // sample popped
+        _byte = 0;
+        _rd = (_rd + 1) & (DEPTH - 1);
+        _fill--;
+        _ovf = 0;
+      }
+      return b;
+    }
+    default: return _reg[_ptr];
+  }
+}
+
+size_t FakeMax30102::read(uint8_t* out, size_t n) {
+  _catchUp();
+  for (size_t k = 0; k < n; k++) {
+    out[k] = _readByte();
+    if (_ptr != R_FIFO_DATA) _ptr++;
+  }
+  return n;
+}
+
+// ---------- FakeMax30205 ----------
+
+bool FakeMax30205::write(const uint8_t* data, size_t n) {
+  if (n) _ptr = data[0];
+  return true;
+}
+
+size_t FakeMax30205::read(uint8_t* out, size_t n) {
+  int16_t raw = (int16_t)lrintf(_tempC * 256.0f);
+  for (size_t k = 0; k < n; k++)
+    out[k] = _ptr == 0x00 ? (k == 0 ? (uint8_t)(raw >> 8) : (uint8_t)raw) : 0;
+  return n;
+}
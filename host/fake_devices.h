@@ -0,0 +1,224 @@
+// host/fake_devices.h
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "hal_host.h"
+
+// Stand-ins for the board's sensors on the host (hal_host.h), fed from
+// synthetic generators or recorded CSV traces. All generators are
+// deterministic: the same parameters give the same samples.
+
+// ---------- signal sources ----------
+
+// One red/IR pair per 50 Hz FIFO sample, n counting from 0, in ADC counts
+// at the firmware's PPG_LED_INIT current. readNoise() is added by the ADC
+// whatever the LED current (sd in counts, before on-chip averaging).
+class PpgSource {
+public:
+  virtual ~PpgSource() {}
+  virtual void sample(uint64_t n, int32_t& red, int32_t& ir) = 0;
+  virtual float readNoise() const { return 0.0f; }
+};
+
+// ECG front-end output in ADC counts (0..4095) at time tUs.
+class EcgSource {
+public:
+  virtual ~EcgSource() {}
+  virtual int adc(uint64_t tUs) = 0;
+};
+
+// Small deterministic noise source (xorshift32); gauss() is approximate.
+class NoiseGen {
+public:
+  explicit NoiseGen(uint32_t seed = 1) : _s(seed ? seed : 1) {}
+  float uniform();                    // [-1, 1)
+  float gauss();                      // mean 0, sd ~1
+private:
+  uint32_t _s;
+};
+
+// Pulse wave with a dicrotic notch. The red/IR modulation ratio is set so
+// that the ratio-of-ratios calibration in sensor_max30102.cpp reads `spo2`,
+// and the IR AC RMS is `pi` percent of the IR DC.
+struct SynthPpgParams {
+  float    bpm   = 72.0f;
+  float    spo2  = 97.0f;
+  float    pi    = 2.0f;              // %
+  float    dcIr  = 120000.0f;
+  float    dcRed = 90000.0f;
+  float    noise = 0.02f;             // sd, as a fraction of the AC amplitude
+  float    bpmWander = 0.0f;          // +- bpm, 0.05 Hz sinusoidal
+  float    motion = 0.0f;             // 6 s motion bursts every 20 s, x AC amplitude
+  float    adcNoise = 0.0f;           // sd, ADC counts, independent of LED current
+  bool     finger = true;             // false: ambient only
+  uint32_t seed  = 1;
+};
+class SynthPpg : public PpgSource {
+public:
+  explicit SynthPpg(const SynthPpgParams& p);
+  void sample(uint64_t n, int32_t& red, int32_t& ir) override;
+  float readNoise() const override { return _p.adcNoise; }
+  float bpm() const { return _bpm; }  // rate at the last sample (ground truth)
+  // R for a target SpO2 on the firmware's calibration curve
+  static float ratioFor(float spo2);
+private:
+  SynthPpgParams _p;
+  NoiseGen _noise;
+  float    _phase = 0.0f;
+  float    _bpm;
+  uint64_t _n = 0;
+  float    _shapeMean = 0.0f;
+  float    _shapeRms = 1.0f;
+  static float _shape(float phase);   // one beat, phase in [0, 1)
+};
+
+// Beats are scheduled one R-R interval at a time, so the rhythm can be
+// irregular, have ectopic beats, pauses or stop, and the signal can drop
+// out. beats() is the ground truth: R-peak times of the beats that are
+// visible in the output (not during leads-off or a dropout).
+struct SynthEcgParams {
+  float    bpm    = 72.0f;
+  float    rAmp   = 700.0f;           // R wave, ADC counts
+  float    tAmp   = 0.30f;            // T wave, x R
+  float    noise  = 8.0f;             // sd, ADC counts
+  float    mains  = 20.0f;            // amplitude at ECG_MAINS_HZ
+  float    wander = 60.0f;            // 0.05 Hz baseline wander
+  float    bpmWander = 0.0f;          // +- bpm, 0.05 Hz, in step with SynthPpg
+  // rhythm
+  float    rrJitter = 0.0f;           // each R-R +- this fraction, uniform (irregular)
+  int      ectopicEvery = 0;          // every Nth beat premature (0.6 R-R, wide), then a compensatory pause
+  float    pauseEveryS = 0.0f;        // a sinus pause of pauseS every pauseEveryS (0 = none)
+  float    pauseS = 0.0f;
+  float    stopS = 0.0f;              // no beats from then on (flat line), 0 = never
+  // signal loss, the last offS / dropS of every offEveryS / dropEveryS
+  float    offEveryS = 0.0f;          // leads off: ADC at full scale
+  float    offS = 0.0f;
+  float    dropEveryS = 0.0f;         // electrode dropout: flat baseline plus noise
+  float    dropS = 0.0f;
+  uint32_t seed   = 2;
+};
+class SynthEcg : public EcgSource {
+public:
+  explicit SynthEcg(const SynthEcgParams& p);
+  int adc(uint64_t tUs) override;
+  float bpm() const { return _bpm; }  // underlying rate, NAN once stopped
+  const std::vector<uint64_t>& beats() const { return _truth; }   // R peaks, us
+private:
+  struct Beat { double r; float rr; bool ectopic; };
+  SynthEcgParams _p;
+  NoiseGen _noise;
+  float    _bpm;
+  Beat     _prev, _cur, _next;
+  int      _beatNo = 0;
+  bool     _compensate = false;       // next R-R follows an ectopic beat
+  std::vector<uint64_t> _truth;
+
+  float _rateAt(double t) const;
+  Beat  _after(const Beat& b);
+  bool  _inWindow(double t, float every, float len) const;
+  float _wave(const Beat& b, double t) const;
+};
+
+// Numeric columns of a CSV file; lines that do not parse (headers,
+// comments) are skipped.
+class CsvTrace {
+public:
+  bool   load(const char* path);
+  size_t rows() const { return _cols ? _v.size() / _cols : 0; }
+  size_t cols() const { return _cols; }
+  float  at(size_t row, size_t col) const { return _v[row * _cols + col]; }
+private:
+  std::vector<float> _v;
+  size_t _cols = 0;
+};
+
+// Recorded red/IR columns at `hz`, resampled to 50 Hz; loops at the end.
+class CsvPpg : public PpgSource {
+public:
+  CsvPpg(const CsvTrace& t, size_t redCol, size_t irCol, float hz)
+    : _t(t), _red(redCol), _ir(irCol), _hz(hz) {}
+  void sample(uint64_t n, int32_t& red, int32_t& ir) override;
+private:
+  const CsvTrace& _t;
+  size_t _red, _ir;
+  float  _hz;
+};
+
+// Recorded ECG column at `hz`: adc = value * scale + offset, clamped;
+// loops at the end.
+class CsvEcg : public EcgSource {
+public:
+  CsvEcg(const CsvTrace& t, size_t col, float hz, float scale, float offset)
+    : _t(t), _col(col), _hz(hz), _scale(scale), _offset(offset) {}
+  int adc(uint64_t tUs) override;
+private:
+  const CsvTrace& _t;
+  size_t _col;
+  float  _hz, _scale, _offset;
+};
+
+// Routes analogRead() of `pin` to an EcgSource (hal::setAdc).
+void attachEcg(EcgSource* src, uint8_t pin);
+
+// ---------- I2C devices ----------
+
+// MAX30102 register model: PART_ID, MODE with soft reset, FIFO pointers,
+// and a 32-deep FIFO filled from a PpgSource while MODE is SpO2, at the
+// rate SPO2_SR / SMP_AVE give in virtual time. Samples scale with LED1_PA
+// (red) and LED2_PA (IR) against the firmware's PPG_LED_INIT; the source's
+// read noise is divided by sqrt(SMP_AVE). A full FIFO overwrites its
+// oldest sample and counts OVF_COUNTER, as the part does with
+// FIFO_ROLLOVER_EN set. With setIntPin() the FIFO almost-full interrupt
+// (INT_ENABLE_1 A_FULL_EN, FIFO_A_FULL) drives that pin low until
+// INT_STATUS_1 is read; the FIFO is then filled from a 1 ms esp_timer
+// rather than only when the bus touches the part.
+class FakeMax30102 : public hal::I2CDevice {
+public:
+  static const uint8_t ADDR = 0x57;
+  explicit FakeMax30102(PpgSource* src) : _src(src), _noise(11) {}
+  bool   write(const uint8_t* data, size_t n) override;
+  size_t read(uint8_t* out, size_t n) override;
+
+  void     setIntPin(uint8_t pin);
+  uint8_t  reg(uint8_t r) const { return _reg[r]; }
+  uint64_t produced() const { return _n; }      // samples put in the FIFO
+  uint32_t overwritten() const { return _lost; }
+
+private:
+  static const int DEPTH = 32;
+  static const uint64_t SOURCE_US = 20000;     // PpgSource index period
+
+  PpgSource* _src;
+  NoiseGen _noise;
+  uint8_t  _reg[256] = {};
+  uint8_t  _ptr = 0;                           // register address pointer
+  uint8_t  _fifo[DEPTH][6];
+  uint8_t  _wr = 0, _rd = 0, _ovf = 0;
+  int      _fill = 0;
+  int      _byte = 0;                          // byte within the sample at _rd
+  uint64_t _n = 0, _nextUs = 0, _startUs = 0;
+  uint32_t _lost = 0;
+  bool     _running = false;
+  int      _intPin = -1;
+
+  void    _catchUp();
+  int     _average() const;
+  uint64_t _periodUs() const;
+  uint8_t _readByte();
+  void    _writeReg(uint8_t r, uint8_t v);
+  void    _updateInt();
+  static void _tick(void* self);
+};
+
+// MAX30205 at `addr` serving temperature register 0x00 (°C x 256).
+class FakeMax30205 : public hal::I2CDevice {
+public:
+  explicit FakeMax30205(float tempC) : _tempC(tempC) {}
+  void   setTemp(float tempC) { _tempC = tempC; }
+  bool   write(const uint8_t* data, size_t n) override;
+  size_t read(uint8_t* out, size_t n) override;
+private:
+  float   _tempC;
+  uint8_t _ptr = 0;
+};
@@ -0,0 +1,11 @@
+// host/freertos/FreeRTOS.h
+#pragma once
+#include <stdint.h>
+
+// Single-threaded host: only the types and constants the code names.
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+#define portMAX_DELAY      0xFFFFFFFFu
+#define pdTRUE             1
+#define pdFALSE            0
+#define portTICK_PERIOD_MS 1
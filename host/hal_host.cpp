@@ -0,0 +1,168 @@
+// host/hal_host.cpp
+#include <Arduino.h>
+#include <Wire.h>
+#include <esp_timer.h>
+#include <stdarg.h>
+#include <time.h>
+
+HostSerial Serial;
+EspClass   ESP;
+TwoWire    Wire;
+
+// ---------- clock and timers ----------
+
+struct esp_timer {
+  esp_timer_cb_t cb;
+  void*          arg;
+  uint64_t       periodUs;
+  uint64_t       dueUs;
+  bool           running;
+};
+
+namespace {
+const int MAX_TIMERS = 8;
+esp_timer       g_timers[MAX_TIMERS];
+int             g_timerCount = 0;
+uint64_t        g_nowUs = 0;
+hal::AdcSource  g_adc = nullptr;
+void*           g_adcCtx = nullptr;
+int8_t          g_pins[64];
+hal::I2CDevice* g_i2c[128];
+}
+
+namespace hal {
+
+void reset() {
+  g_nowUs = 0;
+  g_timerCount = 0;
+  g_adc = nullptr;
+  g_adcCtx = nullptr;
+  memset(g_pins, -1, sizeof(g_pins));
+  memset(g_i2c, 0, sizeof(g_i2c));
+}
+
+uint64_t nowUs() { return g_nowUs; }
+
+void advanceUs(uint64_t us) {
+  uint64_t end = g_nowUs + us;
+  for (;;) {
+    // earliest due timer inside the step, if any
+    esp_timer* next = nullptr;
+    for (int i = 0; i < g_timerCount; i++) {
+      esp_timer& t = g_timers[i];
+      if (t.running && t.dueUs <= end && (!next || t.dueUs < next->dueUs)) next = &t;
+    }
+    if (!next) break;
+    if (next->dueUs > g_nowUs) g_nowUs = next->dueUs;
+    next->dueUs += next->periodUs;
+    next->cb(next->arg);
+  }
+  g_nowUs = end;
+}
+
+void setAdc(AdcSource fn, void* ctx) { g_adc = fn; g_adcCtx = ctx; }
+
+void setPin(uint8_t p, int level) { if (p < sizeof(g_pins)) g_pins[p] = level ? 1 : 0; }
+int  pin(uint8_t p) { return (p < sizeof(g_pins) && g_pins[p] >= 0) ? g_pins[p] : HIGH; }
+
+void       attachI2C(uint8_t addr, I2CDevice* dev) { if (addr < 128) g_i2c[addr] = dev; }
+I2CDevice* i2cDevice(uint8_t addr) { return addr < 128 ? g_i2c[addr] : nullptr; }
+
+} // namespace hal
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+  if (g_timerCount >= MAX_TIMERS) return ESP_FAIL;
+  esp_timer& t = g_timers[g_timerCount++];
+  t.cb = args->callback;
+  t.arg = args->arg;
+  t.periodUs = 0;
+  t.dueUs = 0;
+  t.running = false;
+  *out = &t;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t periodUs) {
+  if (!t || !periodUs) return ESP_FAIL;
+  t->periodUs = periodUs;
+  t->dueUs = g_nowUs + periodUs;
+  t->running = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+  if (!t || !t->running) return ESP_FAIL;
+  t->running = false;
+  return ESP_OK;
+}
+
+int64_t esp_timer_get_time() { return (int64_t)g_nowUs; }
+
+// ---------- pins and ADC ----------
+
+int analogRead(uint8_t pin) {
+  return g_adc ? g_adc(g_adcCtx, pin, g_nowUs) : 2048;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+int  digitalRead(uint8_t pin) { return hal::pin(pin); }
+void attachInterrupt(int, void (*)(), int) {}
+
+// ---------- Print / ESP ----------
+
+size_t Print::print(float v, int decimals) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.*f", decimals, (double)v);
+  return print(buf);
+}
+
+size_t Print::printf(const char* fmt, ...) {
+  char buf[256];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n < 0) return 0;
+  return write((const uint8_t*)buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
+
+uint32_t EspClass::getCycleCount() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec);
+}
+
+// ---------- I2C ----------
+
+void TwoWire::beginTransmission(uint8_t addr) {
+  _addr = addr;
+  _txLen = 0;
+}
+
+size_t TwoWire::write(uint8_t b) {
+  if (_txLen >= BUF) return 0;
+  _tx[_txLen++] = b;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t n) {
+  size_t k = 0;
+  while (k < n && write(data[k])) k++;
+  return k;
+}
+
+// 0 = ACK, 2 = address NACK, as the Arduino API reports them
+uint8_t TwoWire::endTransmission(bool) {
+  hal::I2CDevice* d = hal::i2cDevice(_addr);
+  bool ok = d && d->write(_tx, _txLen);
+  _txLen = 0;
+  return ok ? 0 : 2;
+}
+
+size_t TwoWire::requestFrom(uint8_t addr, size_t n, bool) {
+  hal::I2CDevice* d = hal::i2cDevice(addr);
+  if (n > BUF) n = BUF;
+  _rxPos = 0;
+  _rxLen = d ? d->read(_rx, n) : 0;
+  return _rxLen;
+}
@@ -0,0 +1,41 @@
+// host/hal_host.h
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Host-side hardware layer behind the stand-in Arduino.h, Wire.h and
+// esp_timer.h in this directory. The firmware sources compile unchanged
+// against those headers; a host program (tools/replay.cpp) drives this
+// namespace instead of real pins and a real clock.
+//
+// Time is virtual: it only moves when advanceUs() (or delay()) is called,
+// and esp_timer callbacks fire inside advanceUs() at their due times. A
+// replay is therefore deterministic and runs as fast as the CPU allows.
+namespace hal {
+
+// Clear the clock, timers, pins, ADC source and I2C devices.
+void     reset();
+uint64_t nowUs();
+void     advanceUs(uint64_t us);
+
+// analogRead(pin) returns fn(ctx, pin, nowUs()); no source reads mid-scale.
+typedef int (*AdcSource)(void* ctx, uint8_t pin, uint64_t tUs);
+void setAdc(AdcSource fn, void* ctx);
+
+// digitalRead() levels; pins never set read HIGH (pull-ups).
+void setPin(uint8_t pin, int level);
+int  pin(uint8_t pin);
+
+// An I2C target. write() gets the bytes of one write transaction (an empty
+// one for an address probe) and returns false to NACK; read() fills a read
+// transaction and returns the bytes it supplied.
+class I2CDevice {
+public:
+  virtual ~I2CDevice() {}
+  virtual bool   write(const uint8_t* data, size_t n) = 0;
+  virtual size_t read(uint8_t* out, size_t n) = 0;
+};
+void       attachI2C(uint8_t addr, I2CDevice* dev);
+I2CDevice* i2cDevice(uint8_t addr);
+
+} // namespace hal
@@ -0,0 +1,38 @@
+// host/host_rig.cpp
+#include "host_rig.h"
+
+void HostRig::begin(const Sources& src) {
+  hal::reset();
+  _src = src;
+  _ms = 0;
+
+  delete _fakeSpo2; _fakeSpo2 = nullptr;
+  delete _fakeTemp; _fakeTemp = nullptr;
+  if (src.ppg) {
+    _fakeSpo2 = new FakeMax30102(src.ppg);
+    hal::attachI2C(FakeMax30102::ADDR, _fakeSpo2);
+#if MAX30102_INT_PIN >= 0
+    _fakeSpo2->setIntPin(MAX30102_INT_PIN);
+#endif
+  }
+  if (!isnan(src.tempC)) {
+    _fakeTemp = new FakeMax30205(src.tempC);
+    hal::attachI2C(0x48, _fakeTemp);
+  }
+  if (src.ecg) attachEcg(src.ecg, ECG_PIN);
+
+  bus.begin(Wire, I2C_SDA, I2C_SCL, I2C_BUS_HZ);
+  spo2.begin(bus);
+  tprobe.begin(bus);
+  if (src.ecg) ecg.begin();
+}
+
+void HostRig::stepMs(uint32_t ms) {
+  for (uint32_t k = 0; k < ms; k++) {
+    hal::advanceUs(1000);
+    _ms++;
+    if (_src.ecg) { ecg.update(); ecg.process(); }
+    if (_ms % SPO2_MS == 0) spo2.update();
+    if (_ms % TEMP_MS == 0) tprobe.update();
+  }
+}
@@ -0,0 +1,42 @@
+// host/host_rig.h
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "fake_devices.h"
+#include "util_i2cbus.h"
+#include "sensor_max30102.h"
+#include "sensor_max30205.h"
+#include "sensor_ad8232.h"
+
+// The firmware's sensor stack on fake hardware, stepped on the virtual
+// clock with the same cadence the scheduler gives it on the board:
+// ECG on its esp_timer (or polled each step), MAX30102 every 20 ms,
+// MAX30205 every 500 ms. A null source or NAN temperature leaves that
+// device off the bus, so its driver sees it as absent.
+class HostRig {
+public:
+  struct Sources {
+    PpgSource* ppg   = nullptr;
+    EcgSource* ecg   = nullptr;
+    float      tempC = NAN;
+  };
+
+  void begin(const Sources& src);
+  void stepMs(uint32_t ms = 1);
+  uint32_t ms() const { return _ms; }
+
+  I2CBus         bus;
+  Max30102Sensor spo2;
+  Max30205Sensor tprobe;
+  AD8232Sensor   ecg;
+
+  FakeMax30102*  fakeSpo2() { return _fakeSpo2; }
+  FakeMax30205*  fakeTemp() { return _fakeTemp; }
+
+private:
+  static const uint32_t SPO2_MS = 20, TEMP_MS = 500;
+  Sources       _src;
+  FakeMax30102* _fakeSpo2 = nullptr;
+  FakeMax30205* _fakeTemp = nullptr;
+  uint32_t      _ms = 0;
+};
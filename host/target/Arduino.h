@@ -0,0 +1,35 @@
+// host/target/Arduino.h
+#pragma once
+// Declaration-only additions to the host Arduino stand-in for the code that
+// stays on the target (web server, Wi-Fi, settings, flash log). That code is
+// compiled on the host to catch errors, never linked or run.
+#include "../Arduino.h"
+
+typedef const char* PGM_P;
+
+class String {
+public:
+  String(const char* s = "");
+  String(const String& s);
+  String(int v);
+  String(unsigned v);
+  String(long v);
+  String(unsigned long v);
+  ~String();
+  String& operator=(const String& s);
+  String& operator=(const char* s);
+  String& operator+=(const String& s);
+  String& operator+=(const char* s);
+  String& operator+=(char c);
+  bool operator==(const String& s) const;
+  bool operator==(const char* s) const;
+  bool operator!=(const char* s) const { return !(*this == s); }
+  const char* c_str() const;
+  unsigned length() const;
+  char     operator[](unsigned i) const;
+  int      toInt() const;
+  bool     reserve(unsigned n);
+};
+String operator+(const String& a, const char* b);
+String operator+(const char* a, const String& b);
+String operator+(const String& a, const String& b);
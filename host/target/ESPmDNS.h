@@ -0,0 +1,16 @@
+// host/target/ESPmDNS.h
+#pragma once
+// Declarations only (see Arduino.h here).
+#include <Arduino.h>
+
+class MDNSResponder {
+public:
+  bool begin(const char* hostname);
+  void end();
+  void addService(const char* service, const char* proto, uint16_t port);
+  void enableArduino(uint16_t port = 3232, bool auth = false);
+};
+extern MDNSResponder MDNS;
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
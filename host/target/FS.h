@@ -0,0 +1,37 @@
+// host/target/FS.h
+#pragma once
+// Declarations only (see Arduino.h here).
+#include <Arduino.h>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+enum SeekMode { SeekSet, SeekCur, SeekEnd };
+class File {
+public:
+  explicit operator bool() const;
+  const char* name() const;
+  const char* path() const;
+  bool   isDirectory();
+  File   openNextFile(const char* mode = FILE_READ);
+  size_t size() const;
+  size_t position() const;
+  bool   seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t read(uint8_t* buf, size_t n);
+  size_t write(const uint8_t* buf, size_t n);
+  void   flush();
+  void   close();
+};
+class FS {
+public:
+  File open(const char* path, const char* mode = FILE_READ, bool create = false);
+  bool exists(const char* path);
+  bool mkdir(const char* path);
+  bool remove(const char* path);
+  bool rename(const char* from, const char* to);
+};
+}
+using fs::File;
+using fs::FS;
@@ -0,0 +1,12 @@
+// host/target/LittleFS.h
+#pragma once
+// Declarations only (see Arduino.h here).
+#include <FS.h>
+
+class LittleFSFS : public fs::FS {
+public:
+  bool   begin(bool formatOnFail = false);
+  size_t usedBytes();
+  size_t totalBytes();
+};
+extern LittleFSFS LittleFS;
@@ -0,0 +1,17 @@
+// host/target/Preferences.h
+#pragma once
+// Declarations only (see Arduino.h here).
+#include <Arduino.h>
+
+class Preferences {
+public:
+  bool     begin(const char* name, bool readOnly = false);
+  void     end();
+  bool     clear();
+  bool     remove(const char* key);
+  bool     isKey(const char* key);
+  size_t   putString(const char* key, const String& value);
+  String   getString(const char* key, const String& def = String());
+  size_t   putUInt(const char* key, uint32_t value);
+  uint32_t getUInt(const char* key, uint32_t def = 0);
+};
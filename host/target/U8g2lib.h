@@ -0,0 +1,12 @@
+#pragma once
+#include <Arduino.h>
+struct u8x8_t{}; struct u8g2_t{}; struct u8g2_cb_t{}; extern const u8g2_cb_t* U8G2_R0;
+typedef uint8_t (*u8x8_msg_cb)(u8x8_t*, uint8_t, uint8_t, void*);
+enum { U8X8_MSG_BYTE_INIT=1, U8X8_MSG_BYTE_SET_DC, U8X8_MSG_BYTE_START_TRANSFER, U8X8_MSG_BYTE_SEND, U8X8_MSG_BYTE_END_TRANSFER };
+uint8_t u8x8_GetI2CAddress(u8x8_t*);
+extern "C" uint8_t u8x8_gpio_and_delay_arduino(u8x8_t*, uint8_t, uint8_t, void*);
+void u8g2_Setup_ssd1306_i2c_128x64_noname_f(u8g2_t*, const u8g2_cb_t*, u8x8_msg_cb, u8x8_msg_cb);
+extern const uint8_t u8g2_font_6x12_tf[]; extern const uint8_t u8g2_font_5x8_tf[];
+class U8G2 { protected: u8g2_t u8g2; public: void begin(); void clearBuffer(); void sendBuffer(); void setFont(const uint8_t*); void drawStr(int,int,const char*);
+ void drawBox(int,int,int,int); void drawFrame(int,int,int,int); void setDrawColor(int); int8_t getAscent(); int8_t getDescent(); void updateDisplayArea(int,int,int,int); void setContrast(int);
+ void drawPixel(int,int); void drawVLine(int,int,int); void drawHLine(int,int,int); void drawLine(int,int,int,int); int getStrWidth(const char*); };
@@ -0,0 +1,36 @@
+// host/target/WebServer.h
+#pragma once
+// Declarations only (see Arduino.h here).
+#include <Arduino.h>
+#include <WiFi.h>
+#include <functional>
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_POST };
+
+class WebServer {
+public:
+  typedef std::function<void(void)> THandlerFunction;
+  explicit WebServer(int port = 80);
+  void   begin();
+  void   handleClient();
+  void   on(const String& uri, THandlerFunction fn);
+  void   on(const String& uri, HTTPMethod method, THandlerFunction fn);
+  void   onNotFound(THandlerFunction fn);
+  void   collectHeaders(const char* headerKeys[], size_t count);
+  String header(const String& name);
+  bool   hasHeader(const String& name);
+  bool   hasArg(const String& name);
+  String arg(const String& name);
+  String uri();
+  WiFiClient client();
+  void   send(int code, const char* contentType = nullptr, const String& content = String(""));
+  void   send_P(int code, PGM_P contentType, PGM_P content);
+  void   send_P(int code, PGM_P contentType, PGM_P content, size_t len);
+  void   sendHeader(const String& name, const String& value, bool first = false);
+  void   setContentLength(size_t len);
+  void   sendContent(const String& content);
+  void   sendContent(const char* content, size_t len);
+  void   sendContent_P(PGM_P content);
+  void   sendContent_P(PGM_P content, size_t len);
+};
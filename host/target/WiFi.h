@@ -0,0 +1,56 @@
+// host/target/WiFi.h
+#pragma once
+// Declarations only (see Arduino.h here).
+#include <Arduino.h>
+#include <functional>
+
+typedef enum {
+  ARDUINO_EVENT_WIFI_STA_CONNECTED,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP,
+  ARDUINO_EVENT_WIFI_STA_LOST_IP,
+  ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+typedef union {
+  struct { uint8_t ssid[32]; uint8_t ssid_len; uint8_t bssid[6]; uint8_t reason; } wifi_sta_disconnected;
+} arduino_event_info_t;
+typedef std::function<void(arduino_event_id_t, arduino_event_info_t)> WiFiEventFuncCb;
+typedef void (*WiFiEventCb)(arduino_event_id_t);
+
+typedef enum { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA } wifi_mode_t;
+typedef enum { WL_IDLE_STATUS, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+
+class IPAddress {
+public:
+  String toString() const;
+};
+
+class WiFiClient : public Print {
+public:
+  size_t   write(const uint8_t* data, size_t n) override;
+  int      available();
+  bool     connected();
+  void     stop();
+  void     setNoDelay(bool on);
+  explicit operator bool();
+};
+
+class WiFiClass {
+public:
+  void        persistent(bool on);
+  int         onEvent(WiFiEventCb cb, arduino_event_id_t e = ARDUINO_EVENT_MAX);
+  int         onEvent(WiFiEventFuncCb cb, arduino_event_id_t e = ARDUINO_EVENT_MAX);
+  bool        mode(wifi_mode_t m);
+  bool        setHostname(const char* name);
+  bool        setAutoReconnect(bool on);
+  wl_status_t begin(const char* ssid, const char* pass = nullptr);
+  bool        disconnect(bool wifiOff = false, bool eraseAp = false);
+  wl_status_t status();
+  IPAddress   localIP();
+  int8_t      RSSI();
+  bool        softAP(const char* ssid, const char* pass = nullptr);
+  bool        softAPdisconnect(bool wifiOff = false);
+  uint8_t     softAPgetStationNum();
+  IPAddress   softAPIP();
+};
+extern WiFiClass WiFi;
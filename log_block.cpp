@@ -0,0 +1,190 @@
+// log_block.cpp
+#include "log_block.h"
+#include <string.h>
+#include <math.h>
+
+static inline void putU16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static inline void putU32(uint8_t* p, uint32_t v) { putU16(p, (uint16_t)v); putU16(p + 2, (uint16_t)(v >> 16)); }
+static inline void putU64(uint8_t* p, uint64_t v) { putU32(p, (uint32_t)v); putU32(p + 4, (uint32_t)(v >> 32)); }
+static inline uint16_t getU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t getU32(const uint8_t* p) { return getU16(p) | ((uint32_t)getU16(p + 2) << 16); }
+static inline uint64_t getU64(const uint8_t* p) { return getU32(p) | ((uint64_t)getU32(p + 4) << 32); }
+
+static inline uint32_t zigzag(int32_t v)    { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static inline int32_t  unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// worst case for one group: 4-bit width + 16 x 15 bits
+static const uint32_t GROUP_MAX_BITS = 4 + 16 * 15;
+
+uint32_t logCrc32(const uint8_t* p, size_t n, uint32_t crc) {
+  crc = ~crc;
+  while (n--) {
+    crc ^= *p++;
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+  }
+  return ~crc;
+}
+
+void LogBlockWriter::_begin(uint8_t* buf, const LogBlockHeader& h, uint8_t type) {
+  _buf = buf;
+  _h = h;
+  _h.type = type;
+  _count = 0;
+  _grpN = 0;
+  _bitPos = 0;
+  memset(_buf, 0, LOG_BLOCK_BYTES);
+}
+
+void LogBlockWriter::beginEcg(uint8_t* buf, const LogBlockHeader& h)    { _begin(buf, h, LOG_TYPE_ECG); }
+void LogBlockWriter::beginVitals(uint8_t* buf, const LogBlockHeader& h) { _begin(buf, h, LOG_TYPE_VITALS); }
+
+void LogBlockWriter::_putBits(uint32_t v, int n) {
+  uint8_t* p = _buf + LOG_HDR_BYTES + 2;
+  for (int i = 0; i < n; i++, _bitPos++)
+    if (v & (1u << i)) p[_bitPos >> 3] |= (uint8_t)(1u << (_bitPos & 7));
+}
+
+void LogBlockWriter::_flushGroup() {
+  if (!_grpN) return;
+  uint32_t z[16], all = 0;
+  for (int i = 0; i < _grpN; i++) {
+    z[i] = zigzag((int32_t)_grp[i] - _prev);
+    _prev = _grp[i];
+    all |= z[i];
+  }
+  int w = 0;
+  while (all >> w) w++;
+  _putBits((uint32_t)w, 4);
+  for (int i = 0; i < _grpN; i++) _putBits(z[i], w);
+  _grpN = 0;
+}
+
+bool LogBlockWriter::addEcg(int16_t s) {
+  if (!_buf || _h.type != LOG_TYPE_ECG || _count >= 0xFFFF) return false;
+  // deltas must fit the 15 bits a 4-bit width can give
+  if (s > LOG_ECG_MAX) s = LOG_ECG_MAX;
+  if (s < LOG_ECG_MIN) s = LOG_ECG_MIN;
+  if (_count == 0) {
+    putU16(_buf + LOG_HDR_BYTES, (uint16_t)s);
+    _prev = s;
+    _count = 1;
+    return true;
+  }
+  // a new group must fit in the worst case
+  if (_grpN == 0 && 2 * 8 + _bitPos + GROUP_MAX_BITS > LOG_PAYLOAD_MAX * 8) return false;
+  _grp[_grpN++] = s;
+  _count++;
+  if (_grpN == 16) _flushGroup();
+  return true;
+}
+
+bool LogBlockWriter::addVitals(const LogVitals& v) {
+  if (!_buf || _h.type != LOG_TYPE_VITALS) return false;
+  if ((_count + 1) * LOG_VITALS_BYTES > LOG_PAYLOAD_MAX) return false;
+  uint8_t* p = _buf + LOG_HDR_BYTES + _count * LOG_VITALS_BYTES;
+  p[0] = (v.pulse  >= 0 && v.pulse  < 255) ? (uint8_t)v.pulse  : 0xFF;
+  p[1] = (v.spo2   >= 0 && v.spo2   < 255) ? (uint8_t)v.spo2   : 0xFF;
+  p[2] = (v.ecgBpm >  0 && v.ecgBpm < 255) ? (uint8_t)v.ecgBpm : 0xFF;
+  p[3] = (v.finger ? LOG_VF_FINGER : 0) | (v.leadsOff ? LOG_VF_LEADOFF : 0);
+  float pi = v.pi < 0 ? 0 : (v.pi > 655.0f ? 655.0f : v.pi);
+  putU16(p + 4, (uint16_t)(pi * 100.0f + 0.5f));
+  int16_t t = 0x7FFF;
+  if (v.hasTemp && v.tempC > -300.0f && v.tempC < 300.0f) t = (int16_t)lroundf(v.tempC * 100.0f);
+  putU16(p + 6, (uint16_t)t);
+  p[8] = v.sqi > 100 ? 100 : v.sqi;
+  _count++;
+  return true;
+}
+
+size_t LogBlockWriter::finish(uint32_t seq) {
+  if (!_buf) return 0;
+  size_t payload;
+  if (_h.type == LOG_TYPE_ECG) {
+    _flushGroup();
+    payload = _count ? 2 + (_bitPos + 7) / 8 : 0;
+  } else {
+    payload = _count * LOG_VITALS_BYTES;
+  }
+  uint8_t* b = _buf;
+  putU32(b + 0, LOG_MAGIC);
+  b[4] = LOG_VERSION;
+  b[5] = _h.type;
+  putU16(b + 6, (uint16_t)payload);
+  putU32(b + 8, seq);
+  putU32(b + 12, _h.bootId);
+  putU32(b + 16, _h.tMs);
+  putU32(b + 20, _h.tEpoch);
+  putU64(b + 24, _h.first);
+  putU16(b + 32, _h.rate);
+  putU16(b + 34, (uint16_t)_count);
+  uint32_t crc = logCrc32(b, 36);
+  crc = logCrc32(b + LOG_HDR_BYTES, payload, crc);
+  putU32(b + 36, crc);
+  _buf = nullptr;
+  return LOG_BLOCK_BYTES;
+}
+
+bool logReadHeader(const uint8_t* blk, size_t len, LogBlockHeader& h) {
+  if (len < LOG_HDR_BYTES || getU32(blk) != LOG_MAGIC || blk[4] < 1 || blk[4] > LOG_VERSION) return false;
+  h.version = blk[4];
+  h.type    = blk[5];
+  h.payload = getU16(blk + 6);
+  h.seq     = getU32(blk + 8);
+  h.bootId  = getU32(blk + 12);
+  h.tMs     = getU32(blk + 16);
+  h.tEpoch  = getU32(blk + 20);
+  h.first   = getU64(blk + 24);
+  h.rate    = getU16(blk + 32);
+  h.count   = getU16(blk + 34);
+  return h.payload <= LOG_PAYLOAD_MAX;
+}
+
+bool logCheckBlock(const uint8_t* blk, size_t len, LogBlockHeader& h) {
+  if (len < LOG_BLOCK_BYTES || !logReadHeader(blk, len, h)) return false;
+  uint32_t crc = logCrc32(blk, 36);
+  crc = logCrc32(blk + LOG_HDR_BYTES, h.payload, crc);
+  return crc == getU32(blk + 36);
+}
+
+size_t logDecodeEcg(const uint8_t* blk, const LogBlockHeader& h, int16_t* out, size_t maxOut) {
+  if (h.type != LOG_TYPE_ECG || h.count == 0 || h.count > maxOut || h.payload < 2) return 0;
+  const uint8_t* p = blk + LOG_HDR_BYTES + 2;
+  uint32_t bits = (uint32_t)(h.payload - 2) * 8, pos = 0;
+  int32_t prev = (int16_t)getU16(blk + LOG_HDR_BYTES);
+  out[0] = (int16_t)prev;
+  size_t n = 1;
+  while (n < h.count) {
+    if (pos + 4 > bits) return 0;
+    int w = 0;
+    for (int i = 0; i < 4; i++, pos++) w |= ((p[pos >> 3] >> (pos & 7)) & 1) << i;
+    for (int k = 0; k < 16 && n < h.count; k++) {
+      if (pos + w > bits) return 0;
+      uint32_t z = 0;
+      for (int i = 0; i < w; i++, pos++) z |= (uint32_t)((p[pos >> 3] >> (pos & 7)) & 1) << i;
+      prev += unzigzag(z);
+      out[n++] = (int16_t)prev;
+    }
+  }
+  return n;
+}
+
+size_t logDecodeVitals(const uint8_t* blk, const LogBlockHeader& h, LogVitals* out, size_t maxOut) {
+  size_t rec = h.version == 1 ? LOG_VITALS_V1_BYTES : LOG_VITALS_BYTES;
+  if (h.type != LOG_TYPE_VITALS || h.count > maxOut ||
+      (size_t)h.count * rec > h.payload) return 0;
+  for (size_t i = 0; i < h.count; i++) {
+    const uint8_t* p = blk + LOG_HDR_BYTES + i * rec;
+    LogVitals& v = out[i];
+    v.pulse    = p[0] == 0xFF ? -1 : p[0];
+    v.spo2     = p[1] == 0xFF ? -1 : p[1];
+    v.ecgBpm   = p[2] == 0xFF ? -1 : p[2];
+    v.finger   = (p[3] & LOG_VF_FINGER) != 0;
+    v.leadsOff = (p[3] & LOG_VF_LEADOFF) != 0;
+    v.pi       = getU16(p + 4) / 100.0f;
+    int16_t t  = (int16_t)getU16(p + 6);
+    v.hasTemp  = t != 0x7FFF;
+    v.tempC    = v.hasTemp ? t / 100.0f : 0.0f;
+    v.sqi      = rec > LOG_VITALS_V1_BYTES ? p[8] : 0;
+  }
+  return h.count;
+}
@@ -0,0 +1,107 @@
+// log_block.h
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Fixed-size flash log blocks (one flash sector each). Plain C++ with no
+// Arduino dependencies so host tools can decode with the same code; the
+// format is also described in tools/log_decode.py. Little-endian.
+//
+// Header (40 bytes):
+//   0  u32 magic 'HMLB'     4  u8 version      5  u8 type (LOG_TYPE_*)
+//   6  u16 payload bytes    8  u32 block seq (global, monotonic)
+//   12 u32 boot id          16 u32 device ms of the first item
+//   20 u32 unix seconds of the first item (0 = clock not set)
+//   24 u64 ECG: index of the first sample   32 u16 ECG: Hz, vitals: 1
+//   34 u16 item count       36 u32 CRC-32 of bytes 0..35 + payload
+// ECG payload: i16 first sample, then groups of 16 deltas: a 4-bit width w
+//   followed by 16 zig-zag deltas of w bits each (LSB first; the last group
+//   may be short, see count). Flat stretches cost 4 bits per 16 samples.
+//   Samples are clamped to LOG_ECG_MIN..LOG_ECG_MAX (14 bits) so every
+//   delta fits; the filtered ECG ring holds 12.
+// Vitals payload: 9-byte records at 1 Hz:
+//   u8 pulse, u8 spo2, u8 ecgBpm (0xFF = none), u8 flags (LOG_VF_*),
+//   u16 pi x100, i16 tempC x100 (0x7FFF = none), u8 signal quality 0..100
+// Version 1 blocks (8-byte vitals records without the quality byte) are
+// still read.
+
+static const uint32_t LOG_MAGIC        = 0x424C4D48;   // "HMLB"
+static const uint8_t  LOG_VERSION      = 2;
+static const uint8_t  LOG_TYPE_ECG     = 1;
+static const uint8_t  LOG_TYPE_VITALS  = 2;
+static const size_t   LOG_BLOCK_BYTES  = 4096;
+static const size_t   LOG_HDR_BYTES    = 40;
+static const size_t   LOG_PAYLOAD_MAX  = LOG_BLOCK_BYTES - LOG_HDR_BYTES;
+static const size_t   LOG_VITALS_BYTES = 9;
+static const size_t   LOG_VITALS_V1_BYTES = 8;
+static const int16_t  LOG_ECG_MIN      = -8192;
+static const int16_t  LOG_ECG_MAX      = 8191;
+
+static const uint8_t  LOG_VF_FINGER  = 0x01;
+static const uint8_t  LOG_VF_LEADOFF = 0x02;
+
+struct LogBlockHeader {
+  uint8_t  version  = LOG_VERSION;
+  uint8_t  type     = 0;
+  uint16_t payload  = 0;
+  uint32_t seq      = 0;
+  uint32_t bootId   = 0;
+  uint32_t tMs      = 0;
+  uint32_t tEpoch   = 0;
+  uint64_t first    = 0;
+  uint16_t rate     = 0;
+  uint16_t count    = 0;
+};
+
+struct LogVitals {
+  int      pulse  = -1;     // -1 = none (sensor conventions)
+  int      spo2   = -1;
+  int      ecgBpm = -1;
+  bool     finger = false;
+  bool     leadsOff = false;
+  float    pi     = 0.0f;
+  float    tempC  = 0.0f;
+  bool     hasTemp = false;
+  uint8_t  sqi    = 0;      // 0 in version 1 blocks
+};
+
+// Builds one block in a caller-owned LOG_BLOCK_BYTES buffer.
+class LogBlockWriter {
+public:
+  // h.type/seq/count/payload are filled in by the writer
+  void beginEcg(uint8_t* buf, const LogBlockHeader& h);
+  void beginVitals(uint8_t* buf, const LogBlockHeader& h);
+
+  // false = block full, the item was not added (start a new block with it)
+  bool addEcg(int16_t s);
+  bool addVitals(const LogVitals& v);
+
+  size_t   count() const { return _count; }
+  bool     active() const { return _buf != nullptr; }
+  // Packs what is pending, writes header + CRC, zero-pads; returns
+  // LOG_BLOCK_BYTES. The seq is given here so blocks are numbered in the
+  // order they are stored. The writer is inactive afterwards.
+  size_t   finish(uint32_t seq);
+
+private:
+  uint8_t*       _buf = nullptr;
+  LogBlockHeader _h;
+  size_t         _count = 0;
+  // ECG bit packing
+  int16_t  _prev = 0;
+  int16_t  _grp[16];
+  int      _grpN = 0;
+  uint32_t _bitPos = 0;          // in the payload, after the first sample
+
+  void _begin(uint8_t* buf, const LogBlockHeader& h, uint8_t type);
+  void _flushGroup();
+  void _putBits(uint32_t v, int n);
+};
+
+uint32_t logCrc32(const uint8_t* p, size_t n, uint32_t crc = 0);
+
+// Validates magic/version/size and the CRC of a whole block.
+bool   logReadHeader(const uint8_t* blk, size_t len, LogBlockHeader& h);
+bool   logCheckBlock(const uint8_t* blk, size_t len, LogBlockHeader& h);
+size_t logDecodeEcg(const uint8_t* blk, const LogBlockHeader& h, int16_t* out, size_t maxOut);
+size_t logDecodeVitals(const uint8_t* blk, const LogBlockHeader& h, LogVitals* out, size_t maxOut);
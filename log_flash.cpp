@@ -0,0 +1,234 @@
+// log_flash.cpp
+#include "log_flash.h"
+#include <LittleFS.h>
+#include "util_stats.h"
+#include <time.h>
+
+static const int LOG_ECG_DECIM = ECG_SAMPLE_HZ / LOG_ECG_HZ;
+static_assert(LOG_ECG_DECIM >= 1 && LOG_ECG_DECIM * LOG_ECG_HZ == ECG_SAMPLE_HZ,
+              "ECG_SAMPLE_HZ must be a multiple of LOG_ECG_HZ");
+
+static const char* LOG_DIR = "/log";
+
+void FlashLog::_path(char* out, size_t n, uint32_t seq) {
+  snprintf(out, n, "%s/%08lx.seg", LOG_DIR, (unsigned long)seq);
+}
+
+uint32_t FlashLog::_epochNow() {
+  time_t now = time(nullptr);
+  return now > 1600000000 ? (uint32_t)now : 0;   // 0 until the clock is set
+}
+
+size_t FlashLog::usedBytes() const  { return _ok ? LittleFS.usedBytes() : 0; }
+size_t FlashLog::totalBytes() const { return _ok ? LittleFS.totalBytes() : 0; }
+
+bool FlashLog::begin(AD8232Sensor* ecg, uint32_t bootId) {
+  _ecg = ecg;
+  _bootId = bootId;
+  if (!LittleFS.begin(true)) {
+    Serial.println("Log: LittleFS mount failed, logging off.");
+    return false;
+  }
+  _ok = true;
+  _scan();
+  if (_ecg) _ecgNext = _ecg->sampleIndex();
+  Serial.printf("Log: %d segments, %u/%u KB used, next block %lu\n", _nSegs,
+                (unsigned)(usedBytes() / 1024), (unsigned)(totalBytes() / 1024),
+                (unsigned long)_nextSeq);
+  return true;
+}
+
+// Finds the segment files and the next block seq.
+void FlashLog::_scan() {
+  _nSegs = 0;
+  _nextSeq = 0;
+  _segBlocks = LOG_SEG_BLOCKS;                // start a fresh segment
+  File dir = LittleFS.open(LOG_DIR);
+  if (!dir || !dir.isDirectory()) { LittleFS.mkdir(LOG_DIR); return; }
+
+  for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+    const char* name = f.name();
+    const char* base = strrchr(name, '/');
+    base = base ? base + 1 : name;
+    char* end = nullptr;
+    uint32_t seq = strtoul(base, &end, 16);
+    if (end != base + 8 || strcmp(end, ".seg") != 0 || _nSegs >= MAX_SEGS) continue;
+    int i = _nSegs++;                         // insertion sort, oldest first
+    while (i > 0 && _segs[i - 1] > seq) { _segs[i] = _segs[i - 1]; i--; }
+    _segs[i] = seq;
+  }
+  if (!_nSegs) return;
+
+  // continue numbering after the last stored block
+  char path[24];
+  _path(path, sizeof(path), _segs[_nSegs - 1]);
+  File f = LittleFS.open(path, FILE_READ);
+  size_t blocks = f ? f.size() / LOG_BLOCK_BYTES : 0;
+  _nextSeq = _segs[_nSegs - 1] + blocks;
+  if (blocks) {
+    uint8_t hdr[LOG_HDR_BYTES];
+    LogBlockHeader h;
+    f.seek((blocks - 1) * LOG_BLOCK_BYTES);
+    if (f.read(hdr, sizeof(hdr)) == sizeof(hdr) && logReadHeader(hdr, sizeof(hdr), h))
+      _nextSeq = h.seq + 1;
+  }
+  // append to it only if it is whole-block sized and has room
+  if (f && f.size() % LOG_BLOCK_BYTES == 0) _segBlocks = blocks;
+}
+
+// Starts a new segment named after seq, deleting the oldest ones until a
+// full segment plus the reserve fits.
+void FlashLog::_rotate(uint32_t seq) {
+  char path[24];
+  while (_nSegs > 0 &&
+         (_nSegs >= MAX_SEGS || usedBytes() + SEG_BYTES + LOG_RESERVE_BYTES > totalBytes())) {
+    _path(path, sizeof(path), _segs[0]);
+    LittleFS.remove(path);
+    memmove(_segs, _segs + 1, (_nSegs - 1) * sizeof(_segs[0]));
+    _nSegs--;
+  }
+  _segs[_nSegs++] = seq;
+  _segBlocks = 0;
+}
+
+bool FlashLog::_write(const uint8_t* blk, uint32_t seq) {
+  if (_segBlocks >= LOG_SEG_BLOCKS) _rotate(seq);
+  char path[24];
+  _path(path, sizeof(path), _segs[_nSegs - 1]);
+
+  uint32_t t0 = micros();
+  File f = LittleFS.open(path, FILE_APPEND);
+  bool ok = f && f.write(blk, LOG_BLOCK_BYTES) == LOG_BLOCK_BYTES;
+  if (f) f.close();
+  uint32_t dt = micros() - t0;
+  if (dt > _maxWriteUs) _maxWriteUs = dt;
+
+  if (!ok) {
+    _writeErrors++;
+    _segBlocks = LOG_SEG_BLOCKS;              // don't append after a torn block
+    return false;
+  }
+  _segBlocks++;
+  _written++;
+  return true;
+}
+
+void FlashLog::_store(LogBlockWriter& w) {
+  bool isEcg = &w == &_ecgW;
+  uint8_t* buf = isEcg ? _ecgBuf : _vitBuf;
+  size_t n = w.count();
+  uint32_t seq = _nextSeq++;
+  w.finish(seq);
+  if (isEcg) {
+    _ecgSamples += n;
+    _ecgPayload += (uint32_t)(buf[6] | (buf[7] << 8));
+  }
+  _write(buf, seq);
+}
+
+void FlashLog::_pushEcg(int16_t s, uint64_t srcIdx) {
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (!_ecgW.active()) {
+      // wall time of this sample: now minus its age in the ring
+      uint32_t ageMs = (uint32_t)((_ecg->sampleIndex() - srcIdx) * 1000 / ECG_SAMPLE_HZ);
+      uint32_t epoch = _epochNow();
+      LogBlockHeader h;
+      h.bootId = _bootId;
+      h.tMs    = millis() - ageMs;
+      h.tEpoch = epoch ? epoch - ageMs / 1000 : 0;
+      h.first  = srcIdx / LOG_ECG_DECIM;
+      h.rate   = LOG_ECG_HZ;
+      _ecgW.beginEcg(_ecgBuf, h);
+    }
+    if (_ecgW.addEcg(s)) return;
+    _store(_ecgW);                            // full: the sample opens the next block
+  }
+}
+
+void FlashLog::pollEcg() {
+  if (!_ok || !_ecg) return;
+  STAT_SCOPE(STAT_LOG);
+  int16_t tmp[64];
+  for (;;) {
+    uint64_t first = 0;
+    size_t n = _ecg->readSince(_ecgNext, tmp, 64, first);
+    if (!n) break;
+    if (first != _ecgNext) {                  // lapped by the ring: end the block at the gap
+      _ecgGaps++;
+      _decN = 0;
+      if (_ecgW.active()) _store(_ecgW);
+    }
+    for (size_t i = 0; i < n; i++) {
+      uint64_t idx = first + i;
+      // groups start on multiples of the decimation, so indices stay exact
+      if (_decN == 0) {
+        if (idx % LOG_ECG_DECIM) continue;
+        _decFirst = idx;
+        _decSum = 0;
+      }
+      _decSum += tmp[i];
+      if (++_decN == LOG_ECG_DECIM) {
+        _pushEcg((int16_t)(_decSum / LOG_ECG_DECIM), _decFirst);
+        _decN = 0;
+      }
+    }
+    _ecgNext = first + n;
+  }
+}
+
+void FlashLog::addVitals(const LogVitals& v) {
+  if (!_ok) return;
+  STAT_SCOPE(STAT_LOG);
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (!_vitW.active()) {
+      LogBlockHeader h;
+      h.bootId = _bootId;
+      h.tMs    = millis();
+      h.tEpoch = _epochNow();
+      h.rate   = 1;
+      _vitW.beginVitals(_vitBuf, h);
+    }
+    if (_vitW.addVitals(v)) return;
+    _store(_vitW);
+  }
+}
+
+void FlashLog::flush() {
+  if (!_ok) return;
+  if (_ecgW.active() && _ecgW.count()) _store(_ecgW);
+  if (_vitW.active() && _vitW.count()) _store(_vitW);
+}
+
+static bool overlaps(const LogBlockHeader& h, uint32_t from, uint32_t to) {
+  if (!h.tEpoch) return from == 0;
+  uint32_t span = h.type == LOG_TYPE_ECG ? (h.rate ? h.count / h.rate : 0) : h.count;
+  return h.tEpoch + span >= from && h.tEpoch <= to;
+}
+
+size_t FlashLog::readRange(uint32_t fromEpoch, uint32_t toEpoch, Sink sink, void* ctx) {
+  if (!_ok) return 0;
+  uint8_t buf[512];
+  size_t sent = 0;
+  char path[24];
+  for (int i = 0; i < _nSegs; i++) {
+    _path(path, sizeof(path), _segs[i]);
+    File f = LittleFS.open(path, FILE_READ);
+    if (!f) continue;
+    size_t blocks = f.size() / LOG_BLOCK_BYTES;
+    for (size_t b = 0; b < blocks; b++) {
+      LogBlockHeader h;
+      f.seek(b * LOG_BLOCK_BYTES);
+      if (f.read(buf, LOG_HDR_BYTES) != LOG_HDR_BYTES) break;
+      if (!logReadHeader(buf, LOG_HDR_BYTES, h) || !overlaps(h, fromEpoch, toEpoch)) continue;
+      sink(ctx, buf, LOG_HDR_BYTES);
+      for (size_t off = LOG_HDR_BYTES; off < LOG_BLOCK_BYTES; ) {
+        size_t m = LOG_BLOCK_BYTES - off < sizeof(buf) ? LOG_BLOCK_BYTES - off : sizeof(buf);
+        if (f.read(buf, m) != m) memset(buf, 0, m);   // keep the stream block-aligned
+        sink(ctx, buf, m);
+        off += m;
+      }
+      sent++;
+    }
+  }
+  return sent;
+}
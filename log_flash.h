@@ -0,0 +1,83 @@
+// log_flash.h
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include "config.h"
+#include "log_block.h"
+#include "sensor_ad8232.h"
+
+// Rotating time-series log on LittleFS: filtered ECG (decimated to
+// LOG_ECG_HZ) and 1 Hz vitals, in 4 KB blocks (log_block.h).
+// Blocks are built in RAM and appended whole to segment files of
+// LOG_SEG_BLOCKS blocks, so every flash sector is erased once per fill and
+// nothing is rewritten in place; when space runs low the oldest segment is
+// deleted. Blocks still open in RAM (up to ~30 s of ECG, ~8 min of vitals)
+// are lost on power-off unless flush() is called.
+// Runs on the loop() scheduler, like the web server that reads it back.
+class FlashLog {
+public:
+  bool begin(AD8232Sensor* ecg, uint32_t bootId);
+  bool ready() const { return _ok; }
+
+  void pollEcg();                          // pull new ECG from the ring
+  void addVitals(const LogVitals& v);      // call at 1 Hz
+  void flush();                            // store open blocks now
+
+  // Streams whole stored blocks overlapping [fromEpoch, toEpoch] (unix
+  // seconds) to sink, reading the files in small chunks. Blocks logged
+  // before the clock was set have no wall time and are only included when
+  // fromEpoch is 0. Returns the number of blocks sent.
+  typedef void (*Sink)(void* ctx, const uint8_t* data, size_t len);
+  size_t readRange(uint32_t fromEpoch, uint32_t toEpoch, Sink sink, void* ctx);
+
+  // Stats for /api/log/info
+  int      segments() const    { return _nSegs; }
+  uint32_t firstSeq() const    { return _nSegs ? _segs[0] : _nextSeq; }
+  uint32_t nextSeq() const     { return _nextSeq; }
+  size_t   usedBytes() const;
+  size_t   totalBytes() const;
+  uint32_t blocksWritten() const { return _written; }
+  uint32_t writeErrors() const   { return _writeErrors; }
+  uint32_t ecgGaps() const       { return _ecgGaps; }
+  uint32_t maxWriteUs() const    { return _maxWriteUs; }
+  // ECG bits per logged sample over this boot (payload only)
+  float    ecgBitsPerSample() const {
+    return _ecgSamples ? (float)((double)_ecgPayload * 8.0 / _ecgSamples) : 0.0f;
+  }
+
+private:
+  static const int      MAX_SEGS  = 64;
+  static const uint32_t SEG_BYTES = LOG_SEG_BLOCKS * LOG_BLOCK_BYTES;
+
+  AD8232Sensor*  _ecg = nullptr;
+  bool           _ok = false;
+  uint32_t       _bootId = 0;
+  uint32_t       _nextSeq = 0;
+
+  // segment files, oldest first, named by the seq of their first block
+  uint32_t       _segs[MAX_SEGS];
+  int            _nSegs = 0;
+  uint32_t       _segBlocks = 0;           // blocks in the newest segment
+
+  // open blocks
+  uint8_t        _ecgBuf[LOG_BLOCK_BYTES];
+  uint8_t        _vitBuf[LOG_BLOCK_BYTES];
+  LogBlockWriter _ecgW, _vitW;
+
+  // ECG input; each logged sample is the mean of ECG_SAMPLE_HZ/LOG_ECG_HZ
+  uint64_t       _ecgNext = 0;            // next ring index to read
+  int32_t        _decSum = 0;
+  int            _decN = 0;
+  uint64_t       _decFirst = 0;
+
+  uint32_t       _written = 0, _writeErrors = 0, _ecgGaps = 0, _maxWriteUs = 0;
+  uint64_t       _ecgSamples = 0, _ecgPayload = 0;
+
+  void     _pushEcg(int16_t s, uint64_t srcIdx);
+  void     _store(LogBlockWriter& w);
+  bool     _write(const uint8_t* blk, uint32_t seq);
+  void     _rotate(uint32_t seq);
+  void     _scan();
+  static void     _path(char* out, size_t n, uint32_t seq);
+  static uint32_t _epochNow();
+};
@@ -1,41 +1,216 @@
 #include "net_ble.h"
+#include "util_jsonw.h"
+#include "net_json.h"
+#include "util_stats.h"
 
 #ifdef ENABLE_BLE
 
-// Simple GATT: Service UUID and characteristic UUID (custom 128-bit UUIDs)
+// Legacy JSON metrics: custom 128-bit UUIDs
 static const char* SVC_UUID = "a7c9b9b8-6a7e-4f2f-9f9c-2b1a3d8c1234";
 static const char* CHR_UUID = "b1e2c3d4-5a6b-7081-92a3-b4c5d6e7f890";
+static const char* ECG_UUID = "b1e2c3d4-5a6b-7081-92a3-b4c5d6e7f891";
+
+// Bluetooth SIG assigned numbers
+static const uint16_t UUID_HRS       = 0x180D;   // Heart Rate
+static const uint16_t UUID_HRM       = 0x2A37;   //   Heart Rate Measurement
+static const uint16_t UUID_BSL       = 0x2A38;   //   Body Sensor Location
+static const uint16_t UUID_PLXS      = 0x1822;   // Pulse Oximeter
+static const uint16_t UUID_PLX_CONT  = 0x2A5F;   //   PLX Continuous Measurement
+static const uint16_t UUID_PLX_FEAT  = 0x2A60;   //   PLX Features
+static const uint16_t UUID_HTS       = 0x1809;   // Health Thermometer
+static const uint16_t UUID_TEMP      = 0x2A1C;   //   Temperature Measurement
+static const uint16_t UUID_TEMP_TYPE = 0x2A1D;   //   Temperature Type
+
+// IEEE 11073 SFLOAT: 4-bit exponent, 12-bit mantissa (0x07FF = NaN)
+static uint16_t sfloat(float v, int decimals) {
+  if (isnan(v)) return 0x07FF;
+  int32_t m = lroundf(v * powf(10.0f, (float)decimals));
+  int e = -decimals;
+  while ((m > 2045 || m < -2045) && e < 7) { m /= 10; e++; }   // +-2046.. are reserved
+  return (uint16_t)(((e & 0x0F) << 12) | (m & 0x0FFF));
+}
+
+// IEEE 11073 FLOAT: 8-bit exponent, 24-bit mantissa
+static uint32_t float32(float v, int decimals) {
+  if (isnan(v)) return 0x007FFFFF;
+  int32_t m = lroundf(v * powf(10.0f, (float)decimals));
+  return ((uint32_t)(uint8_t)(-decimals) << 24) | ((uint32_t)m & 0x00FFFFFF);
+}
+
+static inline uint8_t* put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); return p + 2; }
+
+static BLEMetrics* s_ble = nullptr;            // for the GAP handler
+
+// Connection bookkeeping; asks for a short interval and the 2M PHY so a
+// 500 Hz ECG fits comfortably (the central may refuse either).
+class BLEMetricsCallbacks : public BLEServerCallbacks {
+public:
+  explicit BLEMetricsCallbacks(BLEMetrics* m) : _m(m) {}
+  void onConnect(BLEServer* server, esp_ble_gatts_cb_param_t* param) override {
+    _m->_connId = param->connect.conn_id;
+    _m->_connIntervalMs = (uint16_t)(param->connect.conn_params.interval * 5 / 4);
+    _m->_connected = true;
+    server->updateConnParams(param->connect.remote_bda, 6, 12, 0, 400);   // 7.5-15 ms
+#ifdef CONFIG_BT_BLE_50_FEATURES_SUPPORTED
+    esp_ble_gap_set_preferred_phy(param->connect.remote_bda, 0,
+                                  ESP_BLE_GAP_PHY_2M_PREF_MASK, ESP_BLE_GAP_PHY_2M_PREF_MASK,
+                                  ESP_BLE_GAP_PHY_OPTIONS_NO_PREF);
+#endif
+  }
+  void onDisconnect(BLEServer*) override { _m->_connected = false; }
+
+  // tracks the interval after parameter updates
+  static void onGap(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t* param) {
+    if (event == ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT && s_ble &&
+        param->update_conn_params.status == ESP_BT_STATUS_SUCCESS)
+      s_ble->_connIntervalMs = (uint16_t)(param->update_conn_params.conn_int * 5 / 4);
+  }
+private:
+  BLEMetrics* _m;
+};
 
 void BLEMetrics::begin(const char* deviceName) {
+  s_ble = this;
   BLEDevice::init(deviceName);
+  BLEDevice::setMTU(BLE_MTU);                  // the central picks the final MTU
+  BLEDevice::setCustomGapHandler(BLEMetricsCallbacks::onGap);
   _server = BLEDevice::createServer();
-  _svc    = _server->createService(SVC_UUID);
-  _ch     = _svc->createCharacteristic(
+  _server->setCallbacks(new BLEMetricsCallbacks(this));
+
+  // Heart Rate: measurement (notify) + body sensor location (read)
+  BLEService* hrs = _server->createService(BLEUUID(UUID_HRS));
+  _hrm.ch = hrs->createCharacteristic(BLEUUID(UUID_HRM), BLECharacteristic::PROPERTY_NOTIFY);
+  _hrm.ch->addDescriptor(new BLE2902());
+  BLECharacteristic* bsl = hrs->createCharacteristic(BLEUUID(UUID_BSL), BLECharacteristic::PROPERTY_READ);
+  uint8_t loc = _ecg ? 1 : 3;                  // chest (ECG) or finger
+  bsl->setValue(&loc, 1);
+  hrs->start();
+
+  // Pulse Oximeter: continuous measurement (notify) + features (read)
+  BLEService* plxs = _server->createService(BLEUUID(UUID_PLXS));
+  _plx.ch = plxs->createCharacteristic(BLEUUID(UUID_PLX_CONT), BLECharacteristic::PROPERTY_NOTIFY);
+  _plx.ch->addDescriptor(new BLE2902());
+  BLECharacteristic* feat = plxs->createCharacteristic(BLEUUID(UUID_PLX_FEAT), BLECharacteristic::PROPERTY_READ);
+  uint8_t features[2];
+  put16(features, 0x0040);                     // pulse amplitude index supported
+  feat->setValue(features, 2);
+  plxs->start();
+
+  // Health Thermometer: measurement (indicate) + type (read)
+  BLEService* hts = _server->createService(BLEUUID(UUID_HTS));
+  _temp.ch = hts->createCharacteristic(BLEUUID(UUID_TEMP), BLECharacteristic::PROPERTY_INDICATE);
+  _temp.ch->addDescriptor(new BLE2902());
+  _temp.indicate = true;
+  BLECharacteristic* ttype = hts->createCharacteristic(BLEUUID(UUID_TEMP_TYPE), BLECharacteristic::PROPERTY_READ);
+  uint8_t type = 2;                            // body (general)
+  ttype->setValue(&type, 1);
+  hts->start();
+
+  // Legacy JSON
+  BLEService* svc = _server->createService(SVC_UUID);
+  _json.ch = svc->createCharacteristic(
       CHR_UUID,
       BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY);
-  _ch->addDescriptor(new BLE2902());
-  _svc->start();
+  _json.ch->addDescriptor(new BLE2902());
+#ifdef ENABLE_AD8232
+  _ecgCh = svc->createCharacteristic(ECG_UUID, BLECharacteristic::PROPERTY_NOTIFY);
+  _ecgCccd = new BLE2902();
+  _ecgCh->addDescriptor(_ecgCccd);
+#endif
+  svc->start();
+
+  // Name goes in the scan response so the 16-bit UUIDs and the JSON
+  // service fit in the 31-byte advertisement.
   BLEAdvertising* adv = BLEDevice::getAdvertising();
+  adv->addServiceUUID(BLEUUID(UUID_HRS));
+  adv->addServiceUUID(BLEUUID(UUID_PLXS));
+  adv->addServiceUUID(BLEUUID(UUID_HTS));
   adv->addServiceUUID(SVC_UUID);
-  adv->setScanResponse(false);
+  adv->setScanResponse(true);
   adv->setMinPreferred(0x06);  // functions that help with iPhone connections issue
   adv->setMinPreferred(0x12);
   BLEDevice::startAdvertising();
 }
 
-void BLEMetrics::handle() {
-  uint32_t now = millis();
-  if (now - _lastNotifyMs < NOTIFY_PERIOD_MS) return;
-  _lastNotifyMs = now;
+// New R-R intervals from the QRS detector, oldest dropped when not sent.
+void BLEMetrics::_collectRr() {
+#ifdef ENABLE_AD8232
+  if (!_ecg) return;
+  QrsBeat beats[RR_MAX];
+  uint64_t first = 0;
+  size_t got = _ecg->readBeats(_beatSeq, beats, RR_MAX, first);
+  _beatSeq = first + got;
+  for (size_t i = 0; i < got; i++) {
+    if (!beats[i].rrMs) continue;
+    if (_rrCount == RR_MAX) { memmove(_rr, _rr + 1, sizeof(_rr[0]) * (RR_MAX - 1)); _rrCount--; }
+    _rr[_rrCount++] = (uint16_t)(((uint32_t)beats[i].rrMs * 1024 + 500) / 1000);
+  }
+#endif
+}
 
-  if (!_ch) return;
+// Heart Rate Measurement: flags, u8 bpm, u16 R-R (1/1024 s)...
+// ECG rate and contact when the leads are on, else the optical pulse.
+size_t BLEMetrics::_packHeartRate(uint8_t* out) {
+  int bpm = -1;
+  bool contact = false;
+#ifdef ENABLE_AD8232
+  if (_ecg && !_ecg->leadsOff()) {
+    contact = true;
+    if (_ecg->ecgBpm() > 0) bpm = _ecg->ecgBpm();
+  }
+#endif
+#ifdef ENABLE_MAX30102
+  if (bpm < 0 && _spo2 && _spo2->hasFinger()) {
+    contact = true;
+    bpm = _spo2->bpmRounded();
+  }
+#endif
+  uint8_t flags = 0x04 | (contact ? 0x02 : 0);   // contact supported / detected
+  if (_rrCount) flags |= 0x10;
+  out[0] = flags;
+  out[1] = (uint8_t)(bpm > 0 ? (bpm > 255 ? 255 : bpm) : 0);
+  uint8_t* p = out + 2;
+  for (int i = 0; i < _rrCount; i++) p = put16(p, _rr[i]);
+  return p - out;
+}
 
-  // Compose a compact JSON payload (keep under MTU ~ 185 for BLE)
-  // {"pulse":78,"spo2":97,"pi":3.2,"tempC":36.6}
+// PLX Continuous Measurement: flags, SpO2, PR, pulse amplitude index (SFLOAT)
+size_t BLEMetrics::_packPlx(uint8_t* out) {
+  float o2 = NAN, pr = NAN, pi = NAN;
+#ifdef ENABLE_MAX30102
+  if (_spo2 && _spo2->hasFinger()) {
+    if (_spo2->spo2Rounded() > 0) o2 = (float)_spo2->spo2Rounded();
+    if (_spo2->bpmRounded() > 0)  pr = (float)_spo2->bpmRounded();
+    pi = _spo2->perfusionIndex();
+  }
+#endif
+  out[0] = 0x10;                               // pulse amplitude index present
+  uint8_t* p = out + 1;
+  p = put16(p, sfloat(o2, 0));
+  p = put16(p, sfloat(pr, 0));
+  p = put16(p, sfloat(pi, 1));
+  return p - out;
+}
+
+// Temperature Measurement: flags (Celsius), FLOAT; nothing without a probe
+size_t BLEMetrics::_packTemp(uint8_t* out) {
+#ifdef ENABLE_MAX30205
+  if (_tp && _tp->hasTemp()) {
+    out[0] = 0x00;
+    uint32_t t = float32(_tp->tempC(), 1);
+    memcpy(out + 1, &t, 4);                    // little-endian target
+    return 5;
+  }
+#endif
+  return 0;
+}
+
+// net_json.h jsonBleMetrics(), null when not valid
+size_t BLEMetrics::_packJson(uint8_t* out, size_t cap) {
   int bpm = -1;
   int o2  = -1;
   float pi = 0.0f;
-  bool hasFinger = false;
+  int sqi = 0;
   bool hasTemp = false;
   float tempC = NAN;
 
@@ -44,7 +219,7 @@ void BLEMetrics::handle() {
     bpm = _spo2->bpmRounded();
     o2  = _spo2->spo2Rounded();
     pi  = _spo2->perfusionIndex();
-    hasFinger = _spo2->hasFinger();
+    sqi = _spo2->signalQuality();
   }
 #endif
 #ifdef ENABLE_MAX30205
@@ -55,14 +230,115 @@ void BLEMetrics::handle() {
 #endif
 
   char buf[96];
-  int n = snprintf(buf, sizeof(buf),
-                   "{\"pulse\":%d,\"spo2\":%d,\"pi\":%.2f,\"tempC\":%.2f}",
-                   bpm, o2, pi, hasTemp ? tempC : NAN);
-  if (n < 0) return;
-  _ch->setValue((uint8_t*)buf, (size_t)min(n, (int)sizeof(buf)));
-  _ch->notify();
+  JsonWriter j(buf, sizeof(buf));
+  jsonBleMetrics(j, bpm, o2, pi, hasTemp ? tempC : NAN, sqi);
+  if (j.overflow() || j.length() > cap) return 0;
+  memcpy(out, buf, j.length());
+  return j.length();
 }
 
-#endif // ENABLE_BLE
+// Sends v if it differs from the last send, or as a heartbeat.
+bool BLEMetrics::_publish(Chr& c, const uint8_t* v, size_t n, uint32_t now) {
+  if (!c.ch || n == 0 || n > sizeof(c.last)) return false;
+  bool changed = !c.sent || n != c.len || memcmp(v, c.last, n) != 0;
+  uint32_t since = now - c.lastMs;
+  if (c.sent && (changed ? since < BLE_MIN_NOTIFY_MS : since < BLE_HEARTBEAT_MS)) return false;
+  c.ch->setValue((uint8_t*)v, n);
+  if (c.indicate) c.ch->indicate(); else c.ch->notify();
+  memcpy(c.last, v, n);
+  c.len = (uint8_t)n;
+  c.lastMs = now;
+  c.sent = true;
+  return true;
+}
+
+// Samples per ECG frame: what one notification carries at the current MTU.
+size_t BLEMetrics::_ecgFrameSamples() const {
+  uint16_t mtu = _server->getPeerMTU(_connId);
+  size_t payload = (mtu > 23 ? mtu : 23) - 3;
+  if (payload > ECG_FRAME) payload = ECG_FRAME;   // ATT value limit
+  size_t n = (payload - ECG_HDR) / 3 * 2;
+  return n < ECG_MAX_SAMPLES ? n : ECG_MAX_SAMPLES;
+}
+
+// ECG frame: u32 first sample index (low bits of the ring index), u16 fs,
+// u16 samples skipped because the link fell behind, u16 acquisition
+// drops (both cumulative, wrapping), u8 count, u8 flags (bit0 leads off),
+// then 12-bit two's complement samples packed two per 3 bytes:
+// s0[7:0], s0[11:8] | s1[3:0] << 4, s1[11:4].
+// Frames go out once a frame's worth has accumulated, or every two
+// connection intervals (at least 20 ms), up to BLE_ECG_MAX_FRAMES per call.
+void BLEMetrics::pumpEcg() {
+#ifdef ENABLE_AD8232
+  STAT_SCOPE(STAT_BLE);
+  if (!_ecgCh || !_ecg || !_connected || !_ecgCccd->getNotifications()) {
+    _ecgActive = false;
+    return;
+  }
+  uint32_t now = millis();
+  if (!_ecgActive) {                           // new subscriber: start live
+    _ecgNext = _ecg->sampleIndex();
+    _ecgLastMs = now;
+    _ecgActive = true;
+    return;
+  }
+  size_t perFrame = _ecgFrameSamples();
+  uint32_t batchMs = 2u * _connIntervalMs;
+  if (batchMs < 20) batchMs = 20;
+  if (_ecg->sampleIndex() - _ecgNext < perFrame && now - _ecgLastMs < batchMs) return;
+
+  int16_t s[ECG_MAX_SAMPLES];
+  bool off = _ecg->leadsOff();
+  for (int f = 0; f < BLE_ECG_MAX_FRAMES; f++) {
+    uint64_t first = 0;
+    size_t n = _ecg->readSince(_ecgNext, s, perFrame, first);
+    if (!n) break;
+    if (first != _ecgNext) { _ecgGaps++; _ecgLost += (uint32_t)(first - _ecgNext); }
+    _ecgNext = first + n;
 
+    uint8_t* p = _ecgFrame;
+    uint32_t f32 = (uint32_t)first;
+    p = put16(p, (uint16_t)f32);
+    p = put16(p, (uint16_t)(f32 >> 16));
+    p = put16(p, (uint16_t)_ecg->sampleRate());
+    p = put16(p, (uint16_t)_ecgLost);
+    p = put16(p, (uint16_t)_ecg->droppedSamples());
+    *p++ = (uint8_t)n;
+    *p++ = off ? 0x01 : 0;
+    for (size_t i = 0; i < n; i += 2) {
+      uint16_t a = (uint16_t)(constrain(s[i], -2048, 2047) & 0x0FFF);
+      uint16_t b = i + 1 < n ? (uint16_t)(constrain(s[i + 1], -2048, 2047) & 0x0FFF) : 0;
+      *p++ = (uint8_t)a;
+      *p++ = (uint8_t)((a >> 8) | (b << 4));
+      *p++ = (uint8_t)(b >> 4);
+    }
+    _ecgCh->setValue(_ecgFrame, p - _ecgFrame);
+    _ecgCh->notify();
+    _ecgFrames++;
+    if (n < perFrame) break;
+  }
+  _ecgLastMs = now;
+#endif
+}
 
+void BLEMetrics::handle() {
+  if (!_server) return;
+  STAT_SCOPE(STAT_BLE);
+  _collectRr();
+  if (_server->getConnectedCount() == 0) {
+    _rrCount = 0;
+    _hrm.sent = _plx.sent = _temp.sent = _json.sent = false;   // fresh values on connect
+    return;
+  }
+
+  uint32_t now = millis();
+  uint8_t buf[20];
+  if (_publish(_hrm, buf, _packHeartRate(buf), now)) _rrCount = 0;
+  _publish(_plx,  buf, _packPlx(buf), now);
+  _publish(_temp, buf, _packTemp(buf), now);
+
+  uint8_t js[96];
+  _publish(_json, js, _packJson(js, sizeof(js)), now);
+}
+
+#endif // ENABLE_BLE
@@ -10,29 +10,82 @@
 
 #include "sensor_max30102.h"
 #include "sensor_max30205.h"
+#include "sensor_ad8232.h"
 
+// BLE GATT server with the Bluetooth SIG services standard apps understand:
+// Heart Rate (0x180D, with R-R intervals from the ECG), Pulse Oximeter
+// (0x1822) and Health Thermometer (0x1809), plus the legacy JSON
+// characteristic. Values are packed once per handle() call and only go out
+// when they changed (at most every BLE_MIN_NOTIFY_MS) or when
+// BLE_HEARTBEAT_MS has passed since the last send.
 class BLEMetrics {
 public:
-  void attachSensors(Max30102Sensor* spo2, Max30205Sensor* tprobe) {
+  void attachSensors(Max30102Sensor* spo2, Max30205Sensor* tprobe,
+                     AD8232Sensor* ecg = nullptr) {
     _spo2 = spo2;
     _tp   = tprobe;
+    _ecg  = ecg;
   }
 
   void begin(const char* deviceName);
-  void handle();
+  void handle();                 // scheduled every BLE_POLL_MS
+  void pumpEcg();                // ECG waveform notifies, every BLE_ECG_PERIOD_MS
+
+  // ECG stream health since boot
+  uint32_t ecgFrames() const { return _ecgFrames; }
+  uint32_t ecgGaps() const   { return _ecgGaps; }
+  uint32_t ecgLost() const   { return _ecgLost; }
 
 private:
+  // A notifying characteristic and what it last sent
+  struct Chr {
+    BLECharacteristic* ch = nullptr;
+    bool     indicate = false;
+    uint8_t  last[96];               // fits the legacy JSON
+    uint8_t  len = 0;
+    uint32_t lastMs = 0;
+    bool     sent = false;
+  };
+
   Max30102Sensor* _spo2 = nullptr;
   Max30205Sensor* _tp   = nullptr;
+  AD8232Sensor*   _ecg  = nullptr;
 
   BLEServer*      _server = nullptr;
-  BLEService*     _svc    = nullptr;
-  BLECharacteristic* _ch  = nullptr;
+  Chr             _json, _hrm, _plx, _temp;
 
-  uint32_t _lastNotifyMs = 0;
-  static constexpr uint32_t NOTIFY_PERIOD_MS = 1000; // 1 Hz updates
-};
+  // ECG waveform: 12-bit samples, two per 3 bytes, sent in MTU-sized
+  // frames about every two connection intervals (see net_ble.cpp).
+  static const size_t ECG_HDR   = 12;
+  static const size_t ECG_FRAME = 512;            // max attribute value
+  static const size_t ECG_MAX_SAMPLES = 254;      // u8 count, even
+  BLECharacteristic* _ecgCh = nullptr;
+  BLE2902*        _ecgCccd = nullptr;
+  uint8_t         _ecgFrame[ECG_HDR + ECG_MAX_SAMPLES / 2 * 3];
+  bool            _ecgActive = false;
+  uint64_t        _ecgNext = 0;
+  uint32_t        _ecgLastMs = 0;
+  uint32_t        _ecgFrames = 0, _ecgGaps = 0, _ecgLost = 0;
 
-#endif // ENABLE_BLE
+  friend class BLEMetricsCallbacks;
+  volatile bool     _connected = false;
+  volatile uint16_t _connId = 0;
+  volatile uint16_t _connIntervalMs = 30;      // updated by the stack
 
+  size_t _ecgFrameSamples() const;
 
+  // R-R intervals (1/1024 s) not yet sent in a Heart Rate Measurement
+  static const int RR_MAX = 8;
+  uint16_t        _rr[RR_MAX];
+  int             _rrCount = 0;
+  uint64_t        _beatSeq = 0;
+
+  void   _collectRr();
+  size_t _packHeartRate(uint8_t* out);
+  size_t _packPlx(uint8_t* out);
+  size_t _packTemp(uint8_t* out);
+  size_t _packJson(uint8_t* out, size_t cap);
+  bool   _publish(Chr& c, const uint8_t* v, size_t n, uint32_t now);
+};
+
+#endif // ENABLE_BLE
@@ -0,0 +1,101 @@
+// net_json.cpp
+#include "net_json.h"
+#include <math.h>
+#include "sensor_max30102.h"
+#include "sensor_max30205.h"
+#include "sensor_ad8232.h"
+
+void jsonMetrics(JsonWriter& j, const Max30102Sensor* spo2, const Max30205Sensor* tp,
+                 const AD8232Sensor* ecg) {
+  j.beginObject();
+  if (spo2) {
+    j.key("pulse").intOrNull(spo2->bpmRounded());
+    j.key("pulseConf").value(spo2->pulseConfidence(), 2);
+    j.key("spo2").intOrNull(spo2->spo2Rounded());
+    j.key("sqi").value(spo2->signalQuality());
+    j.key("pi").value(spo2->perfusionIndex(), 1);
+    j.key("finger").value(spo2->hasFinger());
+  } else {
+    j.key("pulse").null().key("pulseConf").value(0).key("spo2").null().key("sqi").value(0).key("pi").value(0).key("finger").value(false);
+  }
+
+  j.key("tempC");
+  if (tp && tp->hasTemp()) j.value(tp->tempC(), 1); else j.null();
+
+  int ebpm = ecg ? ecg->ecgBpm() : 0;
+  j.key("ecgBpm").intOrNull(ebpm > 0 ? ebpm : -1);
+  j.key("rrMs").intOrNull(ebpm > 0 ? (int)ecg->lastRrMs() : -1);
+  j.endObject();
+}
+
+void jsonEcg(JsonWriter& j, int fs, bool off, uint32_t dropped, uint64_t first,
+             const int16_t* samples, size_t n) {
+  j.beginObject();
+  j.key("fs").value(fs);
+  j.key("off").value(off);
+  j.key("dropped").value(dropped);
+  j.key("seq").value((unsigned long long)first);
+  j.key("next").value((unsigned long long)(first + n));
+  j.key("samples").beginArray();
+  for (size_t i=0;i<n;i++) j.value((int)samples[i]);
+  j.endArray().endObject();
+}
+
+void jsonBeats(JsonWriter& j, int fs, uint64_t first, const QrsBeat* beats, size_t n) {
+  j.beginObject();
+  j.key("fs").value(fs);
+  j.key("seq").value((unsigned long long)first);
+  j.key("next").value((unsigned long long)(first + n));
+  j.key("beats").beginArray();
+  for (size_t i=0;i<n;i++)
+    j.beginArray().value((unsigned long long)beats[i].sample).value((unsigned)beats[i].rrMs).endArray();
+  j.endArray().endObject();
+}
+
+void jsonEcgEvent(JsonWriter& j, int fs, uint64_t first, bool off,
+                  const int16_t* samples, size_t n) {
+  j.beginObject();
+  j.key("fs").value(fs);
+  j.key("seq").value((unsigned long long)first);
+  j.key("off").value(off);
+  j.key("s").beginArray();
+  for (size_t k=0;k<n;k++) j.value((int)samples[k]);
+  j.endArray().endObject();
+}
+
+void jsonI2C(JsonWriter& j, const I2CBus& bus, long oledBytesPerSec) {
+  I2CBus::DevStats st[I2CBus::DEV_COUNT];
+  for (int d=0; d<I2CBus::DEV_COUNT; d++) st[d] = bus.stats((I2CBus::Dev)d);
+  jsonI2C(j, bus.clockHz(), bus.busyFraction() * 100.0f, oledBytesPerSec, st, I2CBus::DEV_COUNT);
+}
+
+void jsonI2C(JsonWriter& j, uint32_t hz, float busyPct, long oledBytesPerSec,
+             const I2CBus::DevStats* st, int n) {
+  j.beginObject();
+  j.key("hz").value((unsigned long)hz);
+  j.key("busy").value(busyPct, 1);
+  if (oledBytesPerSec >= 0) j.key("oledBytesPerSec").value((unsigned long)oledBytesPerSec);
+  j.key("devices").beginArray();
+  for (int d=0; d<n; d++) {
+    const I2CBus::DevStats& s = st[d];
+    j.beginObject();
+    j.key("name").value(I2CBus::devName((I2CBus::Dev)d));
+    j.key("txns").value((unsigned long)s.txns);
+    j.key("bytes").value((unsigned long)s.bytes);
+    j.key("errors").value((unsigned long)s.errors);
+    j.key("busyUs").value((unsigned long long)s.busyUs);
+    j.endObject();
+  }
+  j.endArray().endObject();
+}
+
+// {"pulse":78,"spo2":97,"pi":3.20,"tempC":36.60,"sqi":92}, null when not valid
+void jsonBleMetrics(JsonWriter& j, int pulse, int spo2, float pi, float tempC, int sqi) {
+  j.beginObject();
+  j.key("pulse").intOrNull(pulse);
+  j.key("spo2").intOrNull(spo2);
+  j.key("pi").value(pi, 2);
+  j.key("tempC").floatOrNull(tempC, 2);
+  j.key("sqi").value(sqi);
+  j.endObject();
+}
@@ -0,0 +1,36 @@
+// net_json.h
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "util_jsonw.h"
+#include "dsp_qrs.h"
+#include "util_i2cbus.h"
+
+class Max30102Sensor;
+class Max30205Sensor;
+class AD8232Sensor;
+
+// JSON bodies of the HTTP API and the BLE metrics characteristic, written
+// into a caller's JsonWriter. Kept apart from WiFiWeb/BLEMetrics so the
+// host build can check them (tests/test_json_alloc.cpp: no heap use).
+// Missing sensors (nullptr) give null / 0 fields.
+
+// /api/metrics
+void jsonMetrics(JsonWriter& j, const Max30102Sensor* spo2, const Max30205Sensor* tp,
+                 const AD8232Sensor* ecg);
+// /api/ecg: samples[0..n) start at sample index first
+void jsonEcg(JsonWriter& j, int fs, bool off, uint32_t dropped, uint64_t first,
+             const int16_t* samples, size_t n);
+// /api/beats: beats[0..n) start at beat index first
+void jsonBeats(JsonWriter& j, int fs, uint64_t first, const QrsBeat* beats, size_t n);
+// data of one /api/ecg/stream event
+void jsonEcgEvent(JsonWriter& j, int fs, uint64_t first, bool off,
+                  const int16_t* samples, size_t n);
+// /api/i2c: per-device counters of the shared bus; oledBytesPerSec < 0 =
+// no display. Long-running counters make this body grow, so the handler
+// streams it.
+void jsonI2C(JsonWriter& j, const I2CBus& bus, long oledBytesPerSec);
+void jsonI2C(JsonWriter& j, uint32_t hz, float busyPct, long oledBytesPerSec,
+             const I2CBus::DevStats* st, int n);
+// BLE metrics characteristic; -1 / NaN = not valid
+void jsonBleMetrics(JsonWriter& j, int pulse, int spo2, float pi, float tempC, int sqi);
@@ -1,10 +1,13 @@
 // net_ota.cpp
 #include "net_ota.h"
-#include <ESPmDNS.h>
+#include "util_stats.h"
 
 void OTAUpdater::begin(const char* hostname, const char* password){
   ArduinoOTA.setHostname(hostname);
-  if (password && password[0]) ArduinoOTA.setPassword(password);
+  ArduinoOTA.setPort(PORT);
+  ArduinoOTA.setMdnsEnabled(false);          // WiFiConn runs mDNS
+  _auth = password && password[0];
+  if (_auth) ArduinoOTA.setPassword(password);
   ArduinoOTA
     .onStart([](){ Serial.println("OTA Start"); })
     .onEnd([](){ Serial.println("OTA End"); })
@@ -13,7 +16,15 @@ void OTAUpdater::begin(const char* hostname, const char* password){
       if (pct!=last){ last=pct; Serial.printf("OTA %u%%\n", pct); }
     })
     .onError([](ota_error_t e){ Serial.printf("OTA Error[%u]\n", e); });
+}
+void OTAUpdater::start(){
+  if (_started) return;
+  _started = true;
   ArduinoOTA.begin();
   Serial.println("OTA ready");
 }
-void OTAUpdater::handle(){ ArduinoOTA.handle(); }
+void OTAUpdater::handle(){
+  if (!_started) return;
+  STAT_SCOPE(STAT_OTA);
+  ArduinoOTA.handle();
+}
@@ -2,8 +2,21 @@
 #pragma once
 #include <ArduinoOTA.h>
 
+// ArduinoOTA, started by WiFiConn on the first station link or when the
+// config AP comes up (before that there is nothing to listen on); it then
+// listens on both. mDNS, including the _arduino._tcp record the IDE looks
+// for, is WiFiConn's and station-only; ArduinoOTA's own mDNS is off.
 class OTAUpdater {
 public:
-  void begin(const char* hostname, const char* password);
+  static const uint16_t PORT = 3232;
+
+  void begin(const char* hostname, const char* password);   // settings only
+  void start();                                             // once, on the first link
   void handle();
+  bool started() const { return _started; }
+  bool hasPassword() const { return _auth; }
+
+private:
+  bool _started = false;
+  bool _auth = false;
 };
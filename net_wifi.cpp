@@ -0,0 +1,146 @@
+// net_wifi.cpp
+#include "net_wifi.h"
+#include <ESPmDNS.h>
+#include "net_ota.h"
+
+void WiFiConn::begin(const char* ssid, const char* pass, const char* hostname,
+                     const char* apSsid, const char* apPass) {
+  _ssid = ssid ? ssid : "";
+  _pass = pass ? pass : "";
+  _hostname = hostname;
+  _apSsid = apSsid;
+  _apPass = apPass;
+  WiFi.persistent(false);             // credentials live in Settings
+  WiFi.onEvent([this](arduino_event_id_t e, arduino_event_info_t info) { _onEvent(e, info); });
+  _downSinceMs = millis();
+  if (!_ssid.length()) {
+    _startAP(false);
+    _enter(AP_ONLY);
+    return;
+  }
+  WiFi.setHostname(hostname);         // before the mode is set
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(false);       // we reconnect, with backoff
+  _connect();
+}
+
+// Wi-Fi task: no WiFi calls from here, just hand over to handle()
+void WiFiConn::_onEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      _evGotIp = true;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      _lastReason = info.wifi_sta_disconnected.reason;
+      _evLost = true;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+      _evLost = true;
+      break;
+    default:
+      break;
+  }
+}
+
+void WiFiConn::handle() {
+  if (_state == OFF || _state == AP_ONLY) return;
+  uint32_t now = millis();
+
+  if (_evGotIp) { _evGotIp = false; _onConnected(); }
+  if (_evLost) {
+    _evLost = false;
+    if (_state == CONNECTED) {
+      Serial.printf("Wi-Fi: link lost (reason %u)\n", _lastReason);
+      _downSinceMs = now;
+      _backoffMs = WIFI_BACKOFF_MIN_MS;
+      _enter(BACKOFF);
+    } else if (_state == CONNECTING) {
+      Serial.printf("Wi-Fi: connect failed (reason %u), retry in %lu ms\n",
+                    _lastReason, (unsigned long)_backoffMs);
+      _enter(BACKOFF);
+    }
+  }
+
+  switch (_state) {
+    case CONNECTING:
+      if (now - _stateMs >= WIFI_CONNECT_TIMEOUT_MS) {
+        Serial.printf("Wi-Fi: connect timed out, retry in %lu ms\n", (unsigned long)_backoffMs);
+        WiFi.disconnect();
+        _evLost = false;
+        _enter(BACKOFF);
+      }
+      break;
+    case BACKOFF:
+      if (now - _stateMs >= _backoffMs && !(_apUp && WiFi.softAPgetStationNum() > 0)) {
+        _backoffMs = min<uint32_t>(_backoffMs * 2, WIFI_BACKOFF_MAX_MS);
+        _connect();
+      }
+      break;
+    case CONNECTED:
+      if (_apUp && WiFi.softAPgetStationNum() == 0) _stopAP();
+      break;
+    default:
+      break;
+  }
+
+  if (!_apUp && _state != CONNECTED && now - _downSinceMs >= WIFI_AP_FALLBACK_MS) {
+    Serial.println("Wi-Fi: no link, config AP on (station keeps retrying)");
+    _startAP(true);
+  }
+}
+
+void WiFiConn::_enter(State s) {
+  _state = s;
+  _stateMs = millis();
+}
+
+void WiFiConn::_connect() {
+  Serial.printf("Wi-Fi: connecting to %s\n", _ssid.c_str());
+  WiFi.begin(_ssid.c_str(), _pass.c_str());
+  _enter(CONNECTING);
+}
+
+void WiFiConn::_onConnected() {
+  if (_online) _reconnects++;
+  _online = true;
+  _backoffMs = WIFI_BACKOFF_MIN_MS;
+  _enter(CONNECTED);
+  Serial.printf("STA IP: %s  RSSI: %d dBm\n", WiFi.localIP().toString().c_str(), WiFi.RSSI());
+  if (!_mdnsUp) {
+    _mdnsUp = true;
+    if (MDNS.begin(_hostname.c_str())) {
+      Serial.printf("mDNS: http://%s.local/\n", _hostname.c_str());
+      if (_ota) MDNS.enableArduino(OTAUpdater::PORT, _ota->hasPassword());
+    }
+    if (_ota) _ota->start();
+  }
+  // wall clock for the flash log's block timestamps
+  if (!_clockSet && NTP_SERVER[0]) {
+    configTime(0, 0, NTP_SERVER);
+    _clockSet = true;
+  }
+}
+
+void WiFiConn::_startAP(bool withSta) {
+  WiFi.mode(withSta ? WIFI_AP_STA : WIFI_AP);
+  WiFi.softAP(_apSsid.c_str(), _apPass.c_str());
+  _apUp = true;
+  Serial.printf("AP mode: %s  IP: %s\n", _apSsid.c_str(), WiFi.softAPIP().toString().c_str());
+  if (_ota) _ota->start();            // a board that never joins can still be reflashed
+}
+
+void WiFiConn::_stopAP() {
+  WiFi.softAPdisconnect(true);        // back to WIFI_STA
+  _apUp = false;
+  Serial.println("Wi-Fi: station back, config AP off");
+}
+
+const char* WiFiConn::stateName(State s) {
+  switch (s) {
+    case CONNECTING: return "connecting";
+    case CONNECTED:  return "connected";
+    case BACKOFF:    return "backoff";
+    case AP_ONLY:    return "ap";
+    default:         return "off";
+  }
+}
@@ -0,0 +1,62 @@
+// net_wifi.h
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+#include "config.h"
+
+class OTAUpdater;
+
+// Wi-Fi connection manager. Nothing here blocks: WiFi events (on the Wi-Fi
+// task) only set flags, handle() from the loop acts on them.
+//
+// With credentials the station connects in the background and, whenever
+// the link drops or an attempt fails, retries after WIFI_BACKOFF_MIN_MS,
+// doubling up to WIFI_BACKOFF_MAX_MS. After WIFI_AP_FALLBACK_MS without a
+// link the config AP comes up beside the station (AP+STA), which keeps
+// retrying, but not while someone is on the AP (a scan would disturb the
+// portal). Once the station is back and the AP is empty, the AP goes away.
+// Without credentials it is the AP only.
+// The attached OTAUpdater starts with the first link, station or config
+// AP; mDNS (hostname, plus the OTA record) only with the first station link.
+class WiFiConn {
+public:
+  enum State : uint8_t { OFF, CONNECTING, CONNECTED, BACKOFF, AP_ONLY };
+
+  // ssid empty: AP only
+  void begin(const char* ssid, const char* pass, const char* hostname,
+             const char* apSsid, const char* apPass);
+  void handle();
+  void attachOTA(OTAUpdater* ota) { _ota = ota; }
+
+  State    state() const { return _state; }
+  static const char* stateName(State s);
+  bool     connected() const { return _state == CONNECTED; }
+  bool     apActive() const { return _apUp; }
+  uint32_t reconnects() const { return _reconnects; }   // links regained after a drop
+  uint8_t  lastReason() const { return _lastReason; }   // last disconnect reason, 0 = none
+
+private:
+  String   _ssid, _pass, _hostname, _apSsid, _apPass;
+  OTAUpdater* _ota = nullptr;
+  State    _state = OFF;
+  bool     _apUp = false;
+  bool     _online = false;           // had a link since begin()
+  bool     _mdnsUp = false;
+  bool     _clockSet = false;
+  uint32_t _stateMs = 0;              // entered the current state
+  uint32_t _downSinceMs = 0;          // no link since (AP fallback)
+  uint32_t _backoffMs = WIFI_BACKOFF_MIN_MS;
+  uint32_t _reconnects = 0;
+
+  // set by the event handler, consumed by handle()
+  volatile bool    _evGotIp = false;
+  volatile bool    _evLost = false;
+  volatile uint8_t _lastReason = 0;
+
+  void _onEvent(arduino_event_id_t event, arduino_event_info_t info);
+  void _enter(State s);
+  void _connect();
+  void _onConnected();
+  void _startAP(bool withSta);
+  void _stopAP();
+};
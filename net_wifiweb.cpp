@@ -1,49 +1,26 @@
 #include "net_wifiweb.h"
 #include "settings.h"     // real definitions of Settings/WifiCreds
-#include <ESPmDNS.h>
-
-void WiFiWeb::beginAP(const char* ssid, const char* pass) {
-  WiFi.mode(WIFI_AP);
-  _apSSID = ssid;
-  WiFi.softAP(ssid, pass);
-  delay(200);
-  Serial.printf("AP mode: %s  IP: %s\n", ssid, WiFi.softAPIP().toString().c_str());
-  _setupRoutes();
-}
-
-void WiFiWeb::beginSTA(const char* ssid, const char* pass, const char* hostname) {
-  WiFi.mode(WIFI_STA);
-  WiFi.setHostname(hostname);
-  WiFi.begin(ssid, pass);
-  Serial.printf("Connecting to %s ...\n", ssid);
-  unsigned long t0 = millis();
-  while (WiFi.status()!=WL_CONNECTED && millis()-t0<15000) { delay(300); Serial.print("."); }
-  Serial.println();
-  if (WiFi.status()==WL_CONNECTED) {
-    Serial.printf("STA IP: %s\n", WiFi.localIP().toString().c_str());
-    if (MDNS.begin(hostname)) Serial.printf("mDNS: http://%s.local/\n", hostname);
-  } else {
-    Serial.println("STA failed, staying offline.");
-  }
-  _setupRoutes();
-}
+#include "net_wire.h"
+#include "util_jsonw.h"
+#include "net_json.h"
+#include "web_assets.h"
+#include "app_tasks.h"
+#include "util_stats.h"
 
 void WiFiWeb::beginAuto(Settings& settings,
                         const char* ap_ssid, const char* ap_pass,
                         const char* hostname) {
   _settings = &settings;
+  _apSSID = ap_ssid;
   WifiCreds w = settings.getWifi();
   if (w.valid) {
     Serial.printf("Saved Wi-Fi found: SSID='%s'\n", w.ssid.c_str());
-    beginSTA(w.ssid.c_str(), w.pass.c_str(), hostname);
-    if (WiFi.status()!=WL_CONNECTED) {
-      Serial.println("STA failed, falling back to AP.");
-      beginAP(ap_ssid, ap_pass);
-    }
+    _conn.begin(w.ssid.c_str(), w.pass.c_str(), hostname, ap_ssid, ap_pass);
   } else {
     Serial.println("No saved Wi-Fi; starting AP.");
-    beginAP(ap_ssid, ap_pass);
+    _conn.begin("", "", hostname, ap_ssid, ap_pass);
   }
+  _setupRoutes();
 }
 
 void WiFiWeb::attachMetricsSource(Max30102Sensor* spo2, Max30205Sensor* tprobe) {
@@ -56,36 +33,74 @@ void WiFiWeb::_setupRoutes() {
   _srv.on("/",            [this]{ _handleRoot(); });
   _srv.on("/api/metrics", [this]{ _handleMetrics(); });
   _srv.on("/api/ecg",     [this]{ _handleECG(); });
+  _srv.on("/api/beats",   [this]{ _handleBeats(); });
+  _srv.on("/api/ecg/stream", [this]{ _handleECGStream(); });
+  _srv.on("/api/tasks",   [this]{ _handleTasks(); });
+  _srv.on("/api/i2c",     [this]{ _handleI2C(); });
+  _srv.on("/api/stats",   [this]{ _handleStats(); });
+  _srv.on("/api/log",     [this]{ _handleLog(); });
+  _srv.on("/api/log/info", [this]{ _handleLogInfo(); });
   _srv.on("/config",      [this]{ _handleConfig(); });
   _srv.on("/save",        [this]{ _handleSave(); });
   _srv.on("/erase",       [this]{ _handleErase(); });
+  // EventSource sends Last-Event-ID on reconnect so the stream resumes gap-free;
+  // If-None-Match lets the dashboard revalidate with a 304
+  static const char* hdrs[] = { "Last-Event-ID", "If-None-Match" };
+  _srv.collectHeaders(hdrs, 2);
   _srv.begin();
   Serial.println("HTTP server started.");
 }
 
+// Dashboard is pre-gzipped into flash (web_assets.h, see tools/embed_assets.py).
+// no-cache + strong ETag: browsers revalidate on every load and get a 304.
 void WiFiWeb::_handleRoot() {
-  _srv.setContentLength(CONTENT_LENGTH_UNKNOWN);
-  _srv.send(200, "text/html", _html());
+  _srv.sendHeader("ETag", WEB_INDEX_HTML_ETAG);
+  _srv.sendHeader("Cache-Control", "no-cache");
+  if (_srv.header("If-None-Match") == WEB_INDEX_HTML_ETAG) {
+    _srv.send(304, "text/html", "");
+    return;
+  }
+  _srv.sendHeader("Content-Encoding", "gzip");
+  _srv.send_P(200, "text/html", (PGM_P)WEB_INDEX_HTML_GZ, WEB_INDEX_HTML_GZ_LEN);
 }
 
-void WiFiWeb::_handleMetrics() {
-  String json = "{";
-  if (_spo2) {
-    json += "\"pulse\":";
-    int bpm = _spo2->bpmRounded();
-    json += (bpm<0 ? String("null") : String(bpm));
-    json += ",\"spo2\":";
-    int o2 = _spo2->spo2Rounded();
-    json += (o2<0 ? String("null") : String(o2));
-    json += ",\"pi\":"; json += String(_spo2->perfusionIndex(), 1);
-    json += ",\"finger\":"; json += (_spo2->hasFinger() ? "true":"false");
-  } else json += "\"pulse\":null,\"spo2\":null,\"pi\":0,\"finger\":false";
+void WiFiWeb::_sendBinary(const uint8_t* data, size_t len) {
+  _srv.send_P(200, "application/octet-stream", (PGM_P)data, len);
+}
 
-  if (_tp) { json += ",\"tempC\":"; json += (_tp->hasTemp()? String(_tp->tempC(),1):"null"); }
-  else     { json += ",\"tempC\":null"; }
+// A body that did not fit its buffer is cut off: an error, not a 200.
+void WiFiWeb::_sendJson(const JsonWriter& j) {
+  if (j.overflow()) { _srv.send(500, "application/json", "{\"error\":\"response too large\"}"); return; }
+  _srv.send_P(200, "application/json", j.c_str(), j.length());
+}
+
+// JsonWriter sink for chunked responses
+static void jsonToServer(void* ctx, const char* data, size_t len) {
+  static_cast<WebServer*>(ctx)->sendContent(data, len);
+}
+
+void WiFiWeb::_handleMetrics() {
+  if (_wantBinary()) {
+    WireVitals v;
+    v.tMs = millis();
+    if (_spo2) {
+      v.pulse  = _spo2->bpmRounded();
+      v.spo2   = _spo2->spo2Rounded();
+      v.pi     = _spo2->perfusionIndex();
+      v.finger = _spo2->hasFinger();
+      v.sqi    = _spo2->signalQuality();
+    }
+    if (_tp && _tp->hasTemp()) v.tempC = _tp->tempC();
+    if (_ecg && _ecg->ecgBpm() > 0) { v.ecgBpm = _ecg->ecgBpm(); v.rrMs = _ecg->lastRrMs(); }
+    uint8_t frame[WIRE_VITALS_BYTES];
+    _sendBinary(frame, wireEncodeVitals(frame, sizeof(frame), v));
+    return;
+  }
 
-  json += "}";
-  _srv.send(200, "application/json", json);
+  char buf[224];
+  JsonWriter j(buf, sizeof(buf));
+  jsonMetrics(j, _spo2, _tp, _ecg);
+  _sendJson(j);
 }
 
 void WiFiWeb::_handleECG() {
@@ -93,127 +108,276 @@ void WiFiWeb::_handleECG() {
   int n = 300;
   if (_srv.hasArg("n")) {
     int req = _srv.arg("n").toInt();
-    if (req>0 && req<=800) n = req;
+    if (req>0 && req<=ECG_RING_SAMPLES) n = req;
+  }
+  static int16_t buf[ECG_RING_SAMPLES];
+  bool off = _ecg->leadsOff();
+  uint64_t first = 0;
+  size_t got;
+  if (_srv.hasArg("since")) {
+    // incremental: only samples the client has not seen yet
+    uint64_t since = strtoull(_srv.arg("since").c_str(), nullptr, 10);
+    got = _ecg->readSince(since, buf, (size_t)n, first);
+  } else {
+    uint64_t head = _ecg->sampleIndex();
+    got = _ecg->readSince(head > (uint64_t)n ? head - n : 0, buf, (size_t)n, first);
+  }
+
+  if (_wantBinary()) {
+    static uint8_t frame[WIRE_ECG_HDR_BYTES + 3*ECG_RING_SAMPLES];
+    WireEcgFrame h;
+    h.tMs = millis(); h.leadsOff = off; h.fs = (uint16_t)_ecg->sampleRate(); h.seq = first;
+    _sendBinary(frame, wireEncodeEcg(frame, sizeof(frame), h, buf, got));
+    return;
   }
-  static int16_t buf[800];
-  bool off=false;
-  size_t got = _ecg->getRecent(buf, (size_t)n, off);
 
-  String json; json.reserve(32 + got*6);
-  json += "{\"fs\":"; json += String((int)_ecg->sampleRate());
-  json += ",\"off\":"; json += (off?"true":"false");
-  json += ",\"samples\":[";
-  for (size_t i=0;i<got;i++){ if(i) json += ","; json += String((int)buf[i]); }
-  json += "]}";
-  _srv.send(200, "application/json", json);
+  // up to ~12 KB of text: stream it in chunks instead of building it
+  _srv.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  _srv.send(200, "application/json", "");
+  char chunk[512];
+  JsonWriter j(chunk, sizeof(chunk), jsonToServer, &_srv);
+  jsonEcg(j, (int)_ecg->sampleRate(), off, _ecg->droppedSamples(), first, buf, got);
+  j.flush();
+  _srv.sendContent("", 0);   // end of chunked body
 }
 
-void WiFiWeb::_handleConfig() {
-  if (!_settings) { _srv.send(500, "text/plain", "Settings not available"); return; }
-  WifiCreds cur = _settings->getWifi();
-  String html = _htmlConfig(_apSSID, cur);
-  _srv.send(200, "text/html", html);
+void WiFiWeb::_handleBeats() {
+  if (!_ecg) { _srv.send(404, "application/json", "{\"error\":\"ecg disabled\"}"); return; }
+  uint64_t since = _srv.hasArg("since") ? strtoull(_srv.arg("since").c_str(), nullptr, 10) : 0;
+  QrsBeat beats[16];
+  uint64_t first = 0;
+  size_t got = _ecg->readBeats(since, beats, 16, first);
+
+  char buf[96 + 16*32];
+  JsonWriter j(buf, sizeof(buf));
+  jsonBeats(j, (int)_ecg->sampleRate(), first, beats, got);
+  _sendJson(j);
 }
 
-void WiFiWeb::_handleSave() {
-  if (!_settings) { _srv.send(500, "text/plain", "Settings not available"); return; }
-  String ssid = _srv.hasArg("ssid") ? _srv.arg("ssid") : "";
-  String pass = _srv.hasArg("pass") ? _srv.arg("pass") : "";
-  if (ssid.length()==0) { _srv.send(400, "text/plain", "SSID required"); return; }
-  _settings->saveWifi(ssid, pass);
-  _srv.send(200, "text/html",
-    "<html><body><h3>Saved. Rebooting...</h3></body></html>");
-  delay(500);
-  ESP.restart();
+void WiFiWeb::_handleTasks() {
+  AppTaskInfo t[4];
+  int n = appTaskInfo(t, 4);
+
+  char buf[384];                       // 4 tasks, 10-digit stack sizes: ~310
+  JsonWriter j(buf, sizeof(buf));
+  j.beginObject();
+#ifdef ENABLE_RTOS_TASKS
+  j.key("rtos").value(true);
+#else
+  j.key("rtos").value(false);
+#endif
+  j.key("tasks").beginArray();
+  for (int i=0;i<n;i++) {
+    j.beginObject();
+    j.key("name").value(t[i].name);
+    j.key("prio").value((unsigned)t[i].prio);
+    j.key("stack").value((unsigned long)t[i].stackBytes);
+    j.key("stackFree").value((unsigned long)t[i].stackFree);
+    j.endObject();
+  }
+  j.endArray().endObject();
+  _sendJson(j);
 }
 
-void WiFiWeb::_handleErase() {
-  if (!_settings) { _srv.send(500, "text/plain", "Settings not available"); return; }
-  _settings->clearWifi();
-  _srv.send(200, "text/html", "<html><body><h3>Credentials erased. Rebooting...</h3></body></html>");
-  delay(400);
-  ESP.restart();
+void WiFiWeb::_handleI2C() {
+  if (!_bus) { _srv.send(404, "application/json", "{\"error\":\"no bus\"}"); return; }
+  // counters grow with uptime: stream the body
+  _srv.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  _srv.send(200, "application/json", "");
+  char chunk[256];
+  JsonWriter j(chunk, sizeof(chunk), jsonToServer, &_srv);
+  jsonI2C(j, *_bus, _oled ? (long)_oled->bytesPerSec() : -1);
+  j.flush();
+  _srv.sendContent("", 0);
 }
 
-const char* WiFiWeb::_html() {
-  return
-R"HTML(<!doctype html><html><head><meta charset="utf-8">
-<meta name="viewport" content="width=device-width,initial-scale=1">
-<title>ESP32C3 Health Monitor</title>
-<style>
-body{font-family:system-ui,Arial;margin:20px;background:#0b0e13;color:#eef}
-.card{background:#141a22;border-radius:12px;padding:16px;max-width:640px;box-shadow:0 4px 16px rgba(0,0,0,.3)}
-h1{font-size:20px;margin:0 0 10px}
-.row{display:flex;justify-content:space-between;margin:6px 0}
-.label{opacity:.8}
-.value{font-weight:600}
-.bar{height:10px;background:#222;border-radius:6px;overflow:hidden;margin-top:6px}
-.fill{height:100%;width:0;background:#4caf50;transition:width .2s}
-small{opacity:.7}
-a{color:#8ab4ff;text-decoration:none}
-canvas{width:100%;height:160px;max-height:200px;background:#0f141b;border-radius:8px;margin-top:12px}
-</style></head>
-<body>
-<div class="card">
-  <h1>ESP32-C3 Health Monitor</h1>
-  <div class="row"><div class="label">Pulse</div><div class="value" id="bpm">-- bpm</div></div>
-  <div class="row"><div class="label">SpO₂</div><div class="value" id="spo2">-- %</div></div>
-  <div class="row"><div class="label">Temp</div><div class="value" id="temp">--.- °C</div></div>
-  <div class="label">Signal</div>
-  <div class="bar"><div class="fill" id="bar"></div></div>
-  <div class="row"><small id="status">finger: false</small><small><a href="/config">config</a></small></div>
-
-  <h1 style="margin-top:16px">ECG</h1>
-  <canvas id="ecg" width="600" height="160"></canvas>
-  <div class="row"><small>fs: <span id="fs">--</span> Hz</small><small id="ecgstatus"></small></div>
-</div>
-<script>
-async function tickVitals(){
-  try{
-    const r = await fetch('/api/metrics'); const j = await r.json();
-    document.getElementById('bpm').textContent  = (j.pulse==null?'--':j.pulse)+' bpm';
-    document.getElementById('spo2').textContent = (j.spo2==null?'--':j.spo2)+' %';
-    document.getElementById('temp').textContent = (j.tempC==null?'--.-':(+j.tempC).toFixed(1))+' °C';
-    const pi = Math.max(0, Math.min(10, j.pi || 0));
-    document.getElementById('bar').style.width = (pi*10)+'%';
-    document.getElementById('status').textContent = 'finger: '+j.finger;
-  }catch(e){ console.log(e); }
-}
-const cvs = document.getElementById('ecg');
-const ctx = cvs.getContext('2d');
-function drawECG(samples, off){
-  const w=cvs.width,h=cvs.height;
-  ctx.clearRect(0,0,w,h);
-  ctx.strokeStyle='#203040';ctx.lineWidth=1;ctx.beginPath();ctx.moveTo(0,h/2);ctx.lineTo(w,h/2);ctx.stroke();
-  if(!samples||samples.length===0) return;
-  let min= 32767,max=-32768;
-  for(let i=0;i<samples.length;i++){const v=samples[i]; if(v<min)min=v; if(v>max)max=v;}
-  if(max-min<50){max=min+50;}
-  const N=samples.length;
-  ctx.strokeStyle=off?'#888':'#4caf50';ctx.lineWidth=2;ctx.beginPath();
-  for(let i=0;i<N;i++){
-    const x=(i/(N-1))*w;
-    const y=h-((samples[i]-min)/(max-min))*h;
-    if(i===0) ctx.moveTo(x,y); else ctx.lineTo(x,y);
+// Error counters, heap, and the timing probes when ENABLE_STATS is set.
+void WiFiWeb::_handleStats() {
+  _srv.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  _srv.send(200, "application/json", "");
+  char chunk[512];
+  JsonWriter j(chunk, sizeof(chunk), jsonToServer, &_srv);
+  j.beginObject();
+  j.key("uptimeMs").value((unsigned long)millis());
+  j.key("heapFree").value((unsigned long)ESP.getFreeHeap());
+  j.key("heapMinFree").value((unsigned long)ESP.getMinFreeHeap());
+  // station link (net_wifi.h)
+  j.key("wifiState").value(WiFiConn::stateName(_conn.state()));
+  j.key("wifiAp").value(_conn.apActive());
+  if (_conn.connected()) j.key("wifiRssi").value((long)WiFi.RSSI());
+  j.key("wifiReconnects").value((unsigned long)_conn.reconnects());
+  j.key("wifiLastReason").value((unsigned long)_conn.lastReason());
+  if (_ecg) {
+    j.key("ecgDropped").value((unsigned long)_ecg->droppedSamples());
+    j.key("ecgOverruns").value((unsigned long)_ecg->overruns());
+  }
+  if (_spo2) {
+    j.key("fifoOverflows").value((unsigned long)_spo2->fifoOverflows());
+    // LED loop and power mode
+    j.key("ppgMode").value(Max30102Sensor::modeName(_spo2->mode()));
+    j.key("ppgSps").value(_spo2->sampleRate());
+    j.key("ledRedMa").value(_spo2->ledRedMa(), 1);
+    j.key("ledIrMa").value(_spo2->ledIrMa(), 1);
+    j.key("ledAvgMa").value(_spo2->ledAvgMa(), 2);
+  }
+  if (_bus) {
+    unsigned long errs = 0;
+    for (int d=0; d<I2CBus::DEV_COUNT; d++) errs += _bus->stats((I2CBus::Dev)d).errors;
+    j.key("i2cErrors").value(errs);
   }
-  ctx.stroke();
+  if (_log && _log->ready()) j.key("logWriteErrors").value((unsigned long)_log->writeErrors());
+#ifdef ENABLE_STATS
+  // per probe: count, mean/p50/p99/max in us, histogram of
+  // [2^k, 2^(k+1)) CPU cycles
+  uint32_t mhz = getCpuFrequencyMhz();
+  j.key("cpuMHz").value((unsigned long)mhz);
+  j.key("probes").beginArray();
+  for (int i=0; i<STAT_COUNT; i++) {
+    const StatHist& h = g_stats[i];
+    j.beginObject();
+    j.key("name").value(statName((StatProbe)i));
+    j.key("n").value((unsigned long)h.count);
+    j.key("meanUs").value(h.count ? (float)((double)h.sumCycles / h.count / mhz) : 0.0f, 1);
+    j.key("p50Us").value((unsigned long)(h.quantileCycles(0.50f) / mhz));
+    j.key("p99Us").value((unsigned long)(h.quantileCycles(0.99f) / mhz));
+    j.key("maxUs").value((unsigned long)(h.maxCycles / mhz));
+    j.key("hist").beginArray();
+    for (int k=0; k<StatHist::BUCKETS; k++) j.value((unsigned long)h.bucket[k]);
+    j.endArray();
+    j.endObject();
+  }
+  j.endArray();
+#endif
+  j.endObject();
+  j.flush();
+  _srv.sendContent("", 0);
+#ifdef ENABLE_STATS
+  if (_srv.hasArg("reset")) statsReset();
+#endif
+}
+
+static void bytesToServer(void* ctx, const uint8_t* data, size_t len) {
+  static_cast<WebServer*>(ctx)->sendContent((const char*)data, len);
 }
-async function tickECG(){
-  try{
-    const r = await fetch('/api/ecg?n=300'); const j = await r.json();
-    document.getElementById('fs').textContent = j.fs ?? '--';
-    document.getElementById('ecgstatus').textContent = j.off ? 'leads off' : '';
-    drawECG(j.samples || [], j.off);
-  }catch(e){ console.log(e); }
+
+// Stored log blocks as-is (4 KB each, see log_block.h), streamed from flash.
+void WiFiWeb::_handleLog() {
+  if (!_log || !_log->ready()) { _srv.send(404, "application/json", "{\"error\":\"log disabled\"}"); return; }
+  uint32_t from = _srv.hasArg("from") ? strtoul(_srv.arg("from").c_str(), nullptr, 10) : 0;
+  uint32_t to   = _srv.hasArg("to")   ? strtoul(_srv.arg("to").c_str(), nullptr, 10) : 0xFFFFFFFFUL;
+  if (_srv.hasArg("flush")) _log->flush();   // include the blocks still open in RAM
+  _srv.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  _srv.sendHeader("Content-Disposition", "attachment; filename=\"healthlog.bin\"");
+  _srv.send(200, "application/octet-stream", "");
+  _log->readRange(from, to, bytesToServer, &_srv);
+  _srv.sendContent("", 0);
+}
+
+void WiFiWeb::_handleLogInfo() {
+  if (!_log || !_log->ready()) { _srv.send(404, "application/json", "{\"error\":\"log disabled\"}"); return; }
+  char buf[320];                       // every counter at 10 digits: ~260
+  JsonWriter j(buf, sizeof(buf));
+  j.beginObject();
+  j.key("blockBytes").value((unsigned)LOG_BLOCK_BYTES);
+  j.key("segments").value(_log->segments());
+  j.key("firstSeq").value((unsigned long)_log->firstSeq());
+  j.key("nextSeq").value((unsigned long)_log->nextSeq());
+  j.key("usedBytes").value((unsigned long)_log->usedBytes());
+  j.key("totalBytes").value((unsigned long)_log->totalBytes());
+  j.key("written").value((unsigned long)_log->blocksWritten());
+  j.key("writeErrors").value((unsigned long)_log->writeErrors());
+  j.key("ecgGaps").value((unsigned long)_log->ecgGaps());
+  j.key("maxWriteUs").value((unsigned long)_log->maxWriteUs());
+  j.key("ecgHz").value((int)LOG_ECG_HZ);
+  j.key("ecgBitsPerSample").value(_log->ecgBitsPerSample(), 2);
+  j.endObject();
+  _sendJson(j);
 }
-setInterval(tickVitals,1000); tickVitals();
-setInterval(tickECG,200); tickECG();
-</script>
-</body></html>)HTML";
+
+// Keeps the socket after the handler returns; _pumpECGStream() writes to it.
+void WiFiWeb::_handleECGStream() {
+  if (!_ecg) { _srv.send(404, "application/json", "{\"error\":\"ecg disabled\"}"); return; }
+  int slot = -1;
+  for (int i=0;i<ECG_SSE_MAX_CLIENTS;i++) {
+    if (_sse[i].active && !_sse[i].client.connected()) { _sse[i].client.stop(); _sse[i].active = false; }
+    if (!_sse[i].active && slot < 0) slot = i;
+  }
+  if (slot < 0) { _srv.send(503, "text/plain", "too many streams"); return; }
+
+  uint64_t head = _ecg->sampleIndex();
+  uint64_t next = head;
+  if (_srv.hasHeader("Last-Event-ID") && _srv.header("Last-Event-ID").length()) {
+    next = strtoull(_srv.header("Last-Event-ID").c_str(), nullptr, 10);
+  } else if (_srv.hasArg("n")) {
+    // optional backfill so the client can draw a full trace straight away
+    uint64_t n = (uint64_t)_srv.arg("n").toInt();
+    if (n > ECG_RING_SAMPLES) n = ECG_RING_SAMPLES;
+    next = head > n ? head - n : 0;
+  }
+
+  WiFiClient c = _srv.client();
+  c.print("HTTP/1.1 200 OK\r\n"
+          "Content-Type: text/event-stream\r\n"
+          "Cache-Control: no-cache\r\n"
+          "Connection: keep-alive\r\n\r\n"
+          "retry: 1000\n\n");
+  _sse[slot].client = c;
+  _sse[slot].next = next;
+  _sse[slot].lastSendMs = millis();
+  _sse[slot].active = true;
+  _sse[slot].bin = _wantBinary();
 }
 
-String WiFiWeb::_htmlConfig(const String& apSsid, const WifiCreds& cur) {
-  String html =
+// Sends each stream client the samples it has not seen yet, one event per
+// batch: id = next sequence, data = {"fs","seq","off","s":[...]} or, with
+// fmt=bin, a base64 binary ECG frame (net_wire.h).
+void WiFiWeb::_pumpECGStream() {
+  uint32_t now = millis();
+  if (!_ecg || now - _lastSseMs < ECG_SSE_PERIOD_MS) return;
+  _lastSseMs = now;
+
+  static const size_t BATCH = 256;
+  static int16_t samples[BATCH];
+  static char    ev[BATCH*7 + 128];
+  static uint8_t frame[WIRE_ECG_HDR_BYTES + 3*BATCH];
+  bool off = _ecg->leadsOff();
+
+  for (int i=0;i<ECG_SSE_MAX_CLIENTS;i++) {
+    SseClient& sc = _sse[i];
+    if (!sc.active) continue;
+    if (!sc.client.connected()) { sc.client.stop(); sc.active = false; continue; }
+
+    uint64_t first = 0;
+    size_t got = _ecg->readSince(sc.next, samples, BATCH, first);
+    if (!got) {
+      if (now - sc.lastSendMs > 15000) { sc.client.print(": ka\n\n"); sc.lastSendMs = now; }
+      continue;
+    }
+    int len = snprintf(ev, sizeof(ev), "id: %llu\ndata: ", (unsigned long long)(first + got));
+    if (sc.bin) {
+      WireEcgFrame h;
+      h.tMs = now; h.leadsOff = off; h.fs = (uint16_t)_ecg->sampleRate(); h.seq = first;
+      size_t fl = wireEncodeEcg(frame, sizeof(frame), h, samples, got);
+      len += wireBase64(frame, fl, ev + len, sizeof(ev) - len);
+      len += snprintf(ev + len, sizeof(ev) - len, "\n\n");
+    } else {
+      JsonWriter j(ev + len, sizeof(ev) - len);
+      jsonEcgEvent(j, (int)_ecg->sampleRate(), first, off, samples, got);
+      len += j.length();
+      len += snprintf(ev + len, sizeof(ev) - len, "\n\n");
+    }
+
+    if (sc.client.write((const uint8_t*)ev, (size_t)len) != (size_t)len) {
+      sc.client.stop(); sc.active = false;     // broken or stalled peer
+      continue;
+    }
+    sc.next = first + got;
+    sc.lastSendMs = now;
+  }
+}
+
+// Static parts of the config page; the values in between are HTML-escaped.
+static const char CONFIG_HEAD[] PROGMEM =
 R"HTML(<!doctype html><html><head><meta charset="utf-8">
 <meta name="viewport" content="width=device-width,initial-scale=1">
 <title>Wi-Fi Config</title>
@@ -228,18 +392,84 @@ a{color:#8ab4ff}
 <div class="card">
 <h2>Wi-Fi Configuration</h2>
 <p>AP: <b>)HTML";
-  html += apSsid + "</b></p>";
-  html += "<form action=\"/save\" method=\"get\">";
-  html += "<label>SSID</label><input name=\"ssid\" value=\"";
-  html += cur.valid ? cur.ssid : "";
-  html += "\" placeholder=\"YourWiFi\">";
-  html += "<label>Password</label><input name=\"pass\" value=\"";
-  html += cur.valid ? cur.pass : "";
-  html += "\" placeholder=\"(leave empty for open)\">";
-  html += "<button type=\"submit\">Save & Reboot</button>";
-  html += "</form><p><a href=\"/erase\">Erase credentials</a> • <a href=\"/\">Back</a></p>";
-  html += "</div></body></html>";
-  return html;
-}
-
-void WiFiWeb::handle() { _srv.handleClient(); }
+static const char CONFIG_SSID[] PROGMEM =
+  "</b></p><form action=\"/save\" method=\"get\">"
+  "<label>SSID</label><input name=\"ssid\" value=\"";
+static const char CONFIG_PASS[] PROGMEM =
+  "\" placeholder=\"YourWiFi\">"
+  "<label>Password</label><input name=\"pass\" value=\"";
+static const char CONFIG_TAIL[] PROGMEM =
+  "\" placeholder=\"(leave empty for open)\">"
+  "<button type=\"submit\">Save & Reboot</button>"
+  "</form><p><a href=\"/erase\">Erase credentials</a> • <a href=\"/\">Back</a></p>"
+  "</div></body></html>";
+
+void WiFiWeb::_handleConfig() {
+  if (!_settings) { _srv.send(500, "text/plain", "Settings not available"); return; }
+  WifiCreds cur = _settings->getWifi();
+  // streamed in chunks: no String assembly of the whole page
+  _srv.sendHeader("Cache-Control", "no-store");
+  _srv.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  _srv.send(200, "text/html", "");
+  _srv.sendContent_P(CONFIG_HEAD);
+  _sendEscaped(_apSSID);
+  _srv.sendContent_P(CONFIG_SSID);
+  if (cur.valid) _sendEscaped(cur.ssid);
+  _srv.sendContent_P(CONFIG_PASS);
+  if (cur.valid) _sendEscaped(cur.pass);
+  _srv.sendContent_P(CONFIG_TAIL);
+  _srv.sendContent("", 0);
+}
+
+void WiFiWeb::_handleSave() {
+  if (!_settings) { _srv.send(500, "text/plain", "Settings not available"); return; }
+  String ssid = _srv.hasArg("ssid") ? _srv.arg("ssid") : "";
+  String pass = _srv.hasArg("pass") ? _srv.arg("pass") : "";
+  if (ssid.length()==0) { _srv.send(400, "text/plain", "SSID required"); return; }
+  _settings->saveWifi(ssid, pass);
+  _srv.send(200, "text/html",
+    "<html><body><h3>Saved. Rebooting...</h3></body></html>");
+  _scheduleReboot(500);
+}
+
+void WiFiWeb::_handleErase() {
+  if (!_settings) { _srv.send(500, "text/plain", "Settings not available"); return; }
+  _settings->clearWifi();
+  _srv.send(200, "text/html", "<html><body><h3>Credentials erased. Rebooting...</h3></body></html>");
+  _scheduleReboot(400);
+}
+
+// Restart from handle() once the response has gone out, instead of
+// blocking the loop in delay().
+void WiFiWeb::_scheduleReboot(uint32_t delayMs) {
+  _rebootAtMs = millis() + delayMs;
+  if (_rebootAtMs == 0) _rebootAtMs = 1;
+}
+
+void WiFiWeb::_sendEscaped(const String& s) {
+  char buf[64];
+  size_t n = 0;
+  for (size_t i = 0; i < s.length(); i++) {
+    const char* rep = nullptr;
+    switch (s[i]) {
+      case '&':  rep = "&amp;";  break;
+      case '<':  rep = "&lt;";   break;
+      case '>':  rep = "&gt;";   break;
+      case '"':  rep = "&quot;"; break;
+      case '\'': rep = "&#39;";  break;
+    }
+    size_t len = rep ? strlen(rep) : 1;
+    if (n + len > sizeof(buf)) { _srv.sendContent(buf, n); n = 0; }
+    if (rep) { memcpy(buf + n, rep, len); n += len; }
+    else buf[n++] = s[i];
+  }
+  if (n) _srv.sendContent(buf, n);
+}
+
+void WiFiWeb::handle() {
+  STAT_SCOPE(STAT_WEB);
+  _conn.handle();
+  _srv.handleClient();
+  _pumpECGStream();
+  if (_rebootAtMs && (int32_t)(millis() - _rebootAtMs) >= 0) ESP.restart();
+}
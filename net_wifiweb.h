@@ -4,30 +4,55 @@
 #include "sensor_max30102.h"
 #include "sensor_max30205.h"
 #include "sensor_ad8232.h"
+#include "display_oled.h"
+#include "log_flash.h"
+#include "net_wifi.h"
 
 // Forward declarations:
 class Settings;
+class JsonWriter;
 struct WifiCreds;   // <-- ADD THIS
 
 class WiFiWeb {
 public:
-  void beginAP(const char* ssid, const char* pass="");
-  void beginSTA(const char* ssid, const char* pass, const char* hostname);
+  // Starts the web server and the connection manager (WiFiConn) and
+  // returns at once: STA with saved credentials, else the config AP.
   void beginAuto(Settings& settings,
                  const char* ap_ssid, const char* ap_pass,
                  const char* hostname);
 
   void attachMetricsSource(Max30102Sensor* spo2, Max30205Sensor* tprobe);
   void attachECG(AD8232Sensor* ecg);
+  void attachBus(I2CBus* bus) { _bus = bus; }
+  void attachDisplay(DisplayOLED* oled) { _oled = oled; }
+  void attachLog(FlashLog* log) { _log = log; }
+  void attachOTA(OTAUpdater* ota) { _conn.attachOTA(ota); }   // started on STA link or AP
   void handle();
+  const WiFiConn& conn() const { return _conn; }
 
 private:
   WebServer _srv {80};
+  WiFiConn  _conn;
   Max30102Sensor* _spo2 = nullptr;
   Max30205Sensor* _tp   = nullptr;
   AD8232Sensor*   _ecg  = nullptr;
+  I2CBus*         _bus  = nullptr;
+  DisplayOLED*    _oled = nullptr;
+  FlashLog*       _log  = nullptr;
   Settings*       _settings = nullptr;
   String          _apSSID;
+  uint32_t        _rebootAtMs = 0;        // deferred restart after /save, /erase (0 = none)
+
+  // Server-Sent Events clients of /api/ecg/stream
+  struct SseClient {
+    WiFiClient client;
+    uint64_t   next = 0;          // next ECG sample index to send
+    uint32_t   lastSendMs = 0;
+    bool       active = false;
+    bool       bin = false;         // base64 binary frames instead of JSON
+  };
+  SseClient       _sse[ECG_SSE_MAX_CLIENTS];
+  uint32_t        _lastSseMs = 0;
 
   void _setupRoutes();
   void _handleRoot();
@@ -36,6 +61,17 @@ private:
   void _handleSave();
   void _handleErase();
   void _handleECG();
-  static const char* _html();
-  static String _htmlConfig(const String& apSsid, const WifiCreds& cur); // OK now
+  void _handleBeats();
+  void _handleTasks();
+  void _handleI2C();
+  void _handleLog();
+  void _handleStats();
+  void _handleLogInfo();
+  void _scheduleReboot(uint32_t delayMs);
+  void _handleECGStream();
+  void _pumpECGStream();
+  bool _wantBinary() { return _srv.hasArg("fmt") && _srv.arg("fmt") == "bin"; }
+  void _sendBinary(const uint8_t* data, size_t len);
+  void _sendJson(const JsonWriter& j);
+  void _sendEscaped(const String& s);
 };
@@ -0,0 +1,126 @@
+#include "net_wire.h"
+
+static inline void putU16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static inline void putU32(uint8_t* p, uint32_t v) { putU16(p, (uint16_t)v); putU16(p + 2, (uint16_t)(v >> 16)); }
+static inline void putU64(uint8_t* p, uint64_t v) { putU32(p, (uint32_t)v); putU32(p + 4, (uint32_t)(v >> 32)); }
+static inline uint16_t getU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t getU32(const uint8_t* p) { return getU16(p) | ((uint32_t)getU16(p + 2) << 16); }
+static inline uint64_t getU64(const uint8_t* p) { return getU32(p) | ((uint64_t)getU32(p + 4) << 32); }
+
+static inline uint32_t zigzag(int32_t v)    { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static inline int32_t  unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+static void putHeader(uint8_t* out, uint8_t type, uint8_t flags, uint32_t tMs) {
+  out[0] = 'H'; out[1] = 'M';
+  out[2] = WIRE_VERSION;
+  out[3] = type;
+  out[4] = flags;
+  putU32(out + 5, tMs);
+}
+
+size_t wireEncodeEcg(uint8_t* out, size_t cap, const WireEcgFrame& hdr,
+                     const int16_t* samples, size_t n) {
+  if (cap < WIRE_ECG_HDR_BYTES) return 0;
+  putHeader(out, WIRE_TYPE_ECG, hdr.leadsOff ? WIRE_FLAG_LEADOFF : 0, hdr.tMs);
+  putU16(out + 9, hdr.fs);
+  putU64(out + 11, hdr.seq);
+
+  size_t pos = WIRE_ECG_HDR_BYTES, count = 0;
+  int32_t prev = 0;
+  if (n > 0xFFFF) n = 0xFFFF;
+  for (; count < n; count++) {
+    uint32_t z = zigzag((int32_t)samples[count] - prev);
+    uint8_t  tmp[5]; size_t k = 0;
+    do { uint8_t b = z & 0x7F; z >>= 7; tmp[k++] = z ? (b | 0x80) : b; } while (z);
+    if (pos + k > cap) break;
+    for (size_t i = 0; i < k; i++) out[pos++] = tmp[i];
+    prev = samples[count];
+  }
+  putU16(out + 19, (uint16_t)count);
+  return pos;
+}
+
+size_t wireEncodeVitals(uint8_t* out, size_t cap, const WireVitals& v) {
+  if (cap < WIRE_VITALS_BYTES) return 0;
+  putHeader(out, WIRE_TYPE_VITALS, v.finger ? WIRE_FLAG_FINGER : 0, v.tMs);
+  out[9]  = (v.pulse  >= 0 && v.pulse  < 255) ? (uint8_t)v.pulse  : 0xFF;
+  out[10] = (v.spo2   >= 0 && v.spo2   < 255) ? (uint8_t)v.spo2   : 0xFF;
+  out[11] = (v.ecgBpm >  0 && v.ecgBpm < 255) ? (uint8_t)v.ecgBpm : 0xFF;
+  float pi = v.pi < 0 ? 0 : (v.pi > 655.0f ? 655.0f : v.pi);
+  putU16(out + 12, (uint16_t)(pi * 100.0f + 0.5f));
+  int16_t t = 0x7FFF;
+  if (!isnan(v.tempC) && v.tempC > -300.0f && v.tempC < 300.0f)
+    t = (int16_t)lroundf(v.tempC * 100.0f);
+  putU16(out + 14, (uint16_t)t);
+  putU16(out + 16, v.rrMs);
+  out[18] = v.sqi > 100 ? 100 : v.sqi;
+  return WIRE_VITALS_BYTES;
+}
+
+bool wirePeekType(const uint8_t* in, size_t len, uint8_t& type) {
+  if (len < WIRE_HDR_BYTES || in[0] != 'H' || in[1] != 'M' || in[2] != WIRE_VERSION) return false;
+  type = in[3];
+  return true;
+}
+
+bool wireDecodeEcg(const uint8_t* in, size_t len, WireEcgFrame& hdr,
+                   int16_t* out, size_t maxOut) {
+  uint8_t type;
+  if (!wirePeekType(in, len, type) || type != WIRE_TYPE_ECG || len < WIRE_ECG_HDR_BYTES) return false;
+  hdr.leadsOff = (in[4] & WIRE_FLAG_LEADOFF) != 0;
+  hdr.tMs   = getU32(in + 5);
+  hdr.fs    = getU16(in + 9);
+  hdr.seq   = getU64(in + 11);
+  hdr.count = getU16(in + 19);
+  if (hdr.count > maxOut) return false;
+
+  size_t pos = WIRE_ECG_HDR_BYTES;
+  int32_t prev = 0;
+  for (uint16_t i = 0; i < hdr.count; i++) {
+    uint32_t z = 0; int shift = 0;
+    for (;;) {
+      if (pos >= len || shift > 28) return false;
+      uint8_t b = in[pos++];
+      z |= (uint32_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) break;
+      shift += 7;
+    }
+    prev += unzigzag(z);
+    out[i] = (int16_t)prev;
+  }
+  return pos == len;
+}
+
+bool wireDecodeVitals(const uint8_t* in, size_t len, WireVitals& v) {
+  uint8_t type;
+  if (!wirePeekType(in, len, type) || type != WIRE_TYPE_VITALS || len < WIRE_VITALS_BYTES) return false;
+  v.finger = (in[4] & WIRE_FLAG_FINGER) != 0;
+  v.tMs    = getU32(in + 5);
+  v.pulse  = in[9]  == 0xFF ? -1 : in[9];
+  v.spo2   = in[10] == 0xFF ? -1 : in[10];
+  v.ecgBpm = in[11] == 0xFF ? -1 : in[11];
+  v.pi     = getU16(in + 12) / 100.0f;
+  int16_t t = (int16_t)getU16(in + 14);
+  v.tempC  = (t == 0x7FFF) ? NAN : t / 100.0f;
+  v.rrMs   = getU16(in + 16);
+  v.sqi    = in[18];
+  return true;
+}
+
+size_t wireBase64(const uint8_t* in, size_t len, char* out, size_t cap) {
+  static const char T[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  size_t need = (len + 2) / 3 * 4;
+  if (need + 1 > cap) return 0;
+  size_t o = 0;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = (uint32_t)in[i] << 16;
+    if (i + 1 < len) v |= (uint32_t)in[i + 1] << 8;
+    if (i + 2 < len) v |= in[i + 2];
+    out[o++] = T[(v >> 18) & 63];
+    out[o++] = T[(v >> 12) & 63];
+    out[o++] = (i + 1 < len) ? T[(v >> 6) & 63] : '=';
+    out[o++] = (i + 2 < len) ? T[v & 63] : '=';
+  }
+  out[o] = 0;
+  return o;
+}
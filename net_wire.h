@@ -0,0 +1,71 @@
+// net_wire.h
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+// Compact binary frames for ECG and vitals (served with ?fmt=bin).
+// Plain C++ with no Arduino dependencies, so the same encoder/decoder can be
+// used by host tools. All integers are little-endian.
+//
+// Common header (9 bytes):
+//   0  'H' 'M'   magic
+//   2  u8        version (WIRE_VERSION)
+//   3  u8        type (WIRE_TYPE_ECG / WIRE_TYPE_VITALS)
+//   4  u8        flags (WIRE_FLAG_*)
+//   5  u32       device time, ms since boot
+// ECG body:
+//   9  u16 fs, 11 u64 seq (index of the first sample), 19 u16 count,
+//   21 samples: zig-zag LEB128 varint of the first sample, then of each delta
+// Vitals body (10 bytes):
+//   9  u8 pulse, u8 spo2, u8 ecgBpm (0xFF = none), u16 pi x100,
+//      i16 tempC x100 (0x7FFF = none), u16 rrMs (0 = none),
+//   18 u8 signal quality 0..100 (version 2)
+
+static const uint8_t WIRE_VERSION      = 2;
+static const uint8_t WIRE_TYPE_ECG     = 1;
+static const uint8_t WIRE_TYPE_VITALS  = 2;
+static const uint8_t WIRE_FLAG_LEADOFF = 0x01;
+static const uint8_t WIRE_FLAG_FINGER  = 0x02;
+
+static const size_t WIRE_HDR_BYTES     = 9;
+static const size_t WIRE_ECG_HDR_BYTES = 21;
+static const size_t WIRE_VITALS_BYTES  = 19;
+// worst case for n int16 samples
+inline size_t wireEcgMaxBytes(size_t n) { return WIRE_ECG_HDR_BYTES + 3 * n; }
+
+struct WireEcgFrame {
+  uint32_t tMs      = 0;
+  bool     leadsOff = false;
+  uint16_t fs       = 0;
+  uint64_t seq      = 0;
+  uint16_t count    = 0;
+};
+
+struct WireVitals {
+  uint32_t tMs    = 0;
+  bool     finger = false;
+  int      pulse  = -1;     // -1 = none (same conventions as the sensors)
+  int      spo2   = -1;
+  int      ecgBpm = -1;
+  float    pi     = 0.0f;
+  float    tempC  = NAN;    // NaN = none
+  uint16_t rrMs   = 0;
+  uint8_t  sqi    = 0;      // PPG signal quality 0..100
+};
+
+// Encoders return bytes written; the ECG encoder stops early (and sets the
+// count accordingly) if cap runs out. Return 0 if even the header does not fit.
+size_t wireEncodeEcg(uint8_t* out, size_t cap, const WireEcgFrame& hdr,
+                     const int16_t* samples, size_t n);
+size_t wireEncodeVitals(uint8_t* out, size_t cap, const WireVitals& v);
+
+// Decoders return false on a malformed or truncated frame.
+bool   wirePeekType(const uint8_t* in, size_t len, uint8_t& type);
+bool   wireDecodeEcg(const uint8_t* in, size_t len, WireEcgFrame& hdr,
+                     int16_t* out, size_t maxOut);
+bool   wireDecodeVitals(const uint8_t* in, size_t len, WireVitals& v);
+
+// Standard base64 (for binary frames inside text channels such as SSE).
+// Returns characters written (without NUL), 0 if cap is too small.
+size_t wireBase64(const uint8_t* in, size_t len, char* out, size_t cap);
@@ -1,6 +1,10 @@
 #include "sensor_ad8232.h"
+#include "util_stats.h"
 
 void AD8232Sensor::begin(uint8_t adcPin, uint16_t fs, int8_t loPlusPin, int8_t loMinusPin) {
+#ifdef ECG_ACQ_TIMER
+  if (_timer) esp_timer_stop(_timer);    // re-begin: stop the producer first
+#endif
   _adcPin = adcPin;
   _fs = fs;
   _dtMicros = 1000000UL / (fs ? fs : 250);
@@ -13,9 +17,31 @@ void AD8232Sensor::begin(uint8_t adcPin, uint16_t fs, int8_t loPlusPin, int8_t l
   analogReadResolution(12); // ESP32-C3 ADC: 0..4095
   // Optional: you can call analogSetAttenuation(ADC_11db) if using ESP32 classic; not on C3.
 
-  _head = 0; _count = 0; _hpPrevY = 0; _hpPrevX = 0; _lastRaw = 0;
+  if (_fs != ECG_SAMPLE_HZ) Serial.println("ECG: fs differs from ECG_SAMPLE_HZ, filter corners will be off");
+
+  _ring.reset(); _qrs.begin(_fs); _filterPrimed = false; _lastRaw = 0;
+#ifdef ENABLE_RTOS_TASKS
+  _raw.reset(); _rawNext = 0; _dspDropped = 0;
+#endif
+  _dropped = 0; _overruns = 0;
   _present = true;
   _nextMicros = micros() + _dtMicros;
+
+#ifdef ECG_ACQ_TIMER
+  if (!_timer) {
+    esp_timer_create_args_t args = {};
+    args.callback = &AD8232Sensor::_onTimer;
+    args.arg      = this;
+    args.name     = "ecg";
+    if (esp_timer_create(&args, &_timer) != ESP_OK) {
+      Serial.println("ECG: timer create failed, polling from loop()");
+      _timer = nullptr;
+      return;
+    }
+  }
+  _dueUs = esp_timer_get_time() + _dtMicros;
+  esp_timer_start_periodic(_timer, _dtMicros);
+#endif
 }
 
 inline int16_t AD8232Sensor::_readADC() const {
@@ -25,41 +51,107 @@ inline int16_t AD8232Sensor::_readADC() const {
   return (int16_t)v;
 }
 
-// One-pole digital high-pass: y[n] = α*(y[n-1] + x[n] - x[n-1])
-inline int16_t AD8232Sensor::_highpass(int16_t x) {
-  float y = ECG_HP_ALPHA * (_hpPrevY + (float)x - _hpPrevX);
-  _hpPrevY = y;
-  _hpPrevX = (float)x;
+void AD8232Sensor::_sample() {
+  STAT_SCOPE(STAT_ECG_SAMPLE);
+  int16_t raw = _readADC();
+  _lastRaw = raw;
 
-  // Center around 0 and scale down to int16
-  if (y > 2047.0f) y = 2047.0f;
-  if (y < -2048.0f) y = -2048.0f;
-  return (int16_t)y;
+  // Optional simple lead-off via saturation if no LO pins
+  bool off = leadsOff();
+
+#ifdef ENABLE_RTOS_TASKS
+  _raw.push(off ? RAW_OFF : raw);          // filtered later by process()
+#else
+  _filterOne(raw, off);
+#endif
 }
 
-inline void AD8232Sensor::_push(int16_t v) {
-  _ring[_head] = v;
-  _head = (_head + 1) % ECG_RING_SAMPLES;
-  if (_count < ECG_RING_SAMPLES) _count++;
+void AD8232Sensor::_filterOne(int16_t raw, bool off) {
+  int16_t y = 0;                         // flatline if leads off
+  if (off) {
+    _filterPrimed = false;
+  } else {
+    // start from steady state so reconnecting leads does not ring for seconds
+    if (!_filterPrimed) { _filter.reset(raw); _filterPrimed = true; }
+    y = _filter.process(raw);              // centred around 0
+  }
+  _qrs.process(y, _ring.head());
+  _ring.push(y);
 }
 
+#ifdef ECG_ACQ_TIMER
+// Runs in the high-priority esp_timer task. Each call owns one sample slot;
+// if the callback was held off for 2+ periods the missed slots are counted
+// as dropped and the schedule is realigned instead of bursting.
+void AD8232Sensor::_onTimer(void* arg) {
+  AD8232Sensor* self = static_cast<AD8232Sensor*>(arg);
+  int64_t dt   = self->_dtMicros;
+  int64_t late = esp_timer_get_time() - self->_dueUs;
+  if (late < -dt/2) return;              // extra catch-up call after a resync
+  if (late >= 2*dt) {
+    int64_t lost = late / dt;
+    self->_dropped += (uint32_t)lost;
+    self->_overruns++;
+    self->_dueUs += lost * dt;
+  }
+  self->_dueUs += dt;
+  self->_sample();
+}
+#endif
+
 void AD8232Sensor::update() {
   if (!_present) return;
+#ifdef ECG_ACQ_TIMER
+  if (_timer) return;                    // sampled from the timer callback
+#endif
 
   // Fixed-rate sampling via micros()
   uint32_t now = micros();
   if ((int32_t)(now - _nextMicros) < 0) return; // not yet time
-  // catch up if delayed
-  while ((int32_t)(now - _nextMicros) >= 0) _nextMicros += _dtMicros;
+  // catch up if delayed; every skipped period is a lost sample
+  _nextMicros += _dtMicros;
+  if ((int32_t)(now - _nextMicros) >= 0) {
+    uint32_t lost = 0;
+    while ((int32_t)(now - _nextMicros) >= 0) { _nextMicros += _dtMicros; lost++; }
+    _dropped += lost;
+    _overruns++;
+  }
 
-  int16_t raw = _readADC();
-  _lastRaw = raw;
+  _sample();
+}
 
-  // Optional simple lead-off via saturation if no LO pins
-  bool off = leadsOff();
+void AD8232Sensor::process() {
+#ifdef ENABLE_RTOS_TASKS
+  if (!_present) return;
+  STAT_SCOPE(STAT_ECG_DSP);
+  const size_t B = EcgFilter::BLOCK_MAX;
+  int16_t buf[B];
+  uint64_t first;
+  size_t n;
+  while ((n = _raw.readSince(_rawNext, buf, B, first)) > 0) {
+    // lapped by the sampler: keep indices aligned with a flatline gap
+    if (first > _rawNext) {
+      uint32_t lost = (uint32_t)(first - _rawNext);
+      _dspDropped += lost;
+      for (uint32_t i = 0; i < lost; i++) _filterOne(0, true);
+    }
+    _rawNext = first + n;
 
-  int16_t y = off ? 0 : _highpass(raw);  // flatline if leads off
-  _push(y);
+    // runs of connected samples go through the filter as blocks
+    size_t i = 0;
+    while (i < n) {
+      if (buf[i] == RAW_OFF) { _filterOne(0, true); i++; continue; }
+      size_t j = i;
+      while (j < n && buf[j] != RAW_OFF) j++;
+      if (!_filterPrimed) { _filter.reset(buf[i]); _filterPrimed = true; }
+      _filter.processBlock(buf + i, j - i);
+      for (; i < j; i++) {
+        _qrs.process(buf[i], _ring.head());
+        _ring.push(buf[i]);
+      }
+    }
+  }
+#endif
 }
 
 bool AD8232Sensor::leadsOff() const {
@@ -75,12 +167,5 @@ bool AD8232Sensor::leadsOff() const {
 
 size_t AD8232Sensor::getRecent(int16_t* out, size_t maxCount, bool& leadsOff) const {
   leadsOff = this->leadsOff();
-  size_t n = _count;
-  if (n > maxCount) n = maxCount;
-  // copy oldest -> newest
-  size_t start = (_head + ECG_RING_SAMPLES + ECG_RING_SAMPLES - n) % ECG_RING_SAMPLES;
-  for (size_t i = 0; i < n; i++) {
-    out[i] = _ring[(start + i) % ECG_RING_SAMPLES];
-  }
-  return n;
+  return _ring.readLatest(out, maxCount);   // oldest -> newest
 }
@@ -2,23 +2,60 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include "config.h"
+#include "util_seqring.h"
+#include "dsp_qrs.h"
+#include "dsp_biquad.h"
+#ifdef ECG_ACQ_TIMER
+#include <esp_timer.h>
+#endif
 
-// Simple ECG capture with ring buffer + high-pass filter
+// 0.5-40 Hz band-pass + mains notch, Q2.30 fixed point (see dsp_biquad.h)
+typedef BiquadHighpass<ECG_SAMPLE_HZ, 50, 71>                  EcgHighpass;
+typedef BiquadLowpass <ECG_SAMPLE_HZ, 4000, 71>                EcgLowpass;
+typedef BiquadNotch   <ECG_SAMPLE_HZ, ECG_MAINS_HZ * 100, 800> EcgNotch;
+typedef FilterChain<EcgHighpass, EcgLowpass, EcgNotch> EcgFilter;
+
+// Simple ECG capture with ring buffer + band-pass/notch filter.
+// With ECG_ACQ_TIMER the ADC is sampled from an esp_timer callback, so the
+// rate does not depend on how often loop() gets round to update().
+// With ENABLE_RTOS_TASKS the callback only stores raw samples; filtering and
+// QRS detection run in blocks from process() on the DSP task.
 class AD8232Sensor {
 public:
   void   begin(uint8_t adcPin = ECG_PIN, uint16_t fs = ECG_SAMPLE_HZ,
                int8_t loPlusPin = ECG_LOP_PIN, int8_t loMinusPin = ECG_LON_PIN);
-  void   update();                         // call from loop()
+  void   update();                         // call from loop() (no-op in timer mode)
+  void   process();                        // DSP step (ENABLE_RTOS_TASKS only)
   bool   present() const { return _present; }   // always true when begun
   float  sampleRate() const { return _fs; }
 
   // Read back the most recent N samples (oldest->newest). Returns count copied.
   size_t getRecent(int16_t* out, size_t maxCount, bool& leadsOff) const;
 
+  // Incremental reads: every sample has a monotonic index. Copies samples with
+  // index >= seq; `first` is the index of out[0] (> seq if some were lost).
+  // Safe from any task while the sampler is running.
+  size_t readSince(uint64_t seq, int16_t* out, size_t maxCount, uint64_t& first) const {
+    return _ring.readSince(seq, out, maxCount, first);
+  }
+  uint64_t sampleIndex() const { return _ring.head(); }   // index of the next sample
+
+  // QRS detection on the filtered stream
+  int      ecgBpm() const   { return _qrs.bpm(); }        // 0 if no recent beats
+  uint16_t lastRrMs() const { return _qrs.lastRrMs(); }
+  size_t   readBeats(uint64_t seq, QrsBeat* out, size_t maxCount, uint64_t& first) const {
+    return _qrs.beats().readSince(seq, out, maxCount, first);
+  }
+
   // Quick state
   bool   leadsOff() const;                 // based on LO pins or saturation
   int8_t pin() const { return _adcPin; }
 
+  // Acquisition health: sample slots that were never read, and how many
+  // stalls caused them.
+  uint32_t droppedSamples() const { return _dropped + _dspDropped; }
+  uint32_t overruns() const       { return _overruns; }
+
 private:
   // Config
   uint8_t _adcPin = ECG_PIN;
@@ -26,22 +63,39 @@ private:
   int8_t  _loMinusPin = ECG_LON_PIN;
 
   // Sampling
-  volatile size_t _head = 0;
-  volatile size_t _count = 0;
   uint16_t _fs = ECG_SAMPLE_HZ;
   uint32_t _dtMicros = 1000000UL / ECG_SAMPLE_HZ;
   uint32_t _nextMicros = 0;
+  volatile uint32_t _dropped  = 0;
+  volatile uint32_t _overruns = 0;
+
+#ifdef ECG_ACQ_TIMER
+  esp_timer_handle_t _timer = nullptr;
+  int64_t  _dueUs = 0;                     // nominal time of the next sample
+  static void _onTimer(void* arg);
+#endif
 
-  // Ring buffer (raw and filtered)
-  int16_t  _ring[ECG_RING_SAMPLES];
+  // Ring buffer (filtered), single producer / lock-free readers
+  SeqRing<int16_t, ECG_RING_SAMPLES> _ring;
+  QrsDetector _qrs;
   int16_t  _lastRaw = 0;
-  float    _hpPrevY = 0.0f;
-  float    _hpPrevX = 0.0f;
+  EcgFilter _filter;
+  bool     _filterPrimed = false;              // re-primed after leads-off
+
+#ifdef ENABLE_RTOS_TASKS
+  // raw samples from the timer callback to process(); leads-off as RAW_OFF
+  static const int16_t RAW_OFF = -1;
+  SeqRing<int16_t, ECG_RAW_SAMPLES> _raw;
+  uint64_t _rawNext = 0;
+  volatile uint32_t _dspDropped = 0;           // raw samples lapped before process()
+#else
+  static const uint32_t _dspDropped = 0;
+#endif
 
   bool     _present = false;
 
   // Helpers
   inline int16_t _readADC() const;
-  inline int16_t _highpass(int16_t x);
-  inline void    _push(int16_t v);
+  void           _sample();
+  void           _filterOne(int16_t raw, bool off);
 };
@@ -1,67 +1,337 @@
 // sensor_max30102.cpp
 #include "sensor_max30102.h"
+#include "util_stats.h"
 
-inline float Max30102Sensor::mean(const int32_t *a, int n){
-  long double s=0; for(int i=0;i<n;i++) s += a[i]; return (float)(s/n);
+// FIFO averaging and sample rate per mode (FIFO_CONFIG SMP_AVE, SPO2_CONFIG
+// SPO2_SR); 411 us pulses (18 bit) and the 16384 nA range throughout
+struct ModeCfg { uint8_t ave, sr; uint16_t sps; };
+static const ModeCfg MODES[] = {
+  { 2, 0, 50 },     // MODE_PROX:   50 sps / 4  = 12.5 Hz
+  { 1, 1, 100 },    // MODE_NORMAL: 100 sps / 2 = 50 Hz
+  { 2, 2, 200 },    // MODE_HIGH:   200 sps / 4 = 50 Hz
+};
+static const float LED_PULSE_S = 411e-6f;
+
+// FIFO almost-full interrupt (MAX30102_INT_PIN). The ISR only flags it;
+// poll() reads the status register, which releases INT.
+static void (*s_intHook)() = nullptr;
+#if MAX30102_INT_PIN >= 0
+static volatile bool s_intPending = false;
+
+static void IRAM_ATTR onInt() {
+  s_intPending = true;
+  if (s_intHook) s_intHook();
+}
+#endif
+
+void Max30102Sensor::onInterrupt(void (*hook)()) { s_intHook = hook; }
+
+// a raw sample as it would read at PPG_LED_INIT
+static inline int32_t atRefCurrent(int32_t x, uint8_t led) {
+  return led ? (int32_t)((int64_t)x * PPG_LED_INIT / led) : 0;
+}
+
+void Max30102Sensor::pushSample(const RawSample& s){
+  // the oldest pair leaves the window: take it out of the cross sums first
+  uint8_t bit = 1 << (_clipPos & 7);
+  uint8_t& bits = _clipBits[_clipPos >> 3];
+  if (_ir.full()) {
+    _sumRedIr -= (int64_t)_red.at(WIN - 1) * _ir.at(WIN - 1);
+    if (bits & bit) _clipped--;
+  }
+  _red.push(s.red);
+  _ir.push(s.ir);
+  _sumRedIr += (int64_t)s.red * s.ir;
+  if (s.clipped) { bits |= bit; _clipped++; } else bits &= ~bit;
+  _clipPos = (_clipPos + 1 == WIN) ? 0 : _clipPos + 1;
+  _rate.push(s.ir);
+  _rateSamples++;
 }
-inline float Max30102Sensor::stddev(const int32_t *a, int n, float m){
-  long double s=0; for(int i=0;i<n;i++){ long double d=a[i]-m; s+=d*d; }
-  return (float)sqrt((double)(s/(n>1?n-1:1)));
+
+// fresh windows after proximity mode
+void Max30102Sensor::clearWindow() {
+  _red.clear(); _ir.clear();
+  _sumRedIr = 0; _clipped = 0; _clipPos = 0;
+  memset(_clipBits, 0, sizeof(_clipBits));
+  _rate.reset(); _rateSamples = 0;
 }
-inline float Max30102Sensor::ac_rms(const int32_t *a, int n, float dc){
-  long double s=0; for(int i=0;i<n;i++){ long double d=a[i]-dc; s+=d*d; }
-  return (float)sqrt((double)(s/n));
+
+static inline float ramp(float x, float lo, float hi) {
+  return x <= lo ? 0.0f : (x >= hi ? 1.0f : (x - lo) / (hi - lo));
 }
 
-void Max30102Sensor::pushSample(int32_t red, int32_t ir){
-  _red[_head] = red;
-  _ir [_head] = ir;
-  _head = (_head + 1) % WIN;
-  if (_filled < WIN) _filled++;
+// Per-window quality from the running sums, once a second after the rate
+// estimate. Each part maps to 0..1; the SQI is the weakest of them, so one
+// bad property (motion decorrelating the channels, a saturated ADC, no
+// periodic pulse, too little perfusion) is enough to reject the window.
+void Max30102Sensor::updateSqi() {
+  int64_t n = _ir.count();
+  int64_t covRI = n * _sumRedIr - _red.sum() * _ir.sum();
+  int64_t varR  = n * _red.sumSq() - _red.sum() * _red.sum();
+  int64_t varI  = n * _ir.sumSq()  - _ir.sum()  * _ir.sum();
+  float corr = (varR > 0 && varI > 0) ? (float)covRI / sqrtf((float)varR * (float)varI) : 0.0f;
+
+  _sqiParts.perfusion   = ramp(_piEMA, 0.05f, 0.2f);
+  _sqiParts.correlation = ramp(corr, 0.5f, 0.9f);
+  _sqiParts.regularity  = ramp(_rate.confidence(), 0.3f, 0.7f);
+  _sqiParts.clipping    = 1.0f - ramp((float)_clipped / n, 0.0f, 0.05f);
+
+  float q = _sqiParts.perfusion;
+  if (_sqiParts.correlation < q) q = _sqiParts.correlation;
+  if (_sqiParts.regularity  < q) q = _sqiParts.regularity;
+  if (_sqiParts.clipping    < q) q = _sqiParts.clipping;
+  _sqi = (int)(q * 100.0f + 0.5f);
 }
 
-bool Max30102Sensor::detectPeak(float meanIR, float sdIR, int p, int m, int n) const {
-  int32_t a=_ir[p], b=_ir[m], c=_ir[n];
+// three-point local max on the IR window, centred one sample back
+bool Max30102Sensor::detectPeak(float meanIR, float sdIR) const {
+  int32_t a=_ir.at(2), b=_ir.at(1), c=_ir.at(0);
   float thr = meanIR + 0.5f * sdIR;
   return (b>a) && (b>c) && (b>thr);
 }
 
-void Max30102Sensor::begin(TwoWire& bus) {
-  (void)bus;
-  _ok = _dev.begin(Wire, I2C_SPEED_STANDARD);
-  if (_ok) {
-    // ledBrightness, sampleAverage, ledMode(2=RED+IR), sampleRate, pulseWidth, adcRange
-    _dev.setup(80, 4, 2, 50, 411, 16384);
+// HR peak detect after each sample; tMs is when it was taken
+void Max30102Sensor::peakAt(uint32_t tMs) {
+  if (!_hasFinger || _ir.count() < WIN/2) return;
+  if (!detectPeak(_ir.mean(), _ir.stddev())) return;
+  uint32_t dt = tMs - _lastPeakMs;
+  if (dt > 300 && dt < 2000 && _lastPeakMs != 0) {
+    _bpm = 60000.0f / (float)dt;
+    _bpmEMA = (_bpmEMA == 0.0f) ? _bpm : (_bpmAlpha*_bpm + (1.0f - _bpmAlpha)*_bpmEMA);
+  }
+  _lastPeakMs = tMs;
+}
+
+void Max30102Sensor::begin(I2CBus& bus) {
+  _bus = &bus;
+  uint8_t id = 0;
+  _ok = _bus->readRegs(I2CBus::DEV_MAX30102, ADDR, REG_PART_ID, &id, 1) && id == 0x15;
+  if (!_ok) return;
+
+  // soft reset, then wait for the bit to clear
+  _bus->writeReg(I2CBus::DEV_MAX30102, ADDR, REG_MODE, 0x40);
+  uint8_t mode = 0x40;
+  for (int i = 0; i < 10 && (mode & 0x40); i++) {
+    delay(2);
+    _bus->readRegs(I2CBus::DEV_MAX30102, ADDR, REG_MODE, &mode, 1);
   }
-  _lastTick = millis();
+
+  setMode(MODE_NORMAL);
+  setLeds(PPG_LED_INIT, PPG_LED_INIT);
+  const uint8_t clr[4] = { REG_FIFO_WR, 0, 0, 0 };                  // WR, OVF, RD = 0
+  _bus->write(I2CBus::DEV_MAX30102, ADDR, clr, sizeof(clr));
+  _bus->writeReg(I2CBus::DEV_MAX30102, ADDR, REG_MODE, 0x03);       // SpO2: red + IR
+
+#if MAX30102_INT_PIN >= 0
+  // A_FULL only; PWR_RDY holds INT low until the first status read
+  _bus->writeReg(I2CBus::DEV_MAX30102, ADDR, REG_INT_EN1, 0x80);
+  pinMode(MAX30102_INT_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(MAX30102_INT_PIN), onInt, FALLING);
+#endif
 }
 
 void Max30102Sensor::update() {
+  poll();
+  process();
+}
+
+void Max30102Sensor::setMode(Mode m) {
+  const ModeCfg& c = MODES[m];
+  // rollover, almost-full at 17
+  _bus->writeReg(I2CBus::DEV_MAX30102, ADDR, REG_FIFO_CFG, (c.ave << 5) | 0x10 | 0x0F);
+  _bus->writeReg(I2CBus::DEV_MAX30102, ADDR, REG_SPO2_CFG, (3 << 5) | (c.sr << 2) | 3);
+  if (_mode == MODE_PROX && m != MODE_PROX) _wakeSeq++;
+  _mode = m;
+}
+
+void Max30102Sensor::setLeds(uint8_t red, uint8_t ir) {
+  const uint8_t pa[3] = { REG_LED1_PA, red, ir };
+  _bus->write(I2CBus::DEV_MAX30102, ADDR, pa, sizeof(pa));
+  _ledRed = red;
+  _ledIr = ir;
+}
+
+const char* Max30102Sensor::modeName(Mode m) {
+  return m == MODE_PROX ? "proximity" : m == MODE_HIGH ? "high" : "normal";
+}
+int   Max30102Sensor::sampleRate() const { return MODES[_mode].sps; }
+float Max30102Sensor::ledAvgMa() const {
+  return sampleRate() * LED_PULSE_S * (ledRedMa() + ledIrMa());
+}
+
+// One AGC step: scale the current so the raw DC lands on PPG_DC_TARGET
+// (reflected light is close to linear in LED current). Only outside the
+// PPG_DC_LOW..PPG_DC_HIGH band, so a settled current stays put; a clipped
+// channel is taken as full scale.
+static uint8_t agcStep(uint8_t led, int32_t dc, bool clipped) {
+  if (clipped) dc = 0x3FFFF;
+  else if (dc >= PPG_DC_LOW && dc <= PPG_DC_HIGH) return led;
+  int32_t next = dc > 0 ? (int32_t)((int64_t)led * PPG_DC_TARGET / dc) : PPG_LED_MAX;
+  return (uint8_t)constrain(next, (int32_t)PPG_LED_MIN, (int32_t)PPG_LED_MAX);
+}
+
+// LED current and mode from the raw samples read since the last step. Runs
+// in poll() right after the FIFO was drained, so every sample taken at the
+// old settings has already been scaled with them.
+void Max30102Sensor::control() {
+  uint32_t now = millis();
+  if (_mode == MODE_PROX) {
+    // any poll's worth of samples: the IR level alone decides
+    bool finger = atRefCurrent((int32_t)(_accIr / _accN), _ledIr) >= DC_NOFINGER;
+    _accRed = _accIr = 0; _accN = _accClipRed = _accClipIr = 0;
+    if (finger) {
+      _noFingerMs = 0;
+      setLeds(_measRed, _measIr);
+      setMode(_wantHigh ? MODE_HIGH : MODE_NORMAL);
+    }
+    return;
+  }
+  if (_accN < SAMPLE_HZ) return;                 // once a second of samples
+  int32_t dcRed = (int32_t)(_accRed / _accN), dcIr = (int32_t)(_accIr / _accN);
+  bool clipRed = _accClipRed > 0, clipIr = _accClipIr > 0;
+  _accRed = _accIr = 0; _accN = _accClipRed = _accClipIr = 0;
+
+  // same gate as hasFinger(), on this second alone
+  bool finger = atRefCurrent(dcRed, _ledRed) >= DC_NOFINGER &&
+                atRefCurrent(dcIr, _ledIr) >= DC_NOFINGER;
+  if (!finger) {
+    if (_noFingerMs == 0) _noFingerMs = now;
+#ifdef PPG_POWER_MODES
+    if (now - _noFingerMs >= PPG_PROX_AFTER_MS) {
+      _measRed = _ledRed; _measIr = _ledIr;
+      setLeds(0, PPG_PROX_LED);
+      setMode(MODE_PROX);
+    }
+#endif
+    return;                                      // nothing to steer towards
+  }
+  _noFingerMs = 0;
+
+#ifdef PPG_POWER_MODES
+  Mode want = _wantHigh ? MODE_HIGH : MODE_NORMAL;
+  if (want != _mode) setMode(want);
+#endif
+#ifdef PPG_AGC
+  uint8_t red = agcStep(_ledRed, dcRed, clipRed);
+  uint8_t ir  = agcStep(_ledIr, dcIr, clipIr);
+  if (red != _ledRed || ir != _ledIr) setLeds(red, ir);
+#else
+  (void)clipRed; (void)clipIr;
+#endif
+}
+
+void Max30102Sensor::poll() {
+  if (!_ok) return;
+#if MAX30102_INT_PIN >= 0
+  // INT is level, active low: a missed edge still shows on the pin
+  if (!s_intPending && digitalRead(MAX30102_INT_PIN) != LOW &&
+      millis() - _lastPollMs < MAX30102_INT_POLL_MS) return;
+  s_intPending = false;
+#else
+  // proximity: a few samples a second are enough to notice a finger
+  if (_mode == MODE_PROX && millis() - _lastPollMs < PPG_PROX_POLL_MS) return;
+#endif
+  _lastPollMs = millis();
+  STAT_SCOPE(STAT_SPO2_POLL);
+
+  // WR_PTR, OVF_COUNTER, RD_PTR in one read; with INT also the status
+  // registers in front of them, whose read releases the pin
+#if MAX30102_INT_PIN >= 0
+  uint8_t regs[7];
+  if (!_bus->readRegs(I2CBus::DEV_MAX30102, ADDR, REG_INT_STATUS, regs, 7)) return;
+  const uint8_t* ptr = regs + (REG_FIFO_WR - REG_INT_STATUS);
+#else
+  uint8_t ptr[3];
+  if (!_bus->readRegs(I2CBus::DEV_MAX30102, ADDR, REG_FIFO_WR, ptr, 3)) return;
+#endif
+  int pending = (ptr[0] - ptr[2]) & (FIFO_DEPTH - 1);
+  if (ptr[1]) {                          // full and overwriting: all 32 are valid
+    _fifoOverflows += ptr[1];
+    pending = FIFO_DEPTH;
+  }
+  if (!pending) return;
+
+  // all pending samples in one burst; reading FIFO_DATA advances RD_PTR
+  uint8_t buf[FIFO_DEPTH * SAMPLE_BYTES];
+  if (!_bus->readRegs(I2CBus::DEV_MAX30102, ADDR, REG_FIFO_DATA, buf, pending * SAMPLE_BYTES)) return;
+  for (int i = 0; i < pending; i++) {
+    const uint8_t* p = buf + i * SAMPLE_BYTES;
+    int32_t red = (int32_t)(((uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2]) & 0x3FFFF);
+    int32_t ir  = (int32_t)(((uint32_t)p[3] << 16 | (uint32_t)p[4] << 8 | p[5]) & 0x3FFFF);
+    _accRed += red; _accIr += ir; _accN++;
+    if (red >= CLIP_LEVEL) _accClipRed++;
+    if (ir  >= CLIP_LEVEL) _accClipIr++;
+    if (_mode == MODE_PROX) continue;            // proximity samples stay here
+    RawSample s;
+    s.red = atRefCurrent(red, _ledRed);
+    s.ir  = atRefCurrent(ir, _ledIr);
+    s.clipped = red >= CLIP_LEVEL || ir >= CLIP_LEVEL;
+    _raw.push(s);
+  }
+  control();
+}
+
+void Max30102Sensor::process() {
   if (!_ok) return;
+  STAT_SCOPE(STAT_SPO2_DSP);
 
-  // drain FIFO
-  _dev.check();
-  while (_dev.available()) {
-    long red = _dev.getFIFORed();
-    long ir  = _dev.getFIFOIR();
-    _dev.nextSample();
-    pushSample((int32_t)red, (int32_t)ir);
+  // back from proximity: the windows still hold the empty sensor
+  if (_wakeSeen != _wakeSeq) {
+    _wakeSeen = _wakeSeq;
+    clearWindow();
   }
 
-  // compute cadence
-  if (millis() - _lastTick < _periodMs) return;
-  _lastTick += _periodMs;
+  RawSample s[16];
+  uint64_t first;
+  size_t n;
+  bool fresh = false;
+  uint32_t now = millis();
+  while ((n = _raw.readSince(_rawNext, s, 16, first)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      pushSample(s[i]);
+      // FIFO bursts: date each sample back from the newest one read
+      uint64_t behind = _raw.head() - (first + i) - 1;
+      peakAt(now - (uint32_t)(behind * 1000 / SAMPLE_HZ));
+    }
+    _rawNext = first + n;
+    fresh = true;
+  }
 
-  if (_filled < WIN/2) return;
+  // nothing new (proximity mode, or a DSP tick between FIFO samples)
+  if (!fresh || _ir.count() < WIN/2) return;
 
-  float dcRed = mean(_red, _filled);
-  float dcIR  = mean(_ir,  _filled);
-  float sdIR  = stddev(_ir, _filled, dcIR);
-  float acRed = ac_rms(_red, _filled, dcRed);
-  float acIR  = ac_rms(_ir,  _filled, dcIR);
+  float dcRed = _red.mean();
+  float dcIR  = _ir.mean();
+  float acRed = _red.acRms();
+  float acIR  = _ir.acRms();
 
   _hasFinger = !(dcIR < DC_NOFINGER || dcRed < DC_NOFINGER);
-  if (!_hasFinger) { _bpm=0; _bpmEMA=0; _lastPeakMs=0; }
+  if (!_hasFinger) {
+    _bpm=0; _bpmEMA=0; _lastPeakMs=0;
+    _rate.reset(); _rateGoodMs=0;
+    _sqi = 0; _spo2GoodMs = 0;
+    _poorMs = 0; _wantHigh = false;
+  }
+
+  // windowed rate and signal quality, once a second of samples
+  if (_hasFinger && _rateSamples >= SAMPLE_HZ) {
+    _rateSamples = 0;
+    {
+      STAT_SCOPE(STAT_PPG_RATE);
+      _rate.update();
+    }
+    updateSqi();
+#ifdef PPG_POWER_MODES
+    // more averaging while the quality is poor (a full window, so not
+    // just because the estimate is still filling up)
+    if (_ir.full() && _sqi < SQI_MIN) _poorMs = millis();
+    _wantHigh = _poorMs != 0 && millis() - _poorMs < PPG_HIGH_HOLD_MS;
+#endif
+    if (_sqi >= SQI_MIN && _rate.confidence() >= PPG_RATE_MIN_CONF) {
+      _rateBpm = _rate.bpm();
+      _rateGoodMs = millis();
+    }
+  }
 
   // SpO2 via ratio-of-ratios
   float R = (acRed/dcRed) / (acIR/dcIR);
@@ -69,22 +339,7 @@ void Max30102Sensor::update() {
   if (spo2 > 100) spo2 = 100;
   if (spo2 < 0 || !_hasFinger) spo2 = NAN;
   _spo2 = spo2;
-
-  // HR peak detect
-  if (_hasFinger && _filled >= 3) {
-    int mid  = (_head - 2 + WIN) % WIN;
-    int prev = (mid - 1 + WIN) % WIN;
-    int next = (mid + 1) % WIN;
-    if (detectPeak(dcIR, sdIR, prev, mid, next)) {
-      uint32_t now = millis();
-      uint32_t dt  = now - _lastPeakMs;
-      if (dt > 300 && dt < 2000 && _lastPeakMs != 0) {
-        _bpm = 60000.0f / (float)dt;
-        _bpmEMA = (_bpmEMA == 0.0f) ? _bpm : (_bpmAlpha*_bpm + (1.0f - _bpmAlpha)*_bpmEMA);
-      }
-      _lastPeakMs = now;
-    }
-  }
+  if (!isnan(spo2) && _sqi >= SQI_MIN) { _spo2Good = spo2; _spo2GoodMs = millis(); }
 
   // PI with guard + clamp + smoothing + hold
   float piRaw = (_hasFinger && dcIR > DC_PI_GUARD) ? (acIR / dcIR) * 100.0f : 0.0f;
@@ -96,9 +351,8 @@ void Max30102Sensor::update() {
   if (millis() - _lastGoodPIMs > PI_HOLD_MS) _piEMA = 0.0f;
 
   // Serial debug (optional)
-  // int lastIdx = (_head - 1 + WIN) % WIN;
   // Serial.printf("IR:%ld RED:%ld SpO2:%s BPM:%s PI:%.1f%%\n",
-  //   (long)_ir[lastIdx], (long)_red[lastIdx],
+  //   (long)_ir.at(0), (long)_red.at(0),
   //   isnan(_spo2)?"--":String(_spo2,1).c_str(),
   //   (_bpmEMA==0.0f)?"--":String((int)(_bpmEMA+0.5f)).c_str(),
   //   _piEMA);
@@ -108,12 +362,22 @@ bool  Max30102Sensor::beatRecently() const {
   return _hasFinger && _lastPeakMs != 0 && (millis() - _lastPeakMs) <= 2000;
 }
 int   Max30102Sensor::bpmRounded() const {
-  if (!beatRecently()) return -1;
+#ifdef PPG_RATE_ACF
+  // last confident estimate, held for PPG_RATE_HOLD_MS
+  if (!_hasFinger || _rateGoodMs == 0 || millis() - _rateGoodMs > PPG_RATE_HOLD_MS) return -1;
+  return (int)(_rateBpm + 0.5f);
+#else
+  return peakBpmRounded();
+#endif
+}
+int   Max30102Sensor::peakBpmRounded() const {
+  if (!beatRecently() || _sqi < SQI_MIN) return -1;
   return (int)(_bpmEMA + 0.5f);
 }
+// last value taken at SQI >= SQI_MIN, held for SQI_HOLD_MS
 int   Max30102Sensor::spo2Rounded() const {
-  if (isnan(_spo2)) return -1;
-  return (int)(_spo2 + 0.5f);
+  if (!_hasFinger || _spo2GoodMs == 0 || millis() - _spo2GoodMs > SQI_HOLD_MS) return -1;
+  return (int)(_spo2Good + 0.5f);
 }
 float Max30102Sensor::perfusionIndex() const {
   return _piEMA; // already smoothed & held
@@ -1,43 +1,138 @@
 // sensor_max30102.h
 #pragma once
 #include <Arduino.h>
-#include <Wire.h>    
 #include "config.h"
+#include "dsp_winstats.h"
+#include "dsp_pulserate.h"
+#include "util_seqring.h"
+#include "util_i2cbus.h"
 
-// keep SparkFun header isolated to avoid macro/size conflicts
-#ifdef I2C_BUFFER_LENGTH
-  #undef I2C_BUFFER_LENGTH
-#endif
-#include <MAX30105.h>
-
+// MAX30102 pulse oximeter, register-level driver on the shared I2CBus.
+// Red+IR (SpO2 mode), 50 Hz out of the FIFO while measuring. poll() reads
+// the FIFO pointers and then all pending samples in one burst: two
+// transactions per poll however many samples are waiting.
+//
+// poll() also owns the chip's configuration: the LED current loop
+// (PPG_AGC) and the power modes (PPG_POWER_MODES). Samples are scaled back
+// to the PPG_LED_INIT current before they reach the DSP, so a current step
+// does not show up as a step in the windows.
 class Max30102Sensor {
 public:
-  void   begin(TwoWire& bus);
-  void   update();
+  void   begin(I2CBus& bus);
+  void   update();                  // poll() + process() (scheduled at 50 Hz)
+
+  // Split for ENABLE_RTOS_TASKS: poll() drains the FIFO into a raw ring on
+  // the acquisition task, process() consumes it on the DSP task.
+  // With MAX30102_INT_PIN, poll() does no bus traffic until INT is asserted
+  // (or MAX30102_INT_POLL_MS passed), so it can be called as often as
+  // convenient, and process() dates each sample of a burst back from the
+  // newest one.
+  void   poll();
+  void   process();
+
+  // Called from the INT ISR after the pending flag is set, e.g. to wake the
+  // acquisition task. Must be IRAM-safe and use FromISR calls only.
+  static void onInterrupt(void (*hook)());
 
    bool   present()   const { return _ok; }
 
   bool   hasFinger() const { return _hasFinger; }
-  bool   beatRecently() const;
+  bool   beatRecently() const;    // peak detector saw a beat in the last 2 s
   int    bpmRounded() const;      // -1 if not valid
+  float  pulseConfidence() const { return _rate.confidence(); }  // last estimate, 0..1
+  int    peakBpmRounded() const;  // legacy peak-detector rate, -1 if not valid
   int    spo2Rounded() const;     // -1 if not valid
   float  perfusionIndex() const;  // smoothed PI (0..~30)
 
+  // Signal quality 0..100 (updated once a second, 0 without a finger): the
+  // weakest of the four scores below. Below SQI_MIN the pulse rate and SpO2
+  // are not updated; the last good values are held, then hidden.
+  struct SqiParts {
+    float perfusion;      // PI in the usable range
+    float correlation;    // red/IR correlation over the window
+    float regularity;     // beat-to-beat similarity (autocorrelation peak)
+    float clipping;       // 1 = no samples at ADC full scale
+  };
+  int    signalQuality() const { return _sqi; }
+  const SqiParts& sqiParts() const { return _sqiParts; }
+  uint32_t fifoOverflows() const { return _fifoOverflows; }   // samples lost in the chip
+
+  // proximity: no finger, IR only at PPG_PROX_LED, 50 sps / 4, polled every
+  // PPG_PROX_POLL_MS. normal: 100 sps / 2. high: 200 sps / 4 while the SQI
+  // is poor (more samples averaged into the same 50 Hz).
+  enum Mode : uint8_t { MODE_PROX, MODE_NORMAL, MODE_HIGH };
+  Mode   mode() const { return (Mode)_mode; }
+  static const char* modeName(Mode m);
+  int    sampleRate() const;      // LED pulses per second and channel
+  float  ledRedMa() const { return _ledRed * 0.2f; }
+  float  ledIrMa()  const { return _ledIr * 0.2f; }
+  float  ledAvgMa() const;        // mean LED supply current (pulse duty x current)
+
+  // Red/IR samples with a monotonic index (~1.2 s kept), e.g. for a pleth
+  // trace, referred to the PPG_LED_INIT current. clipped: the ADC was at
+  // full scale. Same semantics as SeqRing::readSince.
+  struct RawSample { int32_t red, ir; bool clipped; };
+  size_t   readRaw(uint64_t seq, RawSample* out, size_t maxCount, uint64_t& first) const {
+    return _raw.readSince(seq, out, maxCount, first);
+  }
+  uint64_t rawIndex() const { return _raw.head(); }
+  static const int SAMPLE_HZ = 50;
+
 private:
-  MAX30105 _dev;
+  static const uint8_t ADDR = 0x57;
+  // registers
+  static const uint8_t REG_INT_STATUS = 0x00;  // status 1/2, enable 1/2, then the FIFO pointers
+  static const uint8_t REG_INT_EN1   = 0x02;
+  static const uint8_t REG_FIFO_WR   = 0x04;   // WR_PTR, OVF_COUNTER, RD_PTR follow
+  static const uint8_t REG_FIFO_DATA = 0x07;
+  static const uint8_t REG_FIFO_CFG  = 0x08;
+  static const uint8_t REG_MODE      = 0x09;
+  static const uint8_t REG_SPO2_CFG  = 0x0A;
+  static const uint8_t REG_LED1_PA   = 0x0C;   // red
+  static const uint8_t REG_LED2_PA   = 0x0D;   // IR
+  static const uint8_t REG_PART_ID   = 0xFF;
+  static const int     FIFO_DEPTH    = 32;
+  static const int     SAMPLE_BYTES  = 6;      // 3 bytes red + 3 bytes IR
+
+  I2CBus*  _bus = nullptr;
   bool     _ok = false;
+  volatile uint32_t _fifoOverflows = 0;
+
+  static const int WIN = 200; // 4s @ 50Hz
+  WindowStats<WIN> _red;      // running DC/AC stats, O(1) per sample
+  WindowStats<WIN> _ir;
+  int64_t  _sumRedIr = 0;       // sum of red*ir over the window, kept with the stats
+  int      _clipped = 0;        // samples in the window at ADC full scale
+  uint8_t  _clipBits[WIN / 8] = {};   // per-sample clip flags, slot _clipPos is next
+  int      _clipPos = 0;
+  static const int32_t CLIP_LEVEL = 0x3FF00;   // 18-bit full scale minus margin
+
+  // LED current and mode, written by poll() only; process() asks for the
+  // high rate through _wantHigh and notices a wake-up through _wakeSeq
+  volatile uint8_t _mode = MODE_NORMAL;
+  volatile uint8_t _wakeSeq = 0;      // bumped when proximity ends
+  uint8_t  _wakeSeen = 0;
+  volatile bool _wantHigh = false;
+  uint8_t  _ledRed = PPG_LED_INIT, _ledIr = PPG_LED_INIT;    // as programmed
+  uint8_t  _measRed = PPG_LED_INIT, _measIr = PPG_LED_INIT;  // kept across proximity
+  // raw sums since the last control step (poll() side)
+  int64_t  _accRed = 0, _accIr = 0;
+  int      _accN = 0, _accClipRed = 0, _accClipIr = 0;
+  uint32_t _noFingerMs = 0;           // 0 = finger seen in the last step
+  uint32_t _lastPollMs = 0;
+  uint32_t _poorMs = 0;               // last window below SQI_MIN (process() side)
 
-  static const int WIN = 100; // 2s @ 50Hz
-  int32_t _red[WIN]  = {0};
-  int32_t _ir[WIN]   = {0};
-  int     _head      = 0;
-  int     _filled    = 0;
+  SeqRing<RawSample, 64> _raw;    // > FIFO depth (32), ~1.2 s at 50 Hz
+  uint64_t _rawNext = 0;
 
-  uint32_t _lastTick = 0;
-  const uint32_t _periodMs = 1000/50; // 50 Hz compute
   bool     _hasFinger = false;
 
-  // HR
+  // HR: autocorrelation once a second (PPG_RATE_ACF); the peak detector
+  // still drives beatRecently()
+  PulseRateEstimator _rate;
+  int      _rateSamples = 0;
+  float    _rateBpm = 0.0f;           // last confident estimate
+  uint32_t _rateGoodMs = 0;
   uint32_t _lastPeakMs = 0;
   float    _bpm = 0.0f;
   float    _bpmEMA = 0.0f;
@@ -49,12 +144,20 @@ private:
 
   // cache of outputs
   float    _spo2 = NAN;
+  float    _spo2Good = NAN;         // last value with SQI >= SQI_MIN
+  uint32_t _spo2GoodMs = 0;
 
-  // helpers
-  static inline float mean(const int32_t *a, int n);
-  static inline float stddev(const int32_t *a, int n, float m);
-  static inline float ac_rms(const int32_t *a, int n, float dc);
+  // signal quality
+  int      _sqi = 0;
+  SqiParts _sqiParts = {0, 0, 0, 0};
 
-  void pushSample(int32_t red, int32_t ir);
-  bool detectPeak(float meanIR, float sdIR, int idxPrev, int idxMid, int idxNext) const;
+  // helpers
+  void pushSample(const RawSample& s);
+  void peakAt(uint32_t tMs);
+  void clearWindow();
+  bool detectPeak(float meanIR, float sdIR) const;
+  void updateSqi();
+  void control();
+  void setMode(Mode m);
+  void setLeds(uint8_t red, uint8_t ir);
 };
@@ -1,11 +1,11 @@
 #pragma once
 #include <Arduino.h>
-#include <Wire.h>
+#include "util_i2cbus.h"
 
 class Max30205Sensor {
 public:
-  void  begin(TwoWire& bus);
-  void  update();                 // call periodically
+  void  begin(I2CBus& bus);
+  void  update();                 // reads once per call (scheduled every 500 ms)
 
   // presence vs. validity
   bool  present() const { return _present; }     // detected at startup
@@ -13,11 +13,10 @@ public:
   float tempC()   const { return _tempC; }
 
 private:
-  TwoWire* _bus = nullptr;
+  I2CBus*  _bus = nullptr;
   bool     _present = false;   // device found at boot
   bool     _valid   = false;   // have a recent valid sample
   uint8_t  _addr    = 0x48;
-  uint32_t _lastMs  = 0;
   uint32_t _lastGoodMs = 0;
   float    _tempC   = NAN;
 
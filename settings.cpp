@@ -23,3 +23,9 @@ void Settings::clearWifi() {
   _prefs.remove("ssid");
   _prefs.remove("pass");
 }
+
+uint32_t Settings::nextBootId() {
+  uint32_t id = _prefs.getUInt("boot", 0) + 1;
+  _prefs.putUInt("boot", id);
+  return id;
+}
@@ -14,6 +14,7 @@ public:
   WifiCreds getWifi();                         // read saved creds (if any)
   void saveWifi(const String& ssid, const String& pass); // write creds
   void clearWifi();                            // delete creds
+  uint32_t nextBootId();                       // persistent boot counter
 private:
   Preferences _prefs;
   const char* NS = "cfg";
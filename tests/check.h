@@ -0,0 +1,26 @@
+// tests/check.h
+#pragma once
+#include <stdio.h>
+#include <math.h>
+
+// Minimal assertions for the host tests (ctest): a failed check prints
+// where and what, and main() returns checkResult().
+static int g_checkFailures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { g_checkFailures++; \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } \
+  } while (0)
+
+#define CHECK_NEAR(a, b, tol) do { \
+    double _a = (a), _b = (b); \
+    if (!(fabs(_a - _b) <= (tol))) { g_checkFailures++; \
+      fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g (tol %g)\n", \
+              __FILE__, __LINE__, #a, #b, _a, _b, (double)(tol)); } \
+  } while (0)
+
+static inline int checkResult(const char* name) {
+  if (g_checkFailures) fprintf(stderr, "%s: %d check(s) failed\n", name, g_checkFailures);
+  else                 printf("%s: ok\n", name);
+  return g_checkFailures ? 1 : 0;
+}
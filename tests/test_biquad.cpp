@@ -0,0 +1,101 @@
+// tests/test_biquad.cpp
+// EcgFilter (dsp_biquad.h) response at ECG_SAMPLE_HZ: pass band, the
+// 0.5 Hz and 40 Hz corners, the mains notch, no DC out, a primed start
+// without a step, block filtering bit-exact with per-sample, and the Q2.30
+// chain against the same stages in double.
+#include <Arduino.h>
+#include <math.h>
+#include <vector>
+#include "sensor_ad8232.h"
+#include "check.h"
+
+static const double FS = ECG_SAMPLE_HZ;
+
+// steady-state gain in dB for a 1000-count sine around mid-scale
+static double gainDb(double hz) {
+  EcgFilter f;
+  f.reset(2048);
+  const int settle = (int)(10 * FS), len = (int)(10 * FS);
+  double sum = 0;
+  for (int i = 0; i < settle + len; i++) {
+    int16_t x = (int16_t)lround(2048 + 1000 * sin(2 * M_PI * hz * i / FS));
+    int16_t y = f.process(x);
+    if (i >= settle) sum += (double)y * y;
+  }
+  return 20 * log10(sqrt(sum / len) / (1000 / sqrt(2.0)));
+}
+
+struct DoubleBiquad {
+  double b0, b1, b2, a1, a2, x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+  explicit DoubleBiquad(const BiquadCoeffs& c)
+    : b0(c.b0 / 1073741824.0), b1(c.b1 / 1073741824.0), b2(c.b2 / 1073741824.0),
+      a1(c.a1 / 1073741824.0), a2(c.a2 / 1073741824.0) {}
+  double run(double x) {
+    double y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+    x2 = x1; x1 = x; y2 = y1; y1 = y;
+    return y;
+  }
+};
+
+int main() {
+  double g1 = gainDb(1), g10 = gainDb(10), g05 = gainDb(0.5), g40 = gainDb(40), gMains = gainDb(ECG_MAINS_HZ);
+  printf("gain dB: 0.5 Hz %.2f  1 Hz %.2f  10 Hz %.2f  40 Hz %.2f  %d Hz %.1f\n",
+         g05, g1, g10, g40, ECG_MAINS_HZ, gMains);
+  CHECK_NEAR(g10, 0.0, 0.2);
+  CHECK_NEAR(g05, -3.0, 0.5);
+  CHECK_NEAR(g40, -3.0, 1.5);               // the notch skirt adds a little at 50 Hz mains
+  CHECK(gMains < -40);
+
+  // DC in, nothing out; a primed filter does not step at the start
+  {
+    EcgFilter f;
+    f.reset(3000);
+    int maxAbs = 0;
+    for (int i = 0; i < 10 * FS; i++) { int y = f.process(3000); if (abs(y) > maxAbs) maxAbs = abs(y); }
+    CHECK(maxAbs == 0);
+    EcgFilter g;
+    g.reset(1000);
+    for (int i = 0; i < 5 * FS; i++) g.process(3000);   // a 2000-count step decays
+    int y = g.process(3000);
+    CHECK(abs(y) <= 1);
+  }
+
+  // processBlock == process, with block sizes that straddle BLOCK_MAX
+  {
+    std::vector<int16_t> in(20000);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < in.size(); i++) {
+      seed = seed * 1664525u + 1013904223u;
+      in[i] = (int16_t)(2048 + 900 * sin(2 * M_PI * 1.2 * i / FS) + (int)(seed >> 24) - 128);
+    }
+    EcgFilter a, b;
+    a.reset(in[0]); b.reset(in[0]);
+    std::vector<int16_t> blk(in);
+    const size_t sizes[] = { 1, 7, 64, 65, 200 };
+    size_t i = 0, k = 0;
+    while (i < blk.size()) {
+      size_t n = sizes[k++ % 5];
+      if (n > blk.size() - i) n = blk.size() - i;
+      b.processBlock(&blk[i], n);
+      i += n;
+    }
+    int diff = 0;
+    for (size_t j = 0; j < in.size(); j++) if (a.process(in[j]) != blk[j]) diff++;
+    CHECK(diff == 0);
+
+    // fixed point tracks the same stages in double (Q4 in, int12 out)
+    EcgFilter fx;
+    fx.reset(in[0]);
+    DoubleBiquad hp(EcgHighpass::coeffs()), lp(EcgLowpass::coeffs()), notch(EcgNotch::coeffs());
+    double worst = 0;
+    for (size_t j = 0; j < in.size(); j++) {
+      double x = in[j] - in[0];                  // the primed chain starts from in[0]
+      double ref = notch.run(lp.run(hp.run(x)));
+      double d = fabs(fx.process(in[j]) - ref);
+      if (j > FS && d > worst) worst = d;
+    }
+    printf("fixed vs double: max %.2f counts\n", worst);
+    CHECK(worst < 2.0);                         // the int12 output is floored
+  }
+  return checkResult("biquad");
+}
@@ -0,0 +1,61 @@
+// tests/test_host_rig.cpp
+// The host build is only useful for regression tests if a replay is
+// deterministic: two runs of the same fixture must give the same readings
+// second by second. Also checks that the rig reaches the generators' truth.
+#include <Arduino.h>
+#include <vector>
+#include "host_rig.h"
+#include "check.h"
+
+struct Second { int bpm, spo2, ecgBpm, sqi; float pi, tempC; uint64_t ppgN, ecgN; };
+
+static std::vector<Second> replay(int seconds) {
+  SynthPpgParams pp;  pp.bpm = 72; pp.spo2 = 97; pp.pi = 2;
+  SynthEcgParams ep;  ep.bpm = 72;
+  SynthPpg ppg(pp);
+  SynthEcg ecg(ep);
+  HostRig rig;
+  HostRig::Sources src;
+  src.ppg = &ppg; src.ecg = &ecg; src.tempC = 36.6f;
+  rig.begin(src);
+
+  std::vector<Second> out;
+  for (int s = 0; s < seconds; s++) {
+    rig.stepMs(1000);
+    Second x;
+    x.bpm = rig.spo2.bpmRounded();  x.spo2 = rig.spo2.spo2Rounded();
+    x.ecgBpm = rig.ecg.ecgBpm();    x.sqi = rig.spo2.signalQuality();
+    x.pi = rig.spo2.perfusionIndex();
+    x.tempC = rig.tprobe.hasTemp() ? rig.tprobe.tempC() : NAN;
+    x.ppgN = rig.spo2.rawIndex();   x.ecgN = rig.ecg.sampleIndex();
+    out.push_back(x);
+  }
+  return out;
+}
+
+int main() {
+  const int SECONDS = 30;
+  std::vector<Second> a = replay(SECONDS), b = replay(SECONDS);
+
+  bool same = true;
+  for (int s = 0; s < SECONDS; s++) {
+    const Second& x = a[s];
+    const Second& y = b[s];
+    if (x.bpm != y.bpm || x.spo2 != y.spo2 || x.ecgBpm != y.ecgBpm || x.sqi != y.sqi ||
+        x.pi != y.pi || x.ppgN != y.ppgN || x.ecgN != y.ecgN) {
+      fprintf(stderr, "replays differ at %d s\n", s + 1);
+      same = false;
+      break;
+    }
+  }
+  CHECK(same);
+
+  const Second& end = a.back();
+  CHECK_NEAR(end.bpm, 72, 3);
+  CHECK_NEAR(end.spo2, 97, 2);
+  CHECK_NEAR(end.ecgBpm, 72, 2);
+  CHECK_NEAR(end.tempC, 36.6, 0.1);
+  CHECK_NEAR((double)end.ppgN, 50.0 * SECONDS, 50);
+  CHECK_NEAR((double)end.ecgN, (double)ECG_SAMPLE_HZ * SECONDS, 2);
+  return checkResult("host_rig");
+}
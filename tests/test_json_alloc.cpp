@@ -0,0 +1,142 @@
+// tests/test_json_alloc.cpp
+// The HTTP and BLE JSON bodies (net_json.h) are built without touching the
+// heap: a global operator new counts every allocation while each builder
+// runs on a warmed-up sensor stack, through the same buffer sizes and
+// chunk sink the handlers use. Also checks the bodies themselves.
+#include <Arduino.h>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include "host_rig.h"
+#include "net_json.h"
+#include "check.h"
+
+static size_t s_allocs = 0;
+
+void* operator new(size_t n) {
+  s_allocs++;
+  void* p = malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// chunk sink into a fixed buffer, like WebServer::sendContent on the board
+static char   s_body[32768];
+static size_t s_bodyLen = 0, s_chunks = 0;
+static void toBody(void*, const char* d, size_t n) {
+  if (s_bodyLen + n < sizeof(s_body)) { memcpy(s_body + s_bodyLen, d, n); s_bodyLen += n; }
+  s_chunks++;
+}
+
+int main() {
+  SynthPpgParams pp;  pp.bpm = 72; pp.spo2 = 97; pp.pi = 2;
+  SynthEcgParams ep;  ep.bpm = 72;
+  SynthPpg ppg(pp);
+  SynthEcg ecg(ep);
+  HostRig rig;
+  HostRig::Sources src;
+  src.ppg = &ppg; src.ecg = &ecg; src.tempC = 36.6f;
+  rig.begin(src);
+  rig.stepMs(20000);
+  CHECK(rig.spo2.bpmRounded() > 0 && rig.ecg.ecgBpm() > 0 && rig.tprobe.hasTemp());
+
+  static int16_t samples[ECG_RING_SAMPLES];
+  uint64_t first = 0;
+  uint64_t head = rig.ecg.sampleIndex();
+  size_t got = rig.ecg.readSince(head - ECG_RING_SAMPLES, samples, ECG_RING_SAMPLES, first);
+  QrsBeat beats[16];
+  uint64_t firstBeat = 0;
+  size_t nBeats = rig.ecg.readBeats(0, beats, 16, firstBeat);
+  CHECK(got > ECG_RING_SAMPLES / 2 && nBeats > 8);
+
+  s_allocs = 0;
+
+  // /api/metrics, with and without sensors
+  char mbuf[224];
+  JsonWriter m(mbuf, sizeof(mbuf));
+  jsonMetrics(m, &rig.spo2, &rig.tprobe, &rig.ecg);
+  char m0buf[224];
+  JsonWriter none(m0buf, sizeof(m0buf));
+  jsonMetrics(none, nullptr, nullptr, nullptr);
+
+  // /api/ecg, the whole ring through a 512-byte chunk buffer
+  char chunk[512];
+  JsonWriter e(chunk, sizeof(chunk), toBody);
+  jsonEcg(e, (int)rig.ecg.sampleRate(), rig.ecg.leadsOff(), rig.ecg.droppedSamples(), first, samples, got);
+  e.flush();
+
+  // /api/beats
+  char bbuf[96 + 16*32];
+  JsonWriter b(bbuf, sizeof(bbuf));
+  jsonBeats(b, (int)rig.ecg.sampleRate(), firstBeat, beats, nBeats);
+
+  // SSE event, a full batch
+  static char ev[256*7 + 128];
+  JsonWriter s(ev, sizeof(ev));
+  jsonEcgEvent(s, (int)rig.ecg.sampleRate(), first, false, samples, 256);
+
+  // BLE metrics
+  char lbuf[96];
+  JsonWriter l(lbuf, sizeof(lbuf));
+  jsonBleMetrics(l, rig.spo2.bpmRounded(), rig.spo2.spo2Rounded(), rig.spo2.perfusionIndex(),
+                 rig.tprobe.tempC(), rig.spo2.signalQuality());
+  char l0buf[96];
+  JsonWriter l0(l0buf, sizeof(l0buf));
+  jsonBleMetrics(l0, -1, -1, 0, NAN, 0);
+
+  size_t allocs = s_allocs;
+  printf("allocations while building: %zu\n", allocs);
+  CHECK(allocs == 0);
+
+  // no body overflowed its buffer; the big one went out in chunks
+  CHECK(!m.overflow() && !none.overflow() && !e.overflow() && !b.overflow() && !s.overflow() && !l.overflow());
+  CHECK(s_chunks > 1 && s_bodyLen > 2 * got);
+  s_body[s_bodyLen] = 0;
+
+  printf("%s\n%s\n%s\n%s\n", m.c_str(), none.c_str(), b.c_str(), l.c_str());
+  CHECK(!strncmp(m.c_str(), "{\"pulse\":", 9) && strstr(m.c_str(), "\"tempC\":36.6,"));
+  CHECK(!strcmp(none.c_str(), "{\"pulse\":null,\"pulseConf\":0,\"spo2\":null,\"sqi\":0,\"pi\":0,"
+                              "\"finger\":false,\"tempC\":null,\"ecgBpm\":null,\"rrMs\":null}"));
+  CHECK(!strcmp(l0.c_str(), "{\"pulse\":null,\"spo2\":null,\"pi\":0.00,\"tempC\":null,\"sqi\":0}"));
+  CHECK(!strncmp(s_body, "{\"fs\":500,\"off\":false,", 22) && !strcmp(s_body + s_bodyLen - 2, "]}"));
+  CHECK(!strncmp(b.c_str(), "{\"fs\":500,\"seq\":", 16) && strstr(b.c_str(), "\"beats\":[[")
+        && !strcmp(b.c_str() + b.length() - 3, "]]}"));
+  CHECK(!strncmp(ev, "{\"fs\":500,\"seq\":", 16) && !strcmp(s.c_str() + s.length() - 2, "]}"));
+
+  // /api/i2c after a week or more: every counter near its limit. The old
+  // fixed 384-byte buffer overflows (the handler must not send that as a
+  // 200); the chunked path the handler uses gets the whole body out.
+  {
+    I2CBus::DevStats st[I2CBus::DEV_COUNT];
+    for (int d = 0; d < I2CBus::DEV_COUNT; d++) {
+      st[d].txns = 4294967295u; st[d].bytes = 4000000000u; st[d].errors = 4294967295u;
+      st[d].busyUs = 604800000000ull;           // a week of bus time
+    }
+    char fixed[384];
+    JsonWriter f(fixed, sizeof(fixed));
+    jsonI2C(f, 400000, 100.0f, 4294967295l, st, I2CBus::DEV_COUNT);
+    CHECK(f.overflow() && f.length() <= sizeof(fixed));
+
+    s_bodyLen = 0; s_chunks = 0;
+    s_allocs = 0;
+    char c[256];
+    JsonWriter w(c, sizeof(c), toBody);
+    jsonI2C(w, 400000, 100.0f, 4294967295l, st, I2CBus::DEV_COUNT);
+    w.flush();
+    CHECK(s_allocs == 0);
+    CHECK(!w.overflow() && s_chunks > 1 && s_bodyLen > sizeof(fixed));
+    s_body[s_bodyLen] = 0;
+    printf("i2c worst case: %zu bytes\n", s_bodyLen);
+    CHECK(!strncmp(s_body, "{\"hz\":400000,\"busy\":100.0,\"oledBytesPerSec\":4294967295,\"devices\":[{\"name\":", 72));
+    CHECK(strstr(s_body, "\"busyUs\":604800000000}") && !strcmp(s_body + s_bodyLen - 3, "}]}"));
+    int devs = 0;
+    for (const char* p = s_body; (p = strstr(p, "\"name\":")); p++) devs++;
+    CHECK(devs == I2CBus::DEV_COUNT);
+  }
+  return checkResult("json_alloc");
+}
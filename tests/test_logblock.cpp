@@ -0,0 +1,213 @@
+// tests/test_logblock.cpp
+// Flash log blocks (log_block.h) round trip: ECG and vitals written with
+// LogBlockWriter, split over blocks the way FlashLog does it, come back
+// unchanged through logCheckBlock / logDecodeEcg / logDecodeVitals; a
+// flipped bit anywhere in header or payload fails the CRC.
+//
+// With a directory argument it also writes log.bin (the blocks back to
+// back, as /api/log serves them, plus one corrupt block) and the CSV that
+// tools/log_decode.py must produce from it (the log_decode_py test).
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "log_block.h"
+#include "fake_devices.h"
+#include "check.h"
+
+static const uint32_t BOOT = 7;
+static const uint16_t FS = 500;
+
+struct Block { std::vector<uint8_t> b; };
+
+static std::vector<Block> writeEcg(const std::vector<int16_t>& s, uint32_t& seq) {
+  std::vector<Block> out;
+  LogBlockWriter w;
+  for (size_t i = 0; i < s.size(); ) {
+    if (!w.active()) {
+      out.push_back(Block());
+      out.back().b.assign(LOG_BLOCK_BYTES, 0xA5);
+      LogBlockHeader h;
+      h.bootId = BOOT; h.tMs = 1000 + (uint32_t)(i * 1000 / FS); h.tEpoch = 0;
+      h.first = i; h.rate = FS;
+      w.beginEcg(out.back().b.data(), h);
+    }
+    if (w.addEcg(s[i])) { i++; continue; }
+    CHECK(w.count() > 0);                       // a fresh block always takes a sample
+    w.finish(seq++);
+  }
+  if (w.active()) w.finish(seq++);
+  return out;
+}
+
+static std::vector<Block> writeVitals(const std::vector<LogVitals>& v, uint32_t& seq) {
+  std::vector<Block> out;
+  LogBlockWriter w;
+  for (size_t i = 0; i < v.size(); ) {
+    if (!w.active()) {
+      out.push_back(Block());
+      out.back().b.assign(LOG_BLOCK_BYTES, 0xA5);
+      LogBlockHeader h;
+      h.bootId = BOOT; h.tMs = 2000 + (uint32_t)i * 1000; h.tEpoch = 1700000000 + (uint32_t)i;
+      h.rate = 1;
+      w.beginVitals(out.back().b.data(), h);
+    }
+    if (w.addVitals(v[i])) { i++; continue; }
+    w.finish(seq++);
+  }
+  if (w.active()) w.finish(seq++);
+  return out;
+}
+
+// Python's repr of a float with at most two decimals
+static std::string pyFloat(float f) {
+  char b[32];
+  snprintf(b, sizeof(b), "%.2f", f);
+  std::string s(b);
+  while (s.back() == '0' && s[s.size() - 2] != '.') s.pop_back();
+  if (s == "-0.0") s = "0.0";
+  return s;
+}
+
+int main(int argc, char** argv) {
+  // ECG: 60 s of the band-passed range the ring holds (int12), with
+  // full-scale swings, flat stretches and the writer's 14-bit limit
+  std::vector<int16_t> ecg;
+  SynthEcgParams p;  p.bpm = 75;
+  SynthEcg src(p);
+  for (int i = 0; i < 60 * FS; i++) ecg.push_back((int16_t)(src.adc((uint64_t)(i + 1) * 1000000 / FS) - 2048));
+  for (int i = 0; i < 200; i++) ecg.push_back(i % 2 ? 2047 : -2048);
+  ecg.insert(ecg.end(), 500, 0);
+  for (int i = 0; i < 37; i++) ecg.push_back((int16_t)(i * 100 - 1800));
+  // the widest deltas a 4-bit width allows, and samples past the 14 bits
+  // the writer keeps
+  for (int i = 0; i < 40; i++) ecg.push_back(i % 2 ? LOG_ECG_MAX : LOG_ECG_MIN);
+  for (int i = 0; i < 40; i++) ecg.push_back(i % 2 ? 32767 : -32768);
+  std::vector<int16_t> want(ecg);
+  for (int16_t& x : want) x = x > LOG_ECG_MAX ? LOG_ECG_MAX : (x < LOG_ECG_MIN ? LOG_ECG_MIN : x);
+
+  std::vector<LogVitals> vit;
+  for (int i = 0; i < 900; i++) {
+    LogVitals v;
+    if (i % 50 != 7) {                          // gaps: nothing valid
+      v.pulse = 60 + i % 40; v.spo2 = 90 + i % 10; v.ecgBpm = 61 + i % 40;
+      v.finger = true; v.pi = (i % 500) / 100.0f;
+      v.hasTemp = i % 3 != 0; v.tempC = 35.0f + (i % 300) / 100.0f;
+      v.sqi = (uint8_t)(i % 101);
+    }
+    v.leadsOff = i % 11 == 0;
+    vit.push_back(v);
+  }
+
+  uint32_t seq = 100;
+  std::vector<Block> eb = writeEcg(ecg, seq), vb = writeVitals(vit, seq);
+  printf("%zu ECG samples in %zu blocks (%.2f bits/sample), %zu vitals in %zu blocks\n",
+         ecg.size(), eb.size(), eb.size() * LOG_PAYLOAD_MAX * 8.0 / ecg.size(), vit.size(), vb.size());
+  CHECK(eb.size() > 1 && vb.size() > 1);
+
+  // ECG back
+  std::vector<int16_t> got;
+  uint32_t expectSeq = 100;
+  for (const Block& blk : eb) {
+    LogBlockHeader h;
+    CHECK(logCheckBlock(blk.b.data(), blk.b.size(), h));
+    CHECK(h.type == LOG_TYPE_ECG && h.version == LOG_VERSION && h.seq == expectSeq++);
+    CHECK(h.bootId == BOOT && h.rate == FS && h.first == got.size());
+    static int16_t out[0x10000];
+    size_t n = logDecodeEcg(blk.b.data(), h, out, sizeof(out) / sizeof(out[0]));
+    CHECK(n == h.count && n > 0);
+    got.insert(got.end(), out, out + n);
+    // the padding after the payload is zeroed
+    bool zero = true;
+    for (size_t i = LOG_HDR_BYTES + h.payload; i < LOG_BLOCK_BYTES; i++) if (blk.b[i]) zero = false;
+    CHECK(zero);
+  }
+  CHECK(got == want);
+
+  // vitals back
+  std::vector<LogVitals> gv;
+  for (const Block& blk : vb) {
+    LogBlockHeader h;
+    CHECK(logCheckBlock(blk.b.data(), blk.b.size(), h));
+    CHECK(h.type == LOG_TYPE_VITALS && h.seq == expectSeq++);
+    LogVitals out[LOG_PAYLOAD_MAX / LOG_VITALS_BYTES];
+    size_t n = logDecodeVitals(blk.b.data(), h, out, sizeof(out) / sizeof(out[0]));
+    CHECK(n == h.count && n > 0);
+    gv.insert(gv.end(), out, out + n);
+  }
+  CHECK(gv.size() == vit.size());
+  int diff = 0;
+  for (size_t i = 0; i < vit.size() && i < gv.size(); i++) {
+    const LogVitals &a = vit[i], &b = gv[i];
+    bool same = a.pulse == b.pulse && a.spo2 == b.spo2 && a.ecgBpm == b.ecgBpm &&
+                a.finger == b.finger && a.leadsOff == b.leadsOff && a.hasTemp == b.hasTemp &&
+                fabsf(a.pi - b.pi) < 0.005f && a.sqi == b.sqi &&
+                (!a.hasTemp || fabsf(a.tempC - b.tempC) < 0.005f);
+    if (!same) diff++;
+  }
+  CHECK(diff == 0);
+
+  // any single flipped bit in header or payload is caught
+  {
+    std::vector<uint8_t> b = eb[0].b;
+    LogBlockHeader h;
+    CHECK(logCheckBlock(b.data(), b.size(), h));
+    size_t end = LOG_HDR_BYTES + h.payload;
+    int missed = 0;
+    for (size_t i = 0; i < end; i++) {
+      for (int bit = 0; bit < 8; bit += 3) {
+        b[i] ^= (uint8_t)(1 << bit);
+        LogBlockHeader x;
+        if (logCheckBlock(b.data(), b.size(), x)) missed++;
+        b[i] ^= (uint8_t)(1 << bit);
+      }
+    }
+    CHECK(missed == 0);
+    CHECK(!logCheckBlock(b.data(), LOG_BLOCK_BYTES - 1, h));
+  }
+
+  // files for tools/log_decode.py
+  if (argc > 1) {
+    std::string dir = argv[1];
+    FILE* f = fopen((dir + "/log.bin").c_str(), "wb");
+    FILE* fe = fopen((dir + "/expect_ecg.csv").c_str(), "wb");
+    FILE* fv = fopen((dir + "/expect_vitals.csv").c_str(), "wb");
+    CHECK(f && fe && fv);
+    if (!f || !fe || !fv) return checkResult("logblock");
+    // csv.writer ends rows with \r\n
+    fprintf(fe, "boot,seq,index,ms,unix,value\r\n");
+    fprintf(fv, "boot,seq,ms,unix,pulse,spo2,ecg_bpm,finger,leads_off,pi,temp_c,sqi\r\n");
+    size_t k = 0, kv = 0;
+    for (size_t i = 0; i < eb.size(); i++) {
+      fwrite(eb[i].b.data(), 1, LOG_BLOCK_BYTES, f);
+      LogBlockHeader h;
+      logCheckBlock(eb[i].b.data(), LOG_BLOCK_BYTES, h);
+      for (size_t j = 0; j < h.count; j++, k++)
+        fprintf(fe, "%u,%u,%llu,%u,,%d\r\n", BOOT, (unsigned)h.seq, (unsigned long long)(h.first + j),
+                (unsigned)(h.tMs + j * 1000 / h.rate), want[k]);
+      if (i == 0) {                             // a corrupt copy, skipped by the decoder
+        std::vector<uint8_t> bad = eb[i].b;
+        bad[LOG_HDR_BYTES + 5] ^= 0x10;
+        fwrite(bad.data(), 1, LOG_BLOCK_BYTES, f);
+      }
+    }
+    for (const Block& blk : vb) {
+      fwrite(blk.b.data(), 1, LOG_BLOCK_BYTES, f);
+      LogBlockHeader h;
+      logCheckBlock(blk.b.data(), LOG_BLOCK_BYTES, h);
+      for (size_t j = 0; j < h.count; j++, kv++) {
+        const LogVitals& v = gv[kv];
+        std::string cell[3];
+        int vals[3] = { v.pulse, v.spo2, v.ecgBpm };
+        for (int c = 0; c < 3; c++) if (vals[c] >= 0) cell[c] = std::to_string(vals[c]);
+        fprintf(fv, "%u,%u,%u,%u,%s,%s,%s,%d,%d,%s,%s,%u\r\n", BOOT, (unsigned)h.seq,
+                (unsigned)(h.tMs + j * 1000), (unsigned)(h.tEpoch + j),
+                cell[0].c_str(), cell[1].c_str(), cell[2].c_str(), v.finger ? 1 : 0, v.leadsOff ? 1 : 0,
+                pyFloat(v.pi).c_str(), v.hasTemp ? pyFloat(v.tempC).c_str() : "", (unsigned)v.sqi);
+      }
+    }
+    fclose(f); fclose(fe); fclose(fv);
+  }
+  return checkResult("logblock");
+}
@@ -0,0 +1,83 @@
+// tests/test_qrs.cpp
+// QRS detection on the full ECG path (AD8232Sensor: timer, filter chain,
+// QrsDetector) over synthetic rhythms with known beat times: beat-level
+// sensitivity and positive predictivity, and a bound on run time.
+// The tall-T / flat-line case hung the detector in its R-peak search
+// (a search-back peak older than the band-pass history) for seconds.
+#include <Arduino.h>
+#include <time.h>
+#include <vector>
+#include "host_rig.h"
+#include "beat_score.h"
+#include "check.h"
+
+struct Case {
+  const char*    name;
+  SynthEcgParams p;
+  float          minSens, minPpv;
+};
+
+static SynthEcgParams rate(float bpm) { SynthEcgParams p; p.bpm = bpm; return p; }
+
+static BeatScore run(const Case& c, int seconds, double& wallS) {
+  SynthEcg src(c.p);
+  HostRig rig;
+  HostRig::Sources s;
+  s.ecg = &src;
+  rig.begin(s);
+
+  std::vector<uint64_t> got;
+  uint64_t next = 0;
+  const double usPerSample = 1e6 / ECG_SAMPLE_HZ;
+  timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int k = 0; k < seconds; k++) {
+    rig.stepMs(1000);
+    QrsBeat b[16];
+    uint64_t first;
+    size_t n = rig.ecg.readBeats(next, b, 16, first);
+    for (size_t i = 0; i < n; i++) got.push_back((uint64_t)((b[i].sample + 1) * usPerSample));
+    next = first + n;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  wallS = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+  // skip the 2 s threshold training and the last second
+  return scoreBeats(src.beats(), got, 3000000, (uint64_t)(seconds - 1) * 1000000);
+}
+
+int main() {
+  std::vector<Case> cases;
+  cases.push_back(Case{ "regular 72",  rate(72),  0.99f, 0.99f });
+  cases.push_back(Case{ "brady 40",    rate(40),  0.99f, 0.99f });
+  cases.push_back(Case{ "tachy 160",   rate(160), 0.99f, 0.99f });
+  SynthEcgParams p;
+  p = rate(75);  p.rrJitter = 0.25f;                       // AF-like
+  cases.push_back(Case{ "irregular",   p, 0.98f, 0.98f });
+  p = rate(70);  p.ectopicEvery = 5;
+  cases.push_back(Case{ "ectopy",      p, 0.97f, 0.98f });
+  p = rate(60);  p.pauseEveryS = 15; p.pauseS = 2.5f;
+  cases.push_back(Case{ "pauses",      p, 0.98f, 0.98f });
+  p = rate(72);  p.offEveryS = 20; p.offS = 3;
+  cases.push_back(Case{ "leads off",   p, 0.95f, 0.97f });
+  p = rate(72);  p.dropEveryS = 15; p.dropS = 2;
+  cases.push_back(Case{ "dropouts",    p, 0.95f, 0.97f });
+  // the old search-back hang: slow rate, tall T wave, then a flat line.
+  // Only a handful of beats before the stop; a T wave taken as a beat
+  // during training is one false positive in eight.
+  p = rate(50);  p.tAmp = 2.0f; p.stopS = 12;
+  cases.push_back(Case{ "tall T, stop", p, 0.95f, 0.85f });
+
+  const int SECONDS = 120;
+  for (const Case& c : cases) {
+    double wallS = 0;
+    BeatScore s = run(c, SECONDS, wallS);
+    printf("%-14s beats %4d  sens %.4f  ppv %.4f  fn %d fp %d  %.0f ms\n", c.name,
+           s.tp + s.fn, s.sensitivity(), s.ppv(), s.fn, s.fp, wallS * 1e3);
+    CHECK(s.tp + s.fn > 0);
+    if (!(s.sensitivity() >= c.minSens)) { fprintf(stderr, "%s: sensitivity\n", c.name); CHECK(false); }
+    if (!(s.ppv() >= c.minPpv))          { fprintf(stderr, "%s: ppv\n", c.name); CHECK(false); }
+    // 2 minutes of 500 Hz take a few ms; the hang took seconds per call
+    CHECK(wallS < 2.0);
+  }
+  return checkResult("qrs");
+}
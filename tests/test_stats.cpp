@@ -0,0 +1,60 @@
+// tests/test_stats.cpp
+// StatHist (util_stats.h): power-of-two buckets, and quantiles that are
+// the bucket's upper bound, within 2x of the true value, but never more
+// than the largest duration seen.
+#include <Arduino.h>
+#include <algorithm>
+#include <vector>
+#include "util_stats.h"
+#include "check.h"
+
+static uint32_t trueQuantile(std::vector<uint32_t> v, float q) {
+  std::sort(v.begin(), v.end());
+  return v[(size_t)(q * v.size())];
+}
+
+int main() {
+  // one duration: every quantile is that duration, not its bucket's bound
+  {
+    StatHist h = {};
+    for (int i = 0; i < 100; i++) h.add(1100);
+    CHECK(h.bucket[10] == 100 && h.count == 100 && h.maxCycles == 1100);
+    CHECK(h.quantileCycles(0.5f) == 1100);
+    CHECK(h.quantileCycles(0.99f) == 1100);
+  }
+
+  // spread-out durations
+  {
+    StatHist h = {};
+    std::vector<uint32_t> v;
+    uint32_t seed = 3;
+    for (int i = 0; i < 10000; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      uint32_t c = 50 + (seed >> 8) % 5000 + (i % 997 == 0 ? 200000 : 0);
+      v.push_back(c);
+      h.add(c);
+    }
+    const float qs[] = { 0.1f, 0.5f, 0.9f, 0.99f, 0.9999f };
+    for (float q : qs) {
+      uint32_t got = h.quantileCycles(q), ref = trueQuantile(v, q);
+      CHECK(got >= ref && got <= 2 * ref + 1);
+      CHECK(got <= h.maxCycles);
+    }
+    uint64_t sum = 0;
+    for (uint32_t c : v) sum += c;
+    CHECK(h.sumCycles == sum);
+    CHECK(h.maxCycles == *std::max_element(v.begin(), v.end()));
+  }
+
+  // zero and the open last bucket
+  {
+    StatHist h = {};
+    CHECK(h.quantileCycles(0.5f) == 0);
+    h.add(0);
+    h.add(0xFFFFFFFFu);
+    CHECK(h.bucket[0] == 1 && h.bucket[StatHist::BUCKETS - 1] == 1);
+    CHECK(h.quantileCycles(0.99f) == 0xFFFFFFFFu);
+    CHECK(h.quantileCycles(0.0f) <= 2);
+  }
+  return checkResult("stats");
+}
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""tools/wfdb_to_fixture.py end to end, on a record written here.
+
+Writes a two-signal format 212 record at 360 Hz (the MIT-BIH layout) with
+an MIT annotation file holding QRS codes mixed with the non-beat entries
+the converter must skip (rhythm change with AUX text, noise, NUM/SUB/CHN,
+a SKIP), converts it and checks the beat column, then runs bench on the
+fixture and checks the annotated beats are scored.
+
+    test_wfdb_fixture.py CONVERTER BENCH WORKDIR
+"""
+import json
+import math
+import os
+import struct
+import subprocess
+import sys
+
+FS, SECONDS, GAIN, BASE = 360, 40, 200, 1024
+N, V, NOISE, RHYTHM = 1, 5, 14, 28
+SKIP, NUM, SUB, CHN, AUX = 59, 60, 61, 62, 63
+
+failures = 0
+
+
+def check(cond, what):
+    global failures
+    if not cond:
+        print("FAIL: " + what)
+        failures += 1
+
+
+def beat_times():
+    # 70 bpm with every 7th beat early (a PVC) and a compensatory pause
+    t, out, k = int(0.5 * FS), [], 0
+    while t < SECONDS * FS - FS // 2:
+        out.append((t, V if k % 7 == 6 else N))
+        rr = 60.0 / 70 * FS
+        t += int(rr * (0.7 if k % 7 == 5 else 1.3 if k % 7 == 6 else 1.0))
+        k += 1
+    return out
+
+
+def ecg_mv(i, beats):
+    v = 0.1 * math.sin(2 * math.pi * 0.3 * i / FS)      # baseline wander
+    for b, code in beats:
+        d = (i - b) / FS
+        if -0.2 < d < 0.5:
+            w = 0.03 if code == V else 0.012
+            v += (1.0 if code == N else -1.3) * math.exp(-0.5 * (d / w) ** 2)
+            v += 0.25 * math.exp(-0.5 * ((d - 0.25) / 0.04) ** 2)   # T wave
+    return v
+
+
+def word(code, val):
+    return struct.pack("<H", (code << 10) | (val & 0x3FF))
+
+
+def write_record(d, beats):
+    n = SECONDS * FS
+    with open(os.path.join(d, "syn.hea"), "w") as f:
+        f.write("syn 2 %d %d\n" % (FS, n))
+        f.write("syn.dat 212 %d 11 %d 0 0 0 MLII\n" % (GAIN, BASE))
+        f.write("syn.dat 212 %d 11 %d 0 0 0 V5\n" % (GAIN, BASE))
+    raw = bytearray()
+    for i in range(n):
+        a = int(round(BASE + ecg_mv(i, beats) * GAIN)) & 0xFFF
+        b = BASE & 0xFFF
+        raw += bytes((a & 0xFF, ((a >> 8) & 0x0F) | ((b >> 4) & 0xF0), b & 0xFF))
+    open(os.path.join(d, "syn.dat"), "wb").write(raw)
+
+    ann, t = bytearray(), 0
+    ann += word(RHYTHM, 0) + word(AUX, 3) + b"(N\x00" + b"\x00"   # odd length, padded
+    ann += word(NUM, 1) + word(CHN, 0) + word(SUB, 2)
+    for k, (b, code) in enumerate(beats):
+        dt = b - t
+        if dt > 1023 or k == 0:                        # long gap: SKIP then 0
+            ann += word(SKIP, 0) + struct.pack("<HH", dt >> 16, dt & 0xFFFF)
+            ann += word(code, 0)
+        else:
+            ann += word(code, dt)
+        t = b
+        if k == 10:                                    # noise mark, not a beat
+            ann += word(NOISE, 20)
+            t += 20
+    ann += word(0, 0)
+    open(os.path.join(d, "syn.atr"), "wb").write(ann)
+
+
+def main():
+    conv, bench, d = sys.argv[1:4]
+    os.makedirs(d, exist_ok=True)
+    beats = beat_times()
+    write_record(d, beats)
+    out = os.path.join(d, "syn.csv")
+    subprocess.run([sys.executable, conv, os.path.join(d, "syn"), "--out", out], check=True)
+
+    rows = [l.strip().split(",") for l in open(out) if not l.startswith("#")]
+    check(len(rows) == SECONDS * FS, "rows %d" % len(rows))
+    marked = [i for i, r in enumerate(rows) if r[2] == "1"]
+    check(marked == [b for b, _ in beats], "beat column %s" % marked[:12])
+    check(rows[0][1] == "nan" and rows[-1][1] != "nan", "ref_bpm nan until the second beat")
+    b0 = beats[0][0]
+    check(abs(int(rows[b0][0]) - (2048 + 700 * ecg_mv(b0, beats))) <= 4, "R peak in ADC counts")
+
+    rep = json.loads(subprocess.run([bench, "--no-builtin", "--repeat", "1",
+                                     "--fixture", "%s:%d" % (out, FS)],
+                                    check=True, capture_output=True, text=True).stdout)
+    eb = rep["fixtures"][0]["ecgBeats"]
+    print("bench ecgBeats:", json.dumps(eb))
+    check(eb["beats"] > 40 and eb["sensitivity"] >= 0.95 and eb["ppv"] >= 0.95, "bench scoring")
+    check(rep["summary"]["ecgBeatSens"] is not None, "pooled sensitivity")
+
+    print("wfdb_fixture: %s" % ("FAIL" if failures else "ok"))
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
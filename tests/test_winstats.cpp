@@ -0,0 +1,134 @@
+// tests/test_winstats.cpp
+// WindowStats against the per-tick helpers it replaced in
+// Max30102Sensor (long double passes over the window: mean, sample
+// stddev around the float mean, population AC RMS), on synthetic PPG at
+// the raw ADC range and scaled the way the LED current loop scales it
+// (up to PPG_LED_INIT / PPG_LED_MIN = 10x, about 22 bits).
+// WindowStats keeps exact integer sums, so whether it matches depends on
+// the sample range and window length, not on the waveform: the synthetic
+// inputs span the raw and AGC-scaled range and a 22-bit worst case. No
+// recorded trace ships; to run the same comparison on one, pass a CSV
+// (red, ir in the first two columns, as in bench's PPG fixtures, or give
+// the column numbers):
+//   test_winstats capture.csv [RED_COL IR_COL]
+#include <Arduino.h>
+#include <vector>
+#include "config.h"
+#include "dsp_winstats.h"
+#include "fake_devices.h"
+#include "check.h"
+
+// ---- the old helpers, verbatim apart from the signature ----
+static float oldMean(const int32_t* a, int n) {
+  long double s = 0; for (int i = 0; i < n; i++) s += a[i]; return (float)(s / n);
+}
+static float oldStddev(const int32_t* a, int n, float m) {
+  long double s = 0; for (int i = 0; i < n; i++) { long double d = a[i] - m; s += d * d; }
+  return (float)sqrt((double)(s / (n > 1 ? n - 1 : 1)));
+}
+static float oldAcRms(const int32_t* a, int n, float dc) {
+  long double s = 0; for (int i = 0; i < n; i++) { long double d = a[i] - dc; s += d * d; }
+  return (float)sqrt((double)(s / n));
+}
+
+static int s_compared = 0;
+
+// Feeds xs through WindowStats<N> and compares every tick with the old
+// helpers over the same window (the last min(i+1, N) samples).
+template <int N>
+static void compare(const std::vector<int32_t>& xs, const char* what) {
+  WindowStats<N> w;
+  int bad = 0;
+  for (size_t i = 0; i < xs.size(); i++) {
+    w.push(xs[i]);
+    int n = w.count();
+    int32_t win[N];
+    for (int k = 0; k < n; k++) win[k] = xs[i + 1 - n + k];
+    float m  = oldMean(win, n);
+    float sd = oldStddev(win, n, m);
+    float ac = oldAcRms(win, n, m);
+    // float results: a few ulp of the mean, and relative to the AC level
+    // (the old stddev subtracted a rounded mean, which adds ~ulp(mean))
+    float tolM  = fabsf(m) * 2e-7f + 1e-3f;
+    float tolSd = sd * 1e-5f + fabsf(m) * 2e-7f + 1e-3f;
+    if (fabsf(w.mean() - m) > tolM || fabsf(w.stddev() - sd) > tolSd ||
+        fabsf(w.acRms() - ac) > tolSd) {
+      if (!bad++)
+        fprintf(stderr, "%s N=%d tick %zu: mean %.3f/%.3f sd %.4f/%.4f ac %.4f/%.4f\n",
+                what, N, i, w.mean(), m, w.stddev(), sd, w.acRms(), ac);
+    }
+    s_compared++;
+  }
+  CHECK(bad == 0);
+}
+
+// One channel of SynthPpg, optionally scaled like atRefCurrent() does.
+static std::vector<int32_t> ppg(const SynthPpgParams& p, bool ir, int scale, int n) {
+  SynthPpg src(p);
+  std::vector<int32_t> v;
+  for (int i = 0; i < n; i++) {
+    int32_t red, irv;
+    src.sample(i, red, irv);
+    v.push_back((ir ? irv : red) * scale);
+  }
+  return v;
+}
+
+// Red and IR columns of a recorded trace, raw and AGC-scaled when that
+// stays within 22 bits.
+static void compareRecorded(const char* path, size_t redCol, size_t irCol, int agcScale) {
+  CsvTrace t;
+  CHECK(t.load(path) && t.rows() > 0 && t.cols() > redCol && t.cols() > irCol);
+  if (!t.rows() || t.cols() <= redCol || t.cols() <= irCol) return;
+  std::vector<int32_t> ch[2];
+  int32_t peak = 0;
+  for (size_t r = 0; r < t.rows(); r++)
+    for (int c = 0; c < 2; c++) {
+      int32_t x = (int32_t)t.at(r, c ? irCol : redCol);
+      ch[c].push_back(x);
+      peak = x > peak ? x : peak;
+    }
+  printf("%s: %zu rows, peak %ld\n", path, t.rows(), (long)peak);
+  for (int c = 0; c < 2; c++) {
+    const char* what = c ? "recorded ir" : "recorded red";
+    compare<200>(ch[c], what);
+    compare<512>(ch[c], what);
+    if ((int64_t)peak * agcScale < (1 << 22)) {
+      std::vector<int32_t> scaled;
+      for (int32_t x : ch[c]) scaled.push_back(x * agcScale);
+      compare<512>(scaled, c ? "recorded ir, AGC-scaled" : "recorded red, AGC-scaled");
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  const int AGC_SCALE = PPG_LED_INIT / PPG_LED_MIN;        // 10 with the defaults
+  CHECK(AGC_SCALE >= 1);
+
+  SynthPpgParams rest;  rest.bpm = 72;  rest.pi = 2;
+  SynthPpgParams low;   low.bpm = 55;   low.pi = 0.2f;     low.noise = 0.2f;
+  SynthPpgParams full;  full.bpm = 90;  full.pi = 1;       full.dcIr = 255000; full.dcRed = 250000;
+
+  compare<200>(ppg(rest, true, 1, 1000), "rest ir");
+  compare<200>(ppg(rest, false, 1, 1000), "rest red");
+  compare<200>(ppg(low, true, 1, 1000), "low-PI ir");
+  compare<100>(ppg(rest, true, 1, 500), "rest ir");
+  // AGC at PPG_LED_MIN: near-full-scale raw samples x10, about 22 bits
+  std::vector<int32_t> scaled = ppg(full, true, AGC_SCALE, 1000);
+  int32_t peak = 0;
+  for (int32_t x : scaled) peak = x > peak ? x : peak;
+  CHECK(peak > (1 << 21) && peak < (1 << 22));
+  compare<200>(scaled, "AGC-scaled ir");
+  compare<512>(scaled, "AGC-scaled ir");
+
+  // worst case for the int64 sums: 22-bit extremes over the largest window
+  std::vector<int32_t> ext;
+  for (int i = 0; i < 1200; i++) ext.push_back((i & 1) ? (1 << 22) - 1 : 0);
+  compare<512>(ext, "22-bit square wave");
+  CHECK(s_compared > 6000);
+
+  if (argc > 1)
+    compareRecorded(argv[1], argc > 3 ? atoi(argv[2]) : 0, argc > 3 ? atoi(argv[3]) : 1, AGC_SCALE);
+
+  return checkResult("winstats");
+}
@@ -0,0 +1,122 @@
+// tests/test_wire.cpp
+// net_wire round trips: ECG frames (zig-zag varint deltas, full int16
+// range, truncation when the buffer runs out), vitals with and without
+// values, malformed and truncated frames rejected, base64.
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "net_wire.h"
+#include "check.h"
+
+static void ecgRoundTrip(const std::vector<int16_t>& s, bool leadsOff) {
+  WireEcgFrame h;
+  h.tMs = 123456789; h.leadsOff = leadsOff; h.fs = 500; h.seq = 0x123456789ull;
+  std::vector<uint8_t> buf(wireEcgMaxBytes(s.size()));
+  size_t len = wireEncodeEcg(buf.data(), buf.size(), h, s.data(), s.size());
+  CHECK(len >= WIRE_ECG_HDR_BYTES && len <= buf.size());
+
+  uint8_t type = 0;
+  CHECK(wirePeekType(buf.data(), len, type) && type == WIRE_TYPE_ECG);
+  WireEcgFrame d;
+  std::vector<int16_t> out(s.size() + 1);
+  CHECK(wireDecodeEcg(buf.data(), len, d, out.data(), out.size()));
+  CHECK(d.tMs == h.tMs && d.leadsOff == leadsOff && d.fs == 500 && d.seq == h.seq);
+  CHECK(d.count == s.size());
+  CHECK(std::equal(s.begin(), s.end(), out.begin()));
+
+  // every cut short of the whole frame is rejected, so is a trailing byte
+  bool anyCut = false;
+  for (size_t cut = 0; cut < len; cut++)
+    if (wireDecodeEcg(buf.data(), cut, d, out.data(), out.size())) anyCut = true;
+  CHECK(!anyCut);
+  buf.push_back(0);
+  CHECK(!wireDecodeEcg(buf.data(), len + 1, d, out.data(), out.size()));
+  // output too small for the count
+  if (!s.empty()) CHECK(!wireDecodeEcg(buf.data(), len, d, out.data(), s.size() - 1));
+}
+
+int main() {
+  // ECG: a smooth trace (1-byte deltas), extremes (3-byte deltas), empty
+  std::vector<int16_t> smooth, wild;
+  for (int i = 0; i < 300; i++) smooth.push_back((int16_t)(200 * sin(i * 0.05) + (i % 7) - 3));
+  const int16_t ext[] = { 0, 32767, -32768, 32767, -1, 1, -32768, 0, 63, -64, 64, -65 };
+  wild.assign(ext, ext + sizeof(ext) / sizeof(ext[0]));
+  ecgRoundTrip(smooth, false);
+  ecgRoundTrip(wild, true);
+  ecgRoundTrip(std::vector<int16_t>(), false);
+
+  // small deltas cost one byte each
+  {
+    WireEcgFrame h;
+    uint8_t buf[512];
+    std::vector<int16_t> ramp(100);
+    for (int i = 0; i < 100; i++) ramp[i] = (int16_t)(i % 2 ? 10 : -10);
+    size_t len = wireEncodeEcg(buf, sizeof(buf), h, ramp.data(), ramp.size());
+    CHECK(len == WIRE_ECG_HDR_BYTES + 100);
+  }
+
+  // encoder stops at whole samples when the buffer runs out
+  {
+    WireEcgFrame h, d;
+    uint8_t buf[WIRE_ECG_HDR_BYTES + 10];
+    size_t len = wireEncodeEcg(buf, sizeof(buf), h, wild.data(), wild.size());
+    int16_t out[16];
+    CHECK(len <= sizeof(buf));
+    CHECK(wireDecodeEcg(buf, len, d, out, 16));
+    CHECK(d.count > 0 && d.count < wild.size());
+    CHECK(memcmp(out, wild.data(), d.count * sizeof(int16_t)) == 0);
+    CHECK(wireEncodeEcg(buf, WIRE_ECG_HDR_BYTES - 1, h, wild.data(), wild.size()) == 0);
+  }
+
+  // vitals, all present
+  {
+    WireVitals v, d;
+    v.tMs = 42; v.finger = true; v.pulse = 72; v.spo2 = 97; v.ecgBpm = 74;
+    v.pi = 3.41f; v.tempC = -12.34f; v.rrMs = 812; v.sqi = 92;
+    uint8_t buf[WIRE_VITALS_BYTES];
+    CHECK(wireEncodeVitals(buf, sizeof(buf), v) == WIRE_VITALS_BYTES);
+    CHECK(wireDecodeVitals(buf, sizeof(buf), d));
+    CHECK(d.tMs == 42 && d.finger && d.pulse == 72 && d.spo2 == 97 && d.ecgBpm == 74);
+    CHECK_NEAR(d.pi, 3.41, 0.005);
+    CHECK_NEAR(d.tempC, -12.34, 0.005);
+    CHECK(d.rrMs == 812 && d.sqi == 92);
+    for (size_t cut = 0; cut < sizeof(buf); cut++) CHECK(!wireDecodeVitals(buf, cut, d));
+    CHECK(wireEncodeVitals(buf, sizeof(buf) - 1, v) == 0);
+
+    // wrong magic, version or type
+    uint8_t bad[WIRE_VITALS_BYTES];
+    memcpy(bad, buf, sizeof(bad)); bad[0] = 'X';
+    CHECK(!wireDecodeVitals(bad, sizeof(bad), d));
+    memcpy(bad, buf, sizeof(bad)); bad[2] = WIRE_VERSION + 1;
+    CHECK(!wireDecodeVitals(bad, sizeof(bad), d));
+    WireEcgFrame e;
+    int16_t o[4];
+    CHECK(!wireDecodeEcg(buf, sizeof(buf), e, o, 4));
+  }
+
+  // vitals, nothing known; out-of-range values clamp
+  {
+    WireVitals v, d;
+    v.sqi = 250; v.pi = 1000;
+    uint8_t buf[WIRE_VITALS_BYTES];
+    CHECK(wireEncodeVitals(buf, sizeof(buf), v) == WIRE_VITALS_BYTES);
+    CHECK(wireDecodeVitals(buf, sizeof(buf), d));
+    CHECK(!d.finger && d.pulse == -1 && d.spo2 == -1 && d.ecgBpm == -1);
+    CHECK(isnan(d.tempC) && d.rrMs == 0 && d.sqi == 100);
+    CHECK_NEAR(d.pi, 655.0, 0.005);
+  }
+
+  // base64 (RFC 4648 test vectors)
+  {
+    const char* in[]  = { "", "f", "fo", "foo", "foob", "fooba", "foobar" };
+    const char* out[] = { "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" };
+    for (int i = 0; i < 7; i++) {
+      char b[16];
+      size_t n = wireBase64((const uint8_t*)in[i], strlen(in[i]), b, sizeof(b));
+      CHECK(n == strlen(out[i]) && strcmp(b, out[i]) == 0);
+    }
+    char small[4];
+    CHECK(wireBase64((const uint8_t*)"foo", 3, small, sizeof(small)) == 0);
+  }
+  return checkResult("wire");
+}
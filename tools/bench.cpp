@@ -0,0 +1,570 @@
+// tools/bench.cpp
+// Speed and accuracy of the sensor pipelines over a set of fixtures, as
+// JSON on stdout (see README "Benchmarks"). Built-in fixtures are the
+// synthetic generators in host/fake_devices.h with known ground truth;
+// recorded traces with reference columns can be added with --fixture.
+//
+//   bench [--seconds N] [--repeat R] [--only NAME] [--fixture FILE[:HZ]]... [--no-builtin]
+//
+// Accuracy is deterministic; run times are the fastest of R runs (default
+// 3), which keeps scheduler noise on the build machine out of the numbers.
+//
+// Fixture files: numeric CSV. 4 columns = red, ir, ref_bpm, ref_spo2 at HZ
+// (default 50); 2 columns = ECG adc, ref_bpm at HZ (default ECG_SAMPLE_HZ);
+// 3 columns = ECG adc, ref_bpm, beat, where beat is non-zero on rows with
+// an annotated R peak (tools/wfdb_to_fixture.py writes these from
+// PhysioNet records), which adds beat-by-beat scoring. Use nan for
+// unknown references.
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <string>
+#include "host_rig.h"
+#include "beat_score.h"
+#include "util_jsonw.h"
+#include "util_stats.h"
+
+// ---------- fixtures ----------
+
+class Fixture {
+public:
+  virtual ~Fixture() {}
+  virtual const char* name() const = 0;
+  // fresh sources for one run (generators keep state)
+  virtual void sources(HostRig::Sources& src) = 0;
+  // ground truth at the current virtual time, NAN if unknown
+  virtual float refPulse(float tS) const = 0;
+  virtual float refSpo2(float tS) const = 0;
+  virtual float refEcgBpm(float tS) const = 0;
+  virtual bool  finger() const { return true; }
+  // true R peaks (us) after a run, nullptr if unknown
+  virtual const std::vector<uint64_t>* ecgBeats() const { return nullptr; }
+};
+
+class SynthFixture : public Fixture {
+public:
+  // expect = false: no valid reading should come out (refs are NAN)
+  SynthFixture(const char* n, const SynthPpgParams& p, bool ecg = true, bool expect = true)
+    : _name(n), _pp(p), _ecgOn(ecg), _expect(expect && p.finger) {
+    _ep.bpm = p.bpm;
+    _ep.bpmWander = p.bpmWander;
+  }
+  // ECG rhythm of its own (pauses, ectopy, signal loss)
+  SynthFixture(const char* n, const SynthPpgParams& p, const SynthEcgParams& e)
+    : _name(n), _pp(p), _ep(e), _ecgOn(true), _expect(p.finger) {}
+  ~SynthFixture() { delete _ppg; delete _ecg; }
+  const char* name() const override { return _name; }
+  void sources(HostRig::Sources& src) override {
+    delete _ppg; delete _ecg;
+    _ppg = new SynthPpg(_pp);
+    _ecg = _ecgOn ? new SynthEcg(_ep) : nullptr;
+    src.ppg = _ppg;
+    src.ecg = _ecg;
+  }
+  float refPulse(float) const override  { return _expect ? _ppg->bpm() : NAN; }
+  float refSpo2(float) const override   { return _expect ? _pp.spo2 : NAN; }
+  float refEcgBpm(float) const override { return _ecg ? _ecg->bpm() : NAN; }
+  bool  finger() const override         { return _expect; }
+  const std::vector<uint64_t>* ecgBeats() const override { return _ecg ? &_ecg->beats() : nullptr; }
+private:
+  const char*    _name;
+  SynthPpgParams _pp;
+  SynthEcgParams _ep;
+  bool           _ecgOn;
+  bool           _expect;
+  SynthPpg*      _ppg = nullptr;
+  SynthEcg*      _ecg = nullptr;
+};
+
+class RecordedFixture : public Fixture {
+public:
+  bool load(const char* arg) {
+    std::string s(arg);
+    size_t colon = s.rfind(':');
+    _hz = 0;
+    if (colon != std::string::npos) { _hz = atof(s.c_str() + colon + 1); s.resize(colon); }
+    _name = s;
+    if (!_t.load(s.c_str())) return false;
+    if (_t.cols() == 4)      _isEcg = false;
+    else if (_t.cols() == 2 || _t.cols() == 3) _isEcg = true;
+    else return false;
+    if (_hz <= 0) _hz = _isEcg ? ECG_SAMPLE_HZ : 50;
+    _hasBeats = _t.cols() == 3;
+    _beats.clear();
+    if (_hasBeats)
+      for (size_t r = 0; r < _t.rows(); r++)
+        if (_t.at(r, 2) != 0) _beats.push_back((uint64_t)(r * 1e6 / _hz));
+    return true;
+  }
+  ~RecordedFixture() { delete _ppg; delete _ecg; }
+  const char* name() const override { return _name.c_str(); }
+  void sources(HostRig::Sources& src) override {
+    delete _ppg; delete _ecg; _ppg = nullptr; _ecg = nullptr;
+    if (_isEcg) _ecg = new CsvEcg(_t, 0, _hz, 1.0f, 0.0f);
+    else        _ppg = new CsvPpg(_t, 0, 1, _hz);
+    src.ppg = _ppg;
+    src.ecg = _ecg;
+  }
+  float refPulse(float t) const override  { return _isEcg ? NAN : _ref(t, 2); }
+  float refSpo2(float t) const override   { return _isEcg ? NAN : _ref(t, 3); }
+  float refEcgBpm(float t) const override { return _isEcg ? _ref(t, 1) : NAN; }
+  const std::vector<uint64_t>* ecgBeats() const override { return _hasBeats ? &_beats : nullptr; }
+  float seconds() const { return _t.rows() / _hz; }
+private:
+  std::string _name;
+  CsvTrace    _t;
+  float       _hz = 50;
+  bool        _isEcg = false;
+  bool        _hasBeats = false;
+  std::vector<uint64_t> _beats;           // annotated R peaks, us
+  CsvPpg*     _ppg = nullptr;
+  CsvEcg*     _ecg = nullptr;
+  float _ref(float t, size_t col) const {
+    size_t row = (size_t)(t * _hz);
+    return row < _t.rows() ? _t.at(row, col) : NAN;
+  }
+};
+
+static SynthPpgParams ppg(float bpm, float spo2, float pi) {
+  SynthPpgParams p;
+  p.bpm = bpm; p.spo2 = spo2; p.pi = pi;
+  return p;
+}
+
+static SynthEcgParams ecg(float bpm) {
+  SynthEcgParams p;
+  p.bpm = bpm;
+  return p;
+}
+
+// ---------- metrics ----------
+
+// One reading compared with its reference once per second.
+struct Track {
+  int    firstValidS = -1;
+  int    seconds = 0, valid = 0, scored = 0, falseValid = 0;
+  double sumErr = 0, sumAbs = 0, maxAbs = 0;
+
+  void add(int tS, float got, float ref) {
+    bool ok = got > 0;
+    seconds++;
+    if (ok && firstValidS < 0) firstValidS = tS;
+    if (ok) valid++;
+    if (isnan(ref)) { if (ok) falseValid++; return; }
+    if (!ok) return;
+    double e = got - ref;
+    scored++;
+    sumErr += e;
+    sumAbs += fabs(e);
+    if (fabs(e) > maxAbs) maxAbs = fabs(e);
+  }
+  float mae() const  { return scored ? (float)(sumAbs / scored) : NAN; }
+  float bias() const { return scored ? (float)(sumErr / scored) : NAN; }
+  // share of the seconds since the first valid reading that had one
+  float coverage() const {
+    int span = firstValidS < 0 ? 0 : seconds - firstValidS + 1;
+    return span > 0 ? (float)valid / span : NAN;
+  }
+};
+
+static void putTrack(JsonWriter& j, const char* k, const Track& t, bool withBias) {
+  j.key(k).beginObject();
+  j.key("firstValidS");
+  if (t.firstValidS < 0) j.null(); else j.value(t.firstValidS);
+  j.key("coverage").floatOrNull(t.coverage(), 3);
+  j.key("mae").floatOrNull(t.mae(), 2);
+  if (withBias) j.key("bias").floatOrNull(t.bias(), 2);
+  j.key("maxAbsErr").floatOrNull(t.scored ? (float)t.maxAbs : NAN, 1);
+  j.key("falseValid").value(t.falseValid);
+  j.endObject();
+}
+
+// Per-tick cost from the util_stats.h probes; the host cycle counter
+// counts ns (host/Arduino.h).
+struct Cost {
+  uint32_t n = 0;
+  float    meanNs = NAN;
+  uint32_t p99Ns = 0, maxNs = 0;
+
+#ifdef ENABLE_STATS
+  // a second probe is summed in (poll + dsp make one MAX30102 tick)
+  void take(StatProbe a, StatProbe b = STAT_COUNT) {
+    const StatHist& h = g_stats[a];
+    uint64_t sum = h.sumCycles;
+    n = h.count; p99Ns = h.quantileCycles(0.99f); maxNs = h.maxCycles;
+    if (b != STAT_COUNT) {
+      sum   += g_stats[b].sumCycles;
+      p99Ns += g_stats[b].quantileCycles(0.99f);
+      maxNs += g_stats[b].maxCycles;
+    }
+    meanNs = n ? (float)sum / n : NAN;
+  }
+#endif
+  void keepFaster(const Cost& o) { if (isnan(meanNs) || o.meanNs < meanNs) *this = o; }
+  void put(JsonWriter& j, const char* k) const {
+    j.key(k).beginObject();
+    j.key("n").value((unsigned long)n);
+    j.key("meanNs").floatOrNull(meanNs, 1);
+    j.key("p99Ns").value((unsigned long)p99Ns);
+    j.key("maxNs").value((unsigned long)maxNs);
+    j.endObject();
+  }
+};
+
+static void putBeats(JsonWriter& j, const char* k, const BeatScore& s) {
+  j.key(k).beginObject();
+  j.key("beats").value(s.tp + s.fn);
+  j.key("sensitivity").floatOrNull(s.sensitivity(), 4);
+  j.key("ppv").floatOrNull(s.ppv(), 4);
+  j.key("missed").value(s.fn);
+  j.key("extra").value(s.fp);
+  j.endObject();
+}
+
+// ---------- ECG filter ----------
+
+// The float one-pole high-pass that EcgFilter replaced (ECG_HP_ALPHA 0.995).
+struct FloatHighpass {
+  float y = 0, x = 0;
+  int16_t process(int16_t in) {
+    y = 0.995f * (y + (float)in - x);
+    x = (float)in;
+    return (int16_t)y;
+  }
+};
+
+// EcgFilter's stages in float, direct form I: what the band-pass and
+// notch would cost without the fixed-point chain.
+struct FloatBiquad {
+  float b0, b1, b2, a1, a2;
+  float x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+  explicit FloatBiquad(const BiquadCoeffs& c)
+    : b0(c.b0 / 1073741824.0f), b1(c.b1 / 1073741824.0f), b2(c.b2 / 1073741824.0f),
+      a1(c.a1 / 1073741824.0f), a2(c.a2 / 1073741824.0f) {}
+  float run(float x) {
+    float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+    x2 = x1; x1 = x; y2 = y1; y1 = y;
+    return y;
+  }
+};
+struct FloatEcgFilter {
+  FloatBiquad hp { EcgHighpass::coeffs() }, lp { EcgLowpass::coeffs() }, notch { EcgNotch::coeffs() };
+  int16_t process(int16_t in) { return (int16_t)notch.run(lp.run(hp.run((float)in))); }
+};
+
+struct BlockEcgFilter {
+  EcgFilter f;
+  void processBlock(int16_t* buf, size_t n) { f.processBlock(buf, n); }
+};
+
+static volatile int32_t g_sink;           // keeps the filter loops from being optimised out
+
+static double seconds(const timespec& a, const timespec& b) {
+  return (b.tv_sec - a.tv_sec) + (b.tv_nsec - a.tv_nsec) * 1e-9;
+}
+
+// Host ns per sample, fastest of `repeat` passes over `in`.
+template <typename F>
+static float filterNs(const std::vector<int16_t>& in, int repeat) {
+  double best = 1e30;
+  for (int r = 0; r < repeat; r++) {
+    F f;
+    int32_t sum = 0;
+    timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int16_t x : in) sum += f.process(x);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    g_sink = g_sink + sum;
+    if (seconds(t0, t1) < best) best = seconds(t0, t1);
+  }
+  return (float)(best * 1e9 / in.size());
+}
+
+static float filterBlockNs(const std::vector<int16_t>& in, size_t block, int repeat) {
+  double best = 1e30;
+  std::vector<int16_t> buf;
+  for (int r = 0; r < repeat; r++) {
+    BlockEcgFilter f;
+    buf = in;
+    timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t i = 0; i < buf.size(); i += block)
+      f.processBlock(&buf[i], buf.size() - i < block ? buf.size() - i : block);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    g_sink = g_sink + buf[buf.size() / 2];
+    if (seconds(t0, t1) < best) best = seconds(t0, t1);
+  }
+  return (float)(best * 1e9 / in.size());
+}
+
+// The ECG filter on its own over 60 s of synthetic ECG (ADC counts).
+// Host numbers: the host has an FPU, so float is not penalised here the
+// way soft-float is on the ESP32-C3.
+static void putFilters(JsonWriter& j, int repeat) {
+  SynthEcg src{SynthEcgParams()};
+  std::vector<int16_t> in(60 * ECG_SAMPLE_HZ);
+  for (size_t k = 0; k < in.size(); k++) in[k] = (int16_t)src.adc((k + 1) * 1000000ull / ECG_SAMPLE_HZ);
+
+  j.key("ecgFilter").beginObject();
+  j.key("samples").value((unsigned long)in.size());
+  j.key("floatHighpassNs").value(filterNs<FloatHighpass>(in, repeat), 2);
+  j.key("floatBiquadNs").value(filterNs<FloatEcgFilter>(in, repeat), 2);
+  j.key("fixedNs").value(filterNs<EcgFilter>(in, repeat), 2);
+  j.key("fixedBlock8Ns").value(filterBlockNs(in, 8, repeat), 2);
+  j.key("fixedBlock64Ns").value(filterBlockNs(in, 64, repeat), 2);
+  j.endObject();
+}
+
+static void stdoutSink(void*, const char* d, size_t n) { fwrite(d, 1, n, stdout); }
+
+struct Summary {
+  double pulseMae = 0, peakMae = 0, spo2Abs = 0, ecgMae = 0, ttfvPulse = 0, ttfvSpo2 = 0;
+  int    nPulse = 0, nPeak = 0, nSpo2 = 0, nEcg = 0, nTtfvPulse = 0, nTtfvSpo2 = 0, falseValid = 0;
+  BeatScore ecgBeats;                     // pooled over the fixtures
+};
+
+struct Run {
+  Track    pulse, pulsePeak, spo2, ecg;
+  BeatScore ecgBeats;
+  bool     hasBeats = false;
+  double   confSum = 0, sqiSum = 0;
+  int      confN = 0;
+  double   piSum = 0;
+  int      piN = 0;
+  double   ledMaSum = 0;                  // LED supply estimate, each second
+  int      proxS = 0, highS = 0;
+  uint32_t i2cTxns = 0;                   // MAX30102 bus transactions
+  bool     hasEcg = false;
+  double   wallS = 0;
+  uint64_t ppgN = 0, ecgN = 0;
+  Cost     spo2Tick, ppgRate, ecgSample;
+};
+
+static void runOnce(Fixture& f, int seconds, Run& r) {
+  HostRig rig;
+  HostRig::Sources src;
+  f.sources(src);
+  rig.begin(src);
+#ifdef ENABLE_STATS
+  statsReset();
+#endif
+  r.hasEcg = src.ecg != nullptr;
+  std::vector<uint64_t> beats;            // detected R peaks, us
+  uint64_t nextBeat = 0;
+
+  timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (int s = 1; s <= seconds; s++) {
+    rig.stepMs(1000);
+    r.pulse.add(s, (float)rig.spo2.bpmRounded(), f.refPulse(s));
+    r.pulsePeak.add(s, (float)rig.spo2.peakBpmRounded(), f.refPulse(s));
+    if (rig.spo2.hasFinger()) {
+      r.confSum += rig.spo2.pulseConfidence();
+      r.sqiSum  += rig.spo2.signalQuality();
+      r.confN++;
+    }
+    r.spo2.add(s, (float)rig.spo2.spo2Rounded(), f.refSpo2(s));
+    if (r.hasEcg) {
+      r.ecg.add(s, (float)rig.ecg.ecgBpm(), f.refEcgBpm(s));
+      QrsBeat b[16];
+      uint64_t first;
+      size_t n = rig.ecg.readBeats(nextBeat, b, 16, first);
+      // sample k is taken at (k + 1) sample periods
+      for (size_t i = 0; i < n; i++) beats.push_back((b[i].sample + 1) * 1000000ull / ECG_SAMPLE_HZ);
+      nextBeat = first + n;
+    }
+    if (rig.spo2.hasFinger()) { r.piSum += rig.spo2.perfusionIndex(); r.piN++; }
+    r.ledMaSum += rig.spo2.ledAvgMa();
+    if (rig.spo2.mode() == Max30102Sensor::MODE_PROX) r.proxS++;
+    if (rig.spo2.mode() == Max30102Sensor::MODE_HIGH) r.highS++;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  r.wallS = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+  r.ppgN = rig.fakeSpo2() ? rig.fakeSpo2()->produced() : 0;
+  r.i2cTxns = rig.bus.stats(I2CBus::DEV_MAX30102).txns;
+  r.ecgN = r.hasEcg ? rig.ecg.sampleIndex() : 0;
+  // beat by beat, past the detector's 2 s learning and before the last second
+  if (r.hasEcg && f.ecgBeats() && seconds > 4) {
+    r.hasBeats = true;
+    r.ecgBeats = scoreBeats(*f.ecgBeats(), beats, 3000000, (uint64_t)(seconds - 1) * 1000000);
+  }
+#ifdef ENABLE_STATS
+  r.spo2Tick.take(STAT_SPO2_POLL, STAT_SPO2_DSP);
+  r.ppgRate.take(STAT_PPG_RATE);
+  if (r.hasEcg) r.ecgSample.take(STAT_ECG_SAMPLE);
+#endif
+}
+
+static void runFixture(JsonWriter& j, Fixture& f, int seconds, int repeat, Summary& sum) {
+  Run r;
+  runOnce(f, seconds, r);
+  for (int k = 1; k < repeat; k++) {
+    Run again;
+    runOnce(f, seconds, again);
+    if (again.wallS < r.wallS) r.wallS = again.wallS;
+    r.spo2Tick.keepFaster(again.spo2Tick);
+    r.ppgRate.keepFaster(again.ppgRate);
+    r.ecgSample.keepFaster(again.ecgSample);
+  }
+
+  j.beginObject();
+  j.key("name").value(f.name());
+  j.key("seconds").value(seconds);
+  putTrack(j, "pulse", r.pulse, false);
+  putTrack(j, "pulsePeak", r.pulsePeak, false);   // legacy detector, for comparison
+  j.key("pulseConfMean").floatOrNull(r.confN ? (float)(r.confSum / r.confN) : NAN, 3);
+  j.key("sqiMean").floatOrNull(r.confN ? (float)(r.sqiSum / r.confN) : NAN, 1);
+  putTrack(j, "spo2", r.spo2, true);
+  if (r.hasEcg) putTrack(j, "ecgBpm", r.ecg, false);
+  if (r.hasBeats) putBeats(j, "ecgBeats", r.ecgBeats);
+  j.key("piMean").floatOrNull(r.piN ? (float)(r.piSum / r.piN) : NAN, 2);
+  j.key("ledMaMean").value((float)(r.ledMaSum / seconds), 3);
+  j.key("proxS").value(r.proxS);
+  j.key("highS").value(r.highS);
+  j.key("i2cTxnPerS").value((float)r.i2cTxns / seconds, 1);
+
+  j.key("cost").beginObject();
+  j.key("wallMs").value((float)(r.wallS * 1000), 2);
+  j.key("realtimeX").value(r.wallS > 0 ? (float)(seconds / r.wallS) : NAN, 0);
+  j.key("ppgSamplesPerSec").value(r.wallS > 0 ? (float)(r.ppgN / r.wallS) : NAN, 0);
+  j.key("ecgSamplesPerSec").value(r.wallS > 0 ? (float)(r.ecgN / r.wallS) : NAN, 0);
+#ifdef ENABLE_STATS
+  r.spo2Tick.put(j, "spo2Tick");
+  r.ppgRate.put(j, "ppgRate");
+  if (r.hasEcg) r.ecgSample.put(j, "ecgSample");
+#endif
+  j.endObject();
+  j.endObject();
+
+  if (r.pulse.scored) { sum.pulseMae += r.pulse.mae(); sum.nPulse++; }
+  if (r.pulsePeak.scored) { sum.peakMae += r.pulsePeak.mae(); sum.nPeak++; }
+  if (r.spo2.scored)  { sum.spo2Abs += fabs(r.spo2.bias()); sum.nSpo2++; }
+  if (r.ecg.scored)   { sum.ecgMae += r.ecg.mae(); sum.nEcg++; }
+  if (r.hasBeats) sum.ecgBeats.add(r.ecgBeats);
+  if (f.finger() && r.pulse.firstValidS >= 0) { sum.ttfvPulse += r.pulse.firstValidS; sum.nTtfvPulse++; }
+  if (f.finger() && r.spo2.firstValidS >= 0)  { sum.ttfvSpo2 += r.spo2.firstValidS; sum.nTtfvSpo2++; }
+  sum.falseValid += r.pulse.falseValid + r.spo2.falseValid + r.ecg.falseValid;
+}
+
+int main(int argc, char** argv) {
+  float seconds = 300;
+  int repeat = 3;
+  const char* only = nullptr;
+  bool builtin = true;
+  std::vector<RecordedFixture*> recorded;
+
+  for (int i = 1; i < argc; i++) {
+    const char* a = argv[i];
+    const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+    if      (!strcmp(a, "--seconds") && v) { seconds = atof(v); i++; }
+    else if (!strcmp(a, "--repeat") && v)  { repeat = atoi(v) > 0 ? atoi(v) : 1; i++; }
+    else if (!strcmp(a, "--only") && v)    { only = v; i++; }
+    else if (!strcmp(a, "--no-builtin"))   builtin = false;
+    else if (!strcmp(a, "--fixture") && v) {
+      RecordedFixture* r = new RecordedFixture();
+      if (!r->load(v)) { fprintf(stderr, "bench: cannot use fixture %s\n", v); return 1; }
+      recorded.push_back(r);
+      i++;
+    } else {
+      fprintf(stderr, "usage: bench [--seconds N] [--repeat R] [--only NAME] [--fixture FILE[:HZ]]... [--no-builtin]\n");
+      return 2;
+    }
+  }
+
+  SynthPpgParams wander = ppg(80, 97, 2);  wander.bpmWander = 10;
+  SynthPpgParams noisy  = ppg(72, 97, 1);  noisy.noise = 0.3f;
+  SynthPpgParams absent = ppg(72, 97, 2);  absent.finger = false;
+  SynthPpgParams motion = ppg(72, 97, 2);  motion.motion = 4;
+  SynthPpgParams bright = ppg(72, 97, 2);  bright.dcIr = 255000;
+  SynthPpgParams dim    = ppg(72, 97, 0.5f);
+  dim.dcIr = 20000; dim.dcRed = 15000; dim.adcNoise = 60;
+  // slow rate, tall T wave and sinus pauses: the R-peak search after a
+  // long gap reached past the band-pass history and stalled the detector
+  SynthEcgParams pause = ecg(50);  pause.tAmp = 2.0f;
+  pause.pauseEveryS = 20; pause.pauseS = 3;
+  SynthEcgParams irregular = ecg(75);  irregular.rrJitter = 0.25f;
+  SynthEcgParams ectopy = ecg(70);  ectopy.ectopicEvery = 5;
+  SynthEcgParams leadsOff = ecg(72);  leadsOff.offEveryS = 30; leadsOff.offS = 4;
+  SynthEcgParams dropout = ecg(72);  dropout.dropEveryS = 20; dropout.dropS = 2;
+  SynthFixture synth[] = {
+    SynthFixture("rest",          ppg(72, 98, 2.0f)),
+    SynthFixture("brady",         ppg(45, 97, 2.0f)),
+    SynthFixture("tachy",         ppg(150, 96, 1.5f)),
+    SynthFixture("low_perfusion", ppg(80, 97, 0.3f)),
+    SynthFixture("hypoxia",       ppg(75, 88, 2.0f)),
+    SynthFixture("noisy",         noisy),
+    SynthFixture("hr_wander",     wander),
+    SynthFixture("motion",        motion),
+    SynthFixture("saturated",     bright),
+    SynthFixture("dim",           dim),
+    SynthFixture("no_finger",     absent, false),
+    SynthFixture("ecg_pause",     ppg(50, 97, 2.0f), pause),
+    SynthFixture("ecg_irregular", ppg(75, 97, 2.0f), irregular),
+    SynthFixture("ecg_ectopy",    ppg(70, 97, 2.0f), ectopy),
+    SynthFixture("ecg_leads_off", ppg(72, 97, 2.0f), leadsOff),
+    SynthFixture("ecg_dropout",   ppg(72, 97, 2.0f), dropout),
+  };
+
+  std::vector<Fixture*> all;
+  if (builtin) for (SynthFixture& f : synth) all.push_back(&f);
+  for (RecordedFixture* r : recorded) all.push_back(r);
+
+  char buf[512];
+  JsonWriter j(buf, sizeof(buf), stdoutSink);
+  j.beginObject();
+  j.key("schema").value(1);
+  j.key("build").beginObject();
+  j.key("compiler").value(__VERSION__);
+  j.key("ecgSampleHz").value(ECG_SAMPLE_HZ);
+  j.key("stats").value(
+#ifdef ENABLE_STATS
+    true
+#else
+    false
+#endif
+  );
+  j.endObject();
+
+  // static state per driver instance (host sizes; pointers are 8 bytes
+  // here and 4 on the ESP32-C3)
+  j.key("memory").beginObject();
+  j.key("max30102Bytes").value((unsigned long)sizeof(Max30102Sensor));
+  j.key("ad8232Bytes").value((unsigned long)sizeof(AD8232Sensor));
+  j.key("max30205Bytes").value((unsigned long)sizeof(Max30205Sensor));
+  j.key("i2cBusBytes").value((unsigned long)sizeof(I2CBus));
+  j.key("pointerBytes").value((unsigned long)sizeof(void*));
+  j.endObject();
+
+  putFilters(j, repeat);
+
+  Summary sum;
+  j.key("fixtures").beginArray();
+  for (Fixture* f : all) {
+    if (only && strcmp(only, f->name())) continue;
+    RecordedFixture* r = nullptr;
+    for (RecordedFixture* x : recorded) if (x == f) r = x;
+    runFixture(j, *f, (int)(r ? r->seconds() : seconds), repeat, sum);
+  }
+  j.endArray();
+
+  j.key("summary").beginObject();
+  j.key("pulseMae").floatOrNull(sum.nPulse ? (float)(sum.pulseMae / sum.nPulse) : NAN, 2);
+  j.key("pulsePeakMae").floatOrNull(sum.nPeak ? (float)(sum.peakMae / sum.nPeak) : NAN, 2);
+  j.key("spo2AbsBias").floatOrNull(sum.nSpo2 ? (float)(sum.spo2Abs / sum.nSpo2) : NAN, 2);
+  j.key("ecgBpmMae").floatOrNull(sum.nEcg ? (float)(sum.ecgMae / sum.nEcg) : NAN, 2);
+  j.key("ecgBeatSens").floatOrNull(sum.ecgBeats.sensitivity(), 4);
+  j.key("ecgBeatPpv").floatOrNull(sum.ecgBeats.ppv(), 4);
+  j.key("pulseFirstValidS").floatOrNull(sum.nTtfvPulse ? (float)(sum.ttfvPulse / sum.nTtfvPulse) : NAN, 1);
+  j.key("spo2FirstValidS").floatOrNull(sum.nTtfvSpo2 ? (float)(sum.ttfvSpo2 / sum.nTtfvSpo2) : NAN, 1);
+  j.key("falseValid").value(sum.falseValid);
+  j.endObject();
+  j.endObject();
+  j.flush();
+  printf("\n");
+
+  for (RecordedFixture* r : recorded) delete r;
+  return 0;
+}
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Compare two bench JSON reports and fail on regressions.
+
+    ./build/bench > new.json
+    python3 tools/bench_compare.py baseline.json new.json
+
+Accuracy is compared per fixture with absolute tolerances; run time per
+tick (meanNs) with a loose relative one: it depends on the machine, so
+only compare reports from the same one. Exits 1 if anything got worse by
+more than its tolerance, so it can gate CI.
+"""
+import argparse
+import json
+import sys
+
+# (track, field, tolerance, direction): +1 = higher is worse
+ACCURACY = [
+    ("pulse", "mae", 1.0, +1),
+    ("pulse", "firstValidS", 2, +1),
+    ("pulse", "coverage", 0.05, -1),
+    ("pulse", "falseValid", 0, +1),
+    ("spo2", "bias", 1.0, 0),           # 0 = |value| is compared
+    ("spo2", "mae", 1.0, +1),
+    ("spo2", "firstValidS", 2, +1),
+    ("spo2", "coverage", 0.05, -1),
+    ("spo2", "falseValid", 0, +1),
+    ("ecgBpm", "mae", 1.0, +1),
+    ("ecgBpm", "firstValidS", 2, +1),
+    ("ecgBpm", "coverage", 0.05, -1),
+    ("ecgBeats", "sensitivity", 0.01, -1),
+    ("ecgBeats", "ppv", 0.01, -1),
+]
+COST = [("spo2Tick", "meanNs"), ("ecgSample", "meanNs")]
+
+
+def worse(old, new, tol, direction):
+    if old is None:
+        return False
+    if new is None:
+        return True
+    if direction == 0:
+        old, new, direction = abs(old), abs(new), +1
+    return (new - old) * direction > tol
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--cost-tolerance", type=float, default=0.5,
+                    help="allowed relative increase of meanNs (default 0.5)")
+    args = ap.parse_args()
+
+    base = {f["name"]: f for f in json.load(open(args.baseline))["fixtures"]}
+    cur = {f["name"]: f for f in json.load(open(args.current))["fixtures"]}
+
+    bad = 0
+    for name, c in cur.items():
+        b = base.get(name)
+        if b is None:
+            print("%-16s new fixture" % name)
+            continue
+        for track, field, tol, direction in ACCURACY:
+            if track not in b:
+                continue
+            old, new = b[track].get(field), c.get(track, {}).get(field)
+            if worse(old, new, tol, direction):
+                bad += 1
+                print("%-16s %s.%s: %s -> %s" % (name, track, field, old, new))
+        for probe, field in COST:
+            old = b.get("cost", {}).get(probe, {}).get(field)
+            new = c.get("cost", {}).get(probe, {}).get(field)
+            if old and new and new > old * (1 + args.cost_tolerance):
+                bad += 1
+                print("%-16s cost.%s.%s: %.0f -> %.0f ns (+%.0f%%)"
+                      % (name, probe, field, old, new, 100 * (new / old - 1)))
+    for name in base:
+        if name not in cur:
+            print("%-16s missing from current report" % name)
+    print("%d regression(s)" % bad)
+    sys.exit(1 if bad else 0)
+
+
+if __name__ == "__main__":
+    main()
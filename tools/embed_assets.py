@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Gzip the dashboard files in web/ into web_assets.h (PROGMEM arrays).
+
+Run from anywhere after editing web/:
+
+    python3 tools/embed_assets.py
+
+Each file web/<name>.<ext> becomes
+
+    WEB_<NAME>_<EXT>_GZ[]      gzip bytes (PROGMEM)
+    WEB_<NAME>_<EXT>_GZ_LEN    length in bytes
+    WEB_<NAME>_<EXT>_ETAG      strong ETag (quoted), hash of the source file
+
+Output is deterministic (no gzip timestamp/name), so the header only changes
+when the sources do.
+"""
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SRC_DIR = os.path.join(ROOT, "web")
+OUT = os.path.join(ROOT, "web_assets.h")
+
+
+def symbol(name):
+    return "WEB_" + re.sub(r"[^A-Za-z0-9]", "_", name).upper()
+
+
+def gzip_bytes(data):
+    # mtime=0 and no file name keep the output reproducible
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def emit(name, raw):
+    gz = gzip_bytes(raw)
+    etag = hashlib.sha256(raw).hexdigest()[:16]
+    sym = symbol(name)
+    lines = ["// %s: %d bytes -> %d gzipped" % (name, len(raw), len(gz)),
+             "static const uint8_t %s_GZ[] PROGMEM = {" % sym]
+    for i in range(0, len(gz), 16):
+        lines.append("  " + ",".join("0x%02x" % b for b in gz[i:i + 16]) + ",")
+    lines.append("};")
+    lines.append("static const size_t %s_GZ_LEN = %d;" % (sym, len(gz)))
+    lines.append("static const char %s_ETAG[] = \"\\\"%s\\\"\";" % (sym, etag))
+    return "\n".join(lines)
+
+
+def main():
+    names = sorted(n for n in os.listdir(SRC_DIR)
+                   if os.path.isfile(os.path.join(SRC_DIR, n)))
+    if not names:
+        sys.exit("no files in %s" % SRC_DIR)
+    parts = ["// web_assets.h",
+             "// Generated by tools/embed_assets.py from web/ -- do not edit.",
+             "#pragma once",
+             "#include <Arduino.h>",
+             ""]
+    for n in names:
+        with open(os.path.join(SRC_DIR, n), "rb") as f:
+            parts.append(emit(n, f.read()))
+        parts.append("")
+    with open(OUT, "w", newline="\n") as f:
+        f.write("\n".join(parts))
+    print("wrote %s (%d asset%s)" % (os.path.relpath(OUT, ROOT), len(names),
+                                     "" if len(names) == 1 else "s"))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Decode flash log blocks (log_block.h) into CSV.
+
+Input is either the body of /api/log (stored blocks back to back):
+
+    curl -o log.bin "http://esp32c3-health.local/api/log?flush=1"
+    python3 tools/log_decode.py log.bin --out mylog
+
+or a dump of the LittleFS ("spiffs") partition, which needs the
+littlefs-python package (pip install littlefs-python):
+
+    esptool.py read_flash 0x290000 0x170000 fs.bin   # offsets: see partitions
+    python3 tools/log_decode.py --image fs.bin --out mylog
+
+Writes <out>_ecg.csv (boot, seq, sample index, ms, unix s, value) and
+<out>_vitals.csv, and prints a block summary. Blocks with a bad CRC are
+reported and skipped.
+"""
+import argparse
+import csv
+import struct
+import sys
+import zlib
+
+MAGIC = 0x424C4D48          # "HMLB"
+VERSIONS = (1, 2)           # 2 added the signal quality byte to vitals
+TYPE_ECG, TYPE_VITALS = 1, 2
+BLOCK = 4096
+HDR = struct.Struct("<IBBHIIIIQHHI")     # 40 bytes
+VITALS_V1 = struct.Struct("<BBBBHh")     # 8 bytes
+VITALS = struct.Struct("<BBBBHhB")       # 9 bytes
+VF_FINGER, VF_LEADOFF = 0x01, 0x02
+
+
+def parse_header(blk):
+    (magic, ver, typ, payload, seq, boot, t_ms, t_epoch,
+     first, rate, count, crc) = HDR.unpack_from(blk)
+    if magic != MAGIC or ver not in VERSIONS or payload > BLOCK - HDR.size:
+        return None
+    return dict(version=ver, type=typ, payload=payload, seq=seq, boot=boot, t_ms=t_ms,
+                t_epoch=t_epoch, first=first, rate=rate, count=count, crc=crc)
+
+
+def crc_ok(blk, h):
+    crc = zlib.crc32(blk[:36])
+    crc = zlib.crc32(blk[HDR.size:HDR.size + h["payload"]], crc)
+    return crc == h["crc"]
+
+
+def unzigzag(z):
+    return (z >> 1) ^ -(z & 1)
+
+
+def decode_ecg(blk, h):
+    p = blk[HDR.size:HDR.size + h["payload"]]
+    if h["count"] == 0:
+        return []
+    prev = struct.unpack_from("<h", p)[0]
+    out = [prev]
+    bits = int.from_bytes(p[2:], "little")   # LSB-first bit stream
+    pos = 0
+
+    def take(n):
+        nonlocal pos
+        v = (bits >> pos) & ((1 << n) - 1)
+        pos += n
+        return v
+
+    while len(out) < h["count"]:
+        w = take(4)
+        for _ in range(min(16, h["count"] - len(out))):
+            prev += unzigzag(take(w)) if w else 0
+            out.append(prev)
+    return out
+
+
+def decode_vitals(blk, h):
+    recs = []
+    rec = VITALS_V1 if h["version"] == 1 else VITALS
+    for i in range(h["count"]):
+        fields = rec.unpack_from(blk, HDR.size + i * rec.size)
+        pulse, spo2, ebpm, flags, pi, temp = fields[:6]
+        recs.append(dict(
+            sqi=fields[6] if len(fields) > 6 else "",
+            pulse=None if pulse == 0xFF else pulse,
+            spo2=None if spo2 == 0xFF else spo2,
+            ecg_bpm=None if ebpm == 0xFF else ebpm,
+            finger=int(bool(flags & VF_FINGER)),
+            leads_off=int(bool(flags & VF_LEADOFF)),
+            pi=pi / 100.0,
+            temp_c=None if temp == 0x7FFF else temp / 100.0))
+    return recs
+
+
+def blocks_from_stream(data):
+    for off in range(0, len(data) - BLOCK + 1, BLOCK):
+        yield data[off:off + BLOCK]
+
+
+def blocks_from_image(path):
+    try:
+        from littlefs import LittleFS
+    except ImportError:
+        sys.exit("--image needs littlefs-python (pip install littlefs-python)")
+    img = open(path, "rb").read()
+    fs = LittleFS(block_size=4096, block_count=len(img) // 4096, mount=False)
+    fs.context.buffer = bytearray(img)
+    fs.mount()
+    for name in sorted(fs.listdir("/log")):
+        if not name.endswith(".seg"):
+            continue
+        with fs.open("/log/" + name, "rb") as f:
+            yield from blocks_from_stream(f.read())
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("input", help="/api/log body, or a partition dump with --image")
+    ap.add_argument("--image", action="store_true", help="input is a LittleFS image")
+    ap.add_argument("--out", default="healthlog", help="CSV file prefix")
+    args = ap.parse_args()
+
+    blocks = (blocks_from_image(args.input) if args.image
+              else blocks_from_stream(open(args.input, "rb").read()))
+
+    n_ecg = n_vit = bad = 0
+    with open(args.out + "_ecg.csv", "w", newline="") as fe, \
+         open(args.out + "_vitals.csv", "w", newline="") as fv:
+        we, wv = csv.writer(fe), csv.writer(fv)
+        we.writerow(["boot", "seq", "index", "ms", "unix", "value"])
+        wv.writerow(["boot", "seq", "ms", "unix", "pulse", "spo2", "ecg_bpm",
+                     "finger", "leads_off", "pi", "temp_c", "sqi"])
+        for blk in blocks:
+            h = parse_header(blk)
+            if h is None or not crc_ok(blk, h):
+                bad += 1
+                continue
+            if h["type"] == TYPE_ECG:
+                n_ecg += 1
+                rate = h["rate"] or 1
+                for i, v in enumerate(decode_ecg(blk, h)):
+                    ms = h["t_ms"] + i * 1000 // rate
+                    unix = "%.3f" % (h["t_epoch"] + i / rate) if h["t_epoch"] else ""
+                    we.writerow([h["boot"], h["seq"], h["first"] + i, ms, unix, v])
+            elif h["type"] == TYPE_VITALS:
+                n_vit += 1
+                for i, r in enumerate(decode_vitals(blk, h)):
+                    unix = h["t_epoch"] + i if h["t_epoch"] else ""
+                    wv.writerow([h["boot"], h["seq"], h["t_ms"] + i * 1000, unix,
+                                 r["pulse"], r["spo2"], r["ecg_bpm"], r["finger"],
+                                 r["leads_off"], r["pi"], r["temp_c"], r["sqi"]])
+    print("%d ECG blocks, %d vitals blocks, %d bad -> %s_ecg.csv, %s_vitals.csv"
+          % (n_ecg, n_vit, bad, args.out, args.out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,124 @@
+// tools/replay.cpp
+// Runs the sensor stack on fake hardware (host/) against synthetic or
+// recorded traces, faster than real time, and prints one CSV row per
+// second of virtual time: what the firmware would show at that moment.
+//
+//   replay [--seconds N] [--bpm B] [--spo2 S] [--pi P] [--temp C]
+//          [--ppg FILE [--ppg-hz HZ] [--ppg-cols RED,IR]]
+//          [--ecg FILE [--ecg-hz HZ] [--ecg-col N] [--ecg-scale K] [--ecg-offset A]]
+//          [--no-ppg] [--no-ecg] [--no-temp] [--stats]
+//
+// Without --ppg/--ecg the synthetic generators in host/fake_devices.h are
+// used with --bpm/--spo2/--pi. CSV files: numeric columns, any separator,
+// header lines skipped; they loop when shorter than --seconds.
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "host_rig.h"
+#include "util_stats.h"
+
+static void usage() {
+  fprintf(stderr,
+    "usage: replay [--seconds N] [--bpm B] [--spo2 S] [--pi P] [--temp C]\n"
+    "              [--ppg FILE [--ppg-hz HZ] [--ppg-cols RED,IR]]\n"
+    "              [--ecg FILE [--ecg-hz HZ] [--ecg-col N] [--ecg-scale K] [--ecg-offset A]]\n"
+    "              [--no-ppg] [--no-ecg] [--no-temp] [--stats]\n");
+  exit(2);
+}
+
+int main(int argc, char** argv) {
+  float seconds = 60;
+  SynthPpgParams pp;
+  SynthEcgParams ep;
+  float tempC = 36.6f;
+  const char* ppgFile = nullptr; float ppgHz = 50; int redCol = 0, irCol = 1;
+  const char* ecgFile = nullptr; float ecgHz = ECG_SAMPLE_HZ; int ecgCol = 0;
+  float ecgScale = 1, ecgOffset = 0;
+  bool noPpg = false, noEcg = false, stats = false;
+
+  for (int i = 1; i < argc; i++) {
+    const char* a = argv[i];
+    const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+    bool takes = true;
+    if      (!strcmp(a, "--seconds") && v)    seconds = atof(v);
+    else if (!strcmp(a, "--bpm") && v)        pp.bpm = ep.bpm = atof(v);
+    else if (!strcmp(a, "--spo2") && v)       pp.spo2 = atof(v);
+    else if (!strcmp(a, "--pi") && v)         pp.pi = atof(v);
+    else if (!strcmp(a, "--temp") && v)       tempC = atof(v);
+    else if (!strcmp(a, "--ppg") && v)        ppgFile = v;
+    else if (!strcmp(a, "--ppg-hz") && v)     ppgHz = atof(v);
+    else if (!strcmp(a, "--ppg-cols") && v) { if (sscanf(v, "%d,%d", &redCol, &irCol) != 2) usage(); }
+    else if (!strcmp(a, "--ecg") && v)        ecgFile = v;
+    else if (!strcmp(a, "--ecg-hz") && v)     ecgHz = atof(v);
+    else if (!strcmp(a, "--ecg-col") && v)    ecgCol = atoi(v);
+    else if (!strcmp(a, "--ecg-scale") && v)  ecgScale = atof(v);
+    else if (!strcmp(a, "--ecg-offset") && v) ecgOffset = atof(v);
+    else {
+      takes = false;
+      if      (!strcmp(a, "--no-ppg"))  noPpg = true;
+      else if (!strcmp(a, "--no-ecg"))  noEcg = true;
+      else if (!strcmp(a, "--no-temp")) tempC = NAN;
+      else if (!strcmp(a, "--stats"))   stats = true;
+      else usage();
+    }
+    if (takes) i++;
+  }
+
+  CsvTrace ppgTrace, ecgTrace;
+  SynthPpg synthPpg(pp);
+  SynthEcg synthEcg(ep);
+  PpgSource* ppg = noPpg ? nullptr : &synthPpg;
+  EcgSource* ecg = noEcg ? nullptr : &synthEcg;
+  if (ppgFile) {
+    if (!ppgTrace.load(ppgFile) || (size_t)redCol >= ppgTrace.cols() || (size_t)irCol >= ppgTrace.cols()) {
+      fprintf(stderr, "replay: cannot use %s\n", ppgFile);
+      return 1;
+    }
+    ppg = new CsvPpg(ppgTrace, redCol, irCol, ppgHz);
+  }
+  if (ecgFile) {
+    if (!ecgTrace.load(ecgFile) || (size_t)ecgCol >= ecgTrace.cols()) {
+      fprintf(stderr, "replay: cannot use %s\n", ecgFile);
+      return 1;
+    }
+    ecg = new CsvEcg(ecgTrace, ecgCol, ecgHz, ecgScale, ecgOffset);
+  }
+
+  HostRig rig;
+  HostRig::Sources src;
+  src.ppg = ppg;
+  src.ecg = ecg;
+  src.tempC = tempC;
+  rig.begin(src);
+#ifdef ENABLE_STATS
+  statsReset();
+#endif
+
+  printf("t_s,ecg_bpm,pulse,spo2,pi,sqi,finger,temp_c,ecg_dropped,fifo_overflows\n");
+  timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  uint32_t total = (uint32_t)(seconds * 1000);
+  for (uint32_t s = 1; s * 1000 <= total; s++) {
+    rig.stepMs(1000);
+    printf("%lu,%d,%d,%d,%.2f,%d,%d,", (unsigned long)s,
+           ecg ? rig.ecg.ecgBpm() : -1, rig.spo2.bpmRounded(), rig.spo2.spo2Rounded(),
+           rig.spo2.perfusionIndex(), rig.spo2.signalQuality(), rig.spo2.hasFinger() ? 1 : 0);
+    if (rig.tprobe.hasTemp()) printf("%.2f,", rig.tprobe.tempC());
+    else                      printf(",");
+    printf("%lu,%lu\n", (unsigned long)rig.ecg.droppedSamples(),
+           (unsigned long)rig.spo2.fifoOverflows());
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  double wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+  fprintf(stderr, "replayed %.0f s in %.3f s (%.0fx real time)\n",
+          total / 1000.0, wall, wall > 0 ? total / 1000.0 / wall : 0.0);
+#ifdef ENABLE_STATS
+  if (stats) statsPrint(Serial);       // host cycle counter: 1 cycle = 1 ns
+#else
+  (void)stats;
+#endif
+  return 0;
+}
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Convert a PhysioNet (WFDB) ECG record into a bench fixture.
+
+Reads <record>.hea, the signal file it names (format 212 or 16) and the
+reference beat annotations <record>.<ann> (MIT format, as in the MIT-BIH
+Arrhythmia Database), and writes the 3-column ECG fixture tools/bench.cpp
+takes: adc, ref_bpm, beat.
+
+    # https://physionet.org/content/mitdb/1.0.0/ : 100.hea 100.dat 100.atr
+    python3 tools/wfdb_to_fixture.py mitdb/100 --seconds 300 --out mitdb100.csv
+    ./build/bench --fixture mitdb100.csv:360
+
+adc is the chosen channel in mV scaled to ADC counts around mid-scale
+(--counts-per-mv, default 700, the R amplitude of the synthetic fixtures).
+beat is 1 on the sample of each QRS annotation (normal, bundle branch,
+ectopic, paced, fusion, ...; rhythm, noise and comment annotations are
+dropped), ref_bpm the mean of the last 8 annotated R-R intervals, as
+SensorAD8232 reports it (nan before the second beat). The record's own
+rate is kept; pass it to bench after the file name.
+"""
+import argparse
+import os
+import sys
+
+# MIT annotation codes that mark a QRS complex (ecgcodes.h, isqrs())
+QRS_CODES = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 25, 30, 31, 34, 35, 38}
+SKIP, NUM, SUB, CHN, AUX = 59, 60, 61, 62, 63
+ADC_MID, ADC_MAX = 2048, 4095
+RR_AVG = 8
+
+
+def read_header(path):
+    lines = [l.split() for l in open(path) if l.strip() and not l.startswith("#")]
+    rec = lines[0]
+    nsig = int(rec[1])
+    fs = float(rec[2].split("/")[0]) if len(rec) > 2 else 250.0
+    sigs = []
+    for f in lines[1:1 + nsig]:
+        gain_s = f[2] if len(f) > 2 else "200"
+        base = None
+        if "(" in gain_s:
+            base = int(gain_s[gain_s.index("(") + 1:gain_s.index(")")])
+        gain = float(gain_s.split("(")[0].split("/")[0]) or 200.0
+        zero = int(f[4]) if len(f) > 4 else 0
+        sigs.append(dict(file=f[0], fmt=int(f[1].split("x")[0].split(":")[0]),
+                         gain=gain, baseline=zero if base is None else base,
+                         desc=" ".join(f[8:]) if len(f) > 8 else ""))
+    return fs, sigs
+
+
+def read_212(data, nsig):
+    out = []
+    for i in range(0, len(data) - 2, 3):
+        b0, b1, b2 = data[i], data[i + 1], data[i + 2]
+        for v in (b0 | ((b1 & 0x0F) << 8), b2 | ((b1 & 0xF0) << 4)):
+            out.append(v - 4096 if v & 0x800 else v)
+    return [out[s::nsig] for s in range(nsig)]
+
+
+def read_16(data, nsig):
+    out = [int.from_bytes(data[i:i + 2], "little", signed=True)
+           for i in range(0, len(data) - 1, 2)]
+    return [out[s::nsig] for s in range(nsig)]
+
+
+def read_annotations(path):
+    """Sample indices of the QRS annotations in an MIT-format file."""
+    data = open(path, "rb").read()
+    t, i, beats = 0, 0, []
+    while i + 1 < len(data):
+        w = data[i] | (data[i + 1] << 8)
+        i += 2
+        code, val = w >> 10, w & 0x3FF
+        if code == 0 and val == 0:
+            break
+        if code == SKIP:                        # 32-bit interval, high word first
+            hi = data[i] | (data[i + 1] << 8)
+            lo = data[i + 2] | (data[i + 3] << 8)
+            skip = (hi << 16) | lo
+            t += skip - (1 << 32) if skip & 0x80000000 else skip
+            i += 4
+        elif code == AUX:
+            i += val + (val & 1)
+        elif code in (NUM, SUB, CHN):
+            pass
+        else:
+            t += val
+            if code in QRS_CODES:
+                beats.append(t)
+    return beats
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("record", help="record path without extension, e.g. mitdb/100")
+    ap.add_argument("--ann", default="atr", help="annotator (file extension), default atr")
+    ap.add_argument("--channel", type=int, default=0, help="signal number, default 0 (MLII on mitdb)")
+    ap.add_argument("--seconds", type=float, default=0, help="only the first N seconds")
+    ap.add_argument("--counts-per-mv", type=float, default=700.0)
+    ap.add_argument("--out", required=True)
+    a = ap.parse_args()
+
+    fs, sigs = read_header(a.record + ".hea")
+    if not 0 <= a.channel < len(sigs):
+        sys.exit("record has %d signals" % len(sigs))
+    sig = sigs[a.channel]
+    group = [s for s in sigs if s["file"] == sig["file"]]
+    data = open(os.path.join(os.path.dirname(a.record), sig["file"]), "rb").read()
+    if sig["fmt"] == 212:
+        chans = read_212(data, len(group))
+    elif sig["fmt"] == 16:
+        chans = read_16(data, len(group))
+    else:
+        sys.exit("signal format %d not supported (212, 16)" % sig["fmt"])
+    x = chans[group.index(sig)]
+    n = len(x) if a.seconds <= 0 else min(len(x), int(a.seconds * fs))
+
+    beats = [b for b in read_annotations(a.record + "." + a.ann) if b < n]
+    mark = set(beats)
+    bi, rr = 0, []
+    clipped = 0
+    with open(a.out, "w") as f:
+        f.write("# %s ch %d (%s), %g Hz, %d QRS annotations: adc, ref_bpm, beat\n"
+                % (os.path.basename(a.record), a.channel, sig["desc"], fs, len(beats)))
+        for k in range(n):
+            while bi < len(beats) and beats[bi] <= k:
+                if bi > 0:
+                    rr.append((beats[bi] - beats[bi - 1]) / fs)
+                    del rr[:-RR_AVG]
+                bi += 1
+            mv = (x[k] - sig["baseline"]) / sig["gain"]
+            adc = int(round(ADC_MID + mv * a.counts_per_mv))
+            if adc < 0 or adc > ADC_MAX:
+                clipped += 1
+                adc = min(max(adc, 0), ADC_MAX)
+            bpm = "%.1f" % (60.0 * len(rr) / sum(rr)) if rr else "nan"
+            f.write("%d,%s,%d\n" % (adc, bpm, 1 if k in mark else 0))
+    print("%s: %d samples at %g Hz, %d beats, %d clipped -> %s (bench --fixture %s:%g)"
+          % (a.record, n, fs, len(beats), clipped, a.out, a.out, fs))
+
+
+if __name__ == "__main__":
+    main()
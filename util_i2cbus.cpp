@@ -0,0 +1,89 @@
+// util_i2cbus.cpp
+#include "util_i2cbus.h"
+
+void I2CBus::begin(TwoWire& wire, int sda, int scl, uint32_t hz) {
+  _wire = &wire;
+  _hz = hz;
+  if (!_mtx) _mtx = xSemaphoreCreateRecursiveMutex();
+  _wire->begin(sda, scl);
+  _wire->setClock(hz);
+  resetStats();
+}
+
+void I2CBus::lock()   { xSemaphoreTakeRecursive(_mtx, portMAX_DELAY); }
+void I2CBus::unlock() { xSemaphoreGiveRecursive(_mtx); }
+
+void I2CBus::_account(Dev d, uint32_t t0, size_t bytes, bool ok) {
+  DevStats& s = _st[d < DEV_COUNT ? d : DEV_OTHER];
+  s.txns++;
+  s.bytes  += bytes;
+  s.busyUs += micros() - t0;
+  if (!ok) s.errors++;
+}
+
+bool I2CBus::probe(Dev d, uint8_t addr) {
+  lock();
+  uint32_t t0 = micros();
+  _wire->beginTransmission(addr);
+  bool ok = _wire->endTransmission() == 0;
+  _account(d, t0, 0, ok);
+  unlock();
+  return ok;
+}
+
+bool I2CBus::write(Dev d, uint8_t addr, const uint8_t* data, size_t n) {
+  lock();
+  uint32_t t0 = micros();
+  _wire->beginTransmission(addr);
+  _wire->write(data, n);
+  bool ok = _wire->endTransmission() == 0;
+  _account(d, t0, n, ok);
+  unlock();
+  return ok;
+}
+
+bool I2CBus::writeReg(Dev d, uint8_t addr, uint8_t reg, uint8_t val) {
+  uint8_t b[2] = { reg, val };
+  return write(d, addr, b, 2);
+}
+
+bool I2CBus::readRegs(Dev d, uint8_t addr, uint8_t reg, uint8_t* out, size_t n,
+                      bool repeatedStart) {
+  lock();
+  uint32_t t0 = micros();
+  _wire->beginTransmission(addr);
+  _wire->write(reg);
+  bool ok = _wire->endTransmission(!repeatedStart) == 0;
+  size_t got = 0;
+  while (ok && got < n) {
+    size_t m = (n - got < CHUNK) ? n - got : CHUNK;
+    ok = _wire->requestFrom(addr, m, true) == m;
+    for (size_t i = 0; ok && i < m; i++) out[got++] = (uint8_t)_wire->read();
+  }
+  _account(d, t0, 1 + got, ok);
+  unlock();
+  return ok;
+}
+
+const char* I2CBus::devName(Dev d) {
+  switch (d) {
+    case DEV_OLED:     return "oled";
+    case DEV_MAX30102: return "max30102";
+    case DEV_MAX30205: return "max30205";
+    default:           return "other";
+  }
+}
+
+float I2CBus::busyFraction() const {
+  uint64_t busy = 0;
+  for (int i = 0; i < DEV_COUNT; i++) busy += _st[i].busyUs;
+  uint32_t elMs = millis() - _statsT0;
+  return elMs ? (float)((double)busy / (elMs * 1000.0)) : 0.0f;
+}
+
+void I2CBus::resetStats() {
+  lock();
+  memset(_st, 0, sizeof(_st));
+  _statsT0 = millis();
+  unlock();
+}
@@ -0,0 +1,58 @@
+// util_i2cbus.h
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Shared I2C bus arbiter for the OLED and the sensors.
+// Every transfer is one Wire transaction taken under a recursive mutex, so
+// tasks can share the bus and a caller can hold lock() across several
+// transfers to batch them. The OLED goes out in small transfers (one per
+// u8g2 chunk), so a sensor read waits at most one chunk; with the task
+// split the waiting sensor task's priority is inherited by the holder.
+// Per-device transaction/byte/error counts and bus-busy time are kept for
+// /api/i2c.
+class I2CBus {
+public:
+  enum Dev : uint8_t { DEV_OLED, DEV_MAX30102, DEV_MAX30205, DEV_OTHER, DEV_COUNT };
+
+  struct DevStats {
+    uint32_t txns;
+    uint32_t bytes;
+    uint32_t errors;
+    uint64_t busyUs;          // time spent in this device's transfers
+  };
+
+  void     begin(TwoWire& wire, int sda, int scl, uint32_t hz);
+  uint32_t clockHz() const { return _hz; }
+
+  // Hold the bus across several transfers (recursive).
+  void lock();
+  void unlock();
+
+  bool probe(Dev d, uint8_t addr);
+  bool write(Dev d, uint8_t addr, const uint8_t* data, size_t n);
+  bool writeReg(Dev d, uint8_t addr, uint8_t reg, uint8_t val);
+  // Register read; long reads are split to fit the Wire buffer (the device
+  // must keep its address pointer, as FIFO data registers do).
+  // repeatedStart=false puts a STOP between the address and data phases.
+  bool readRegs(Dev d, uint8_t addr, uint8_t reg, uint8_t* out, size_t n,
+                bool repeatedStart = true);
+
+  const DevStats& stats(Dev d) const { return _st[d < DEV_COUNT ? d : DEV_OTHER]; }
+  static const char* devName(Dev d);
+  float busyFraction() const;     // share of wall time the bus was in use
+  void  resetStats();
+
+private:
+  static const size_t CHUNK = 128;   // Wire (I2C_BUFFER_LENGTH) on ESP32
+
+  TwoWire*          _wire = nullptr;
+  SemaphoreHandle_t _mtx  = nullptr;
+  uint32_t          _hz   = 100000;
+  DevStats          _st[DEV_COUNT];
+  uint32_t          _statsT0 = 0;
+
+  void _account(Dev d, uint32_t t0, size_t bytes, bool ok);
+};
@@ -0,0 +1,107 @@
+#include "util_jsonw.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+JsonWriter::JsonWriter(char* buf, size_t cap, Sink sink, void* ctx)
+  : _buf(buf), _cap(cap), _sink(sink), _ctx(ctx) {
+  if (_cap) _buf[0] = 0;
+}
+
+void JsonWriter::_put(const char* s, size_t n) {
+  while (n) {
+    size_t room = _cap - 1 - _len;               // keep a NUL terminator
+    if (!room) {
+      if (!_sink || !_len) { _overflow = true; return; }
+      flush();
+      continue;
+    }
+    size_t k = n < room ? n : room;
+    memcpy(_buf + _len, s, k);
+    _len += k; s += k; n -= k;
+    _buf[_len] = 0;
+  }
+}
+
+void JsonWriter::_put(const char* s) { _put(s, strlen(s)); }
+
+void JsonWriter::flush() {
+  if (_sink && _len) { _sink(_ctx, _buf, _len); _len = 0; _buf[0] = 0; }
+}
+
+// comma before every element except the first at its level (keys own it)
+void JsonWriter::_sep() {
+  if (_afterKey) { _afterKey = false; return; }
+  uint32_t bit = 1u << _depth;
+  if (_first & bit) _first &= ~bit;
+  else _putc(',');
+}
+
+void JsonWriter::_open(char c) {
+  _sep();
+  _putc(c);
+  if (_depth < 31) _depth++;
+  _first |= 1u << _depth;
+}
+
+void JsonWriter::_close(char c) {
+  if (_depth) _depth--;
+  _putc(c);
+}
+
+JsonWriter& JsonWriter::beginObject() { _open('{');  return *this; }
+JsonWriter& JsonWriter::endObject()   { _close('}'); return *this; }
+JsonWriter& JsonWriter::beginArray()  { _open('[');  return *this; }
+JsonWriter& JsonWriter::endArray()    { _close(']'); return *this; }
+
+JsonWriter& JsonWriter::key(const char* k) {
+  value(k);
+  _putc(':');
+  _afterKey = true;
+  return *this;
+}
+
+JsonWriter& JsonWriter::value(int v) { return value((long long)v); }
+JsonWriter& JsonWriter::value(unsigned v) { return value((unsigned long long)v); }
+
+JsonWriter& JsonWriter::value(long long v) {
+  char t[24]; int n = snprintf(t, sizeof(t), "%lld", v);
+  _sep(); _put(t, (size_t)n);
+  return *this;
+}
+
+JsonWriter& JsonWriter::value(unsigned long long v) {
+  char t[24]; int n = snprintf(t, sizeof(t), "%llu", v);
+  _sep(); _put(t, (size_t)n);
+  return *this;
+}
+
+JsonWriter& JsonWriter::value(bool v) {
+  _sep(); _put(v ? "true" : "false");
+  return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* s) {
+  _sep();
+  _putc('"');
+  for (const char* p = s ? s : ""; *p; p++) {
+    unsigned char c = (unsigned char)*p;
+    if (c == '"' || c == '\\') { _putc('\\'); _putc((char)c); }
+    else if (c < 0x20) { char t[8]; snprintf(t, sizeof(t), "\\u%04x", c); _put(t); }
+    else _putc((char)c);
+  }
+  _putc('"');
+  return *this;
+}
+
+JsonWriter& JsonWriter::value(float v, int decimals) {
+  if (isnan(v) || isinf(v)) return null();
+  char t[24]; int n = snprintf(t, sizeof(t), "%.*f", decimals, (double)v);
+  _sep(); _put(t, (size_t)n);
+  return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+  _sep(); _put("null");
+  return *this;
+}
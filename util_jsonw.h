@@ -0,0 +1,63 @@
+// util_jsonw.h
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Streaming JSON writer over a caller-supplied buffer; never allocates.
+// With a flush sink the buffer is emitted in chunks whenever it fills (for
+// chunked HTTP responses); without one, output that does not fit sets
+// overflow() and is dropped.
+// Sensor conventions map to null: intOrNull() for -1 ("not valid"),
+// floatOrNull() for NaN.
+//
+//   char buf[128]; JsonWriter j(buf, sizeof(buf));
+//   j.beginObject().key("pulse").intOrNull(bpm).key("tempC").floatOrNull(t, 1).endObject();
+class JsonWriter {
+public:
+  typedef void (*Sink)(void* ctx, const char* data, size_t len);
+
+  JsonWriter(char* buf, size_t cap, Sink sink = nullptr, void* ctx = nullptr);
+
+  JsonWriter& beginObject();
+  JsonWriter& endObject();
+  JsonWriter& beginArray();
+  JsonWriter& endArray();
+  JsonWriter& key(const char* k);
+
+  JsonWriter& value(int v);
+  JsonWriter& value(unsigned v);
+  JsonWriter& value(long v)          { return value((long long)v); }
+  JsonWriter& value(unsigned long v) { return value((unsigned long long)v); }
+  JsonWriter& value(long long v);
+  JsonWriter& value(unsigned long long v);
+  JsonWriter& value(bool v);
+  JsonWriter& value(const char* s);           // escaped string
+  JsonWriter& value(float v, int decimals);   // NaN/inf -> null
+  JsonWriter& null();
+  JsonWriter& intOrNull(int v)                   { return v < 0 ? null() : value(v); }
+  JsonWriter& floatOrNull(float v, int decimals) { return value(v, decimals); }
+
+  // Emits any buffered output to the sink (no-op without one).
+  void        flush();
+  const char* c_str() const { return _buf; }
+  size_t      length() const { return _len; }
+  bool        overflow() const { return _overflow; }
+
+private:
+  char*    _buf;
+  size_t   _cap;
+  size_t   _len = 0;
+  Sink     _sink;
+  void*    _ctx;
+  uint32_t _first = 1;      // bit per nesting level: next element is the first
+  uint8_t  _depth = 0;
+  bool     _afterKey = false;
+  bool     _overflow = false;
+
+  void _sep();
+  void _put(const char* s, size_t n);
+  void _put(const char* s);
+  void _putc(char c) { _put(&c, 1); }
+  void _open(char c);
+  void _close(char c);
+};
@@ -0,0 +1,155 @@
+// util_scheduler.cpp
+#include "util_scheduler.h"
+#include "config.h"
+#ifdef SCHED_LIGHT_SLEEP
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+#endif
+
+int Scheduler::add(const char* name, TaskFn fn, void* ctx,
+                   uint32_t periodUs, uint8_t prio, uint32_t deadlineUs) {
+  if (_n >= MAX_TASKS || !fn || periodUs == 0) return -1;
+  Task& t = _t[_n];
+  memset(&t, 0, sizeof(t));
+  t.name       = name;
+  t.fn         = fn;
+  t.ctx        = ctx;
+  t.periodUs   = periodUs;
+  t.deadlineUs = deadlineUs ? deadlineUs : periodUs;
+  t.prio       = prio;
+  t.enabled    = true;
+  t.releaseUs  = micros();
+  return _n++;
+}
+
+void Scheduler::setPeriod(int id, uint32_t periodUs) {
+  if (id < 0 || id >= _n || periodUs == 0) return;
+  Task& t = _t[id];
+  // keep a deadline that tracked the period in step with it
+  if (t.deadlineUs == t.periodUs) t.deadlineUs = periodUs;
+  t.periodUs = periodUs;
+}
+
+void Scheduler::enable(int id, bool on) {
+  if (id < 0 || id >= _n) return;
+  if (on && !_t[id].enabled) _t[id].releaseUs = micros();
+  _t[id].enabled = on;
+}
+
+void Scheduler::begin() {
+  uint32_t now = micros();
+  for (int i = 0; i < _n; i++) _t[i].releaseUs = now;
+  resetStats();
+
+#ifdef SCHED_LIGHT_SLEEP
+  // Automatic light sleep in the idle task; needs a core built with
+  // CONFIG_PM_ENABLE and tickless idle, otherwise this only reports failure.
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_pm_config_t pm = {};
+#else
+  esp_pm_config_esp32c3_t pm = {};
+#endif
+  pm.max_freq_mhz = getCpuFrequencyMhz();
+  pm.min_freq_mhz = 40;
+  pm.light_sleep_enable = true;
+  esp_err_t err = esp_pm_configure(&pm);
+  if (err != ESP_OK) Serial.printf("Sched: light sleep unavailable (%d)\n", (int)err);
+#endif
+}
+
+uint32_t Scheduler::runOnce() {
+  uint32_t now = micros();
+
+  // most urgent due task
+  int pick = -1;
+  uint32_t pickDl = 0;
+  for (int i = 0; i < _n; i++) {
+    const Task& t = _t[i];
+    if (!t.enabled || (int32_t)(now - t.releaseUs) < 0) continue;
+    uint32_t dl = t.releaseUs + t.deadlineUs;
+    if (pick < 0 || t.prio < _t[pick].prio ||
+        (t.prio == _t[pick].prio && (int32_t)(dl - pickDl) < 0)) {
+      pick = i; pickDl = dl;
+    }
+  }
+
+  if (pick >= 0) {
+    Task& t = _t[pick];
+    uint32_t late = now - t.releaseUs;
+    t.fn(t.ctx);
+    uint32_t end = micros();
+    uint32_t ran = end - now;
+
+    t.runs++;
+    t.lastUs = ran;
+    t.totalUs += ran;
+    if (ran  > t.maxUs)     t.maxUs = ran;
+    if (late > t.maxLateUs) t.maxLateUs = late;
+    if ((int32_t)(end - pickDl) > 0) t.misses++;
+    _busyUs += ran;
+
+    // next release; if we fell whole periods behind, skip them (counted as
+    // misses) rather than running the task back-to-back to catch up
+    t.releaseUs += t.periodUs;
+    if ((int32_t)(end - t.releaseUs) >= (int32_t)t.periodUs) {
+      uint32_t behind = (end - t.releaseUs) / t.periodUs;
+      t.misses    += behind;
+      t.releaseUs += behind * t.periodUs;
+    }
+    now = end;
+  }
+
+  // time to the next release
+  uint32_t wait = UINT32_MAX;
+  for (int i = 0; i < _n; i++) {
+    const Task& t = _t[i];
+    if (!t.enabled) continue;
+    int32_t d = (int32_t)(t.releaseUs - now);
+    if (d <= 0) return 0;
+    if ((uint32_t)d < wait) wait = (uint32_t)d;
+  }
+  return wait;
+}
+
+void Scheduler::loop() {
+  uint32_t wait = runOnce();
+  if (wait) _idle(wait);
+}
+
+// Block the loop task for whole RTOS ticks; shorter waits just yield so a
+// near release is not overslept.
+void Scheduler::_idle(uint32_t us) {
+  if (us > 100000) us = 100000;          // nothing enabled: poll again later
+  TickType_t ticks = (TickType_t)(us / (portTICK_PERIOD_MS * 1000UL));
+  if (ticks) vTaskDelay(ticks);
+  else       taskYIELD();
+}
+
+float Scheduler::utilization() const {
+  uint32_t elMs = millis() - _statsT0;   // ms: does not wrap for 49 days
+  return elMs ? (float)((double)_busyUs / (elMs * 1000.0)) : 0.0f;
+}
+
+void Scheduler::resetStats() {
+  for (int i = 0; i < _n; i++) {
+    Task& t = _t[i];
+    t.runs = t.misses = t.lastUs = t.maxUs = t.maxLateUs = 0;
+    t.totalUs = 0;
+  }
+  _busyUs  = 0;
+  _statsT0 = millis();
+}
+
+void Scheduler::printStats(Print& out) const {
+  out.printf("sched: busy %.1f%%\n", utilization() * 100.0f);
+  out.println("  task       period  prio  runs    avg_us  max_us  late_us  miss");
+  for (int i = 0; i < _n; i++) {
+    const Task& t = _t[i];
+    uint32_t avg = t.runs ? (uint32_t)(t.totalUs / t.runs) : 0;
+    out.printf("  %-9s %7lu  %4u  %-7lu %6lu  %6lu  %7lu  %4lu%s\n",
+               t.name, (unsigned long)t.periodUs, (unsigned)t.prio,
+               (unsigned long)t.runs, (unsigned long)avg, (unsigned long)t.maxUs,
+               (unsigned long)t.maxLateUs, (unsigned long)t.misses,
+               t.enabled ? "" : "  (off)");
+  }
+}
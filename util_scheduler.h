@@ -0,0 +1,62 @@
+// util_scheduler.h
+#pragma once
+#include <Arduino.h>
+
+// Cooperative deadline scheduler for loop().
+// A fixed table of periodic tasks (plain function pointers, no allocation).
+// Each pass runs the most urgent due task: lowest priority number first,
+// earliest absolute deadline among equals. Between releases the loop task
+// blocks in vTaskDelay() until the next wake-up instead of spinning, so the
+// idle task (and light sleep, if enabled) gets the CPU.
+// Per task it records run time (last/avg/max), release lateness and
+// deadline misses; utilization() is the busy share of wall time since the
+// last resetStats() - the basis for a power budget.
+//
+//   sched.add("spo2", [](void*){ spo2.update(); }, nullptr, 20000, 1);
+//   void loop() { sched.loop(); }
+class Scheduler {
+public:
+  typedef void (*TaskFn)(void* ctx);
+  static const int MAX_TASKS = 16;
+
+  struct Task {
+    const char* name;
+    TaskFn   fn;
+    void*    ctx;
+    uint32_t periodUs;
+    uint32_t deadlineUs;     // relative to release
+    uint8_t  prio;           // 0 = most urgent
+    bool     enabled;
+    uint32_t releaseUs;      // next release time (micros)
+    // stats
+    uint32_t runs;
+    uint32_t misses;         // finished after its deadline, or releases skipped
+    uint32_t lastUs, maxUs;
+    uint64_t totalUs;
+    uint32_t maxLateUs;      // worst start delay after release
+  };
+
+  // Returns the task id, or -1 if the table is full. deadlineUs 0 = period.
+  int  add(const char* name, TaskFn fn, void* ctx,
+           uint32_t periodUs, uint8_t prio, uint32_t deadlineUs = 0);
+  void setPeriod(int id, uint32_t periodUs);   // takes effect from the next release
+  void enable(int id, bool on);
+
+  void begin();          // releases every task now; call at the end of setup()
+  void loop();           // runOnce() then idle until the next release
+  uint32_t runOnce();    // runs at most one due task; returns us to next release
+
+  int         count() const { return _n; }
+  const Task& task(int id) const { return _t[id]; }
+  float       utilization() const;     // busy / elapsed since resetStats(), 0..1
+  void        resetStats();
+  void        printStats(Print& out) const;
+
+private:
+  Task     _t[MAX_TASKS];
+  int      _n = 0;
+  uint32_t _statsT0 = 0;
+  uint64_t _busyUs = 0;
+
+  void _idle(uint32_t us);
+};
@@ -0,0 +1,96 @@
+// util_seqring.h
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+// Single-producer / multi-reader ring with a monotonic 64-bit sample index.
+// The producer (task, timer callback or ISR) never blocks. Readers copy
+// without locks: the 64-bit write index is published seqlock-style (RV32
+// has no 64-bit atomics) and a reader that was lapped during its copy
+// retries from the new oldest sample.
+// One slot is kept as a guard for the write in flight, so N-1 samples are
+// readable.
+template <typename T, size_t N>
+class SeqRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SeqRing size must be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value, "SeqRing holds plain data");
+public:
+  static constexpr size_t capacity() { return N - 1; }
+
+  // ---- producer side (single writer) ----
+  void push(const T& v) {
+    _buf[_w & MASK] = v;
+    _publish(++_w);
+  }
+  void reset() { _w = 0; _publish(0); }
+
+  // ---- reader side (any task) ----
+  // Index of the next sample to be written == total samples ever written.
+  uint64_t head() const {
+    uint32_t g0, g1, lo, hi;
+    do {
+      g0 = _gen.load(std::memory_order_acquire);
+      lo = _lo.load(std::memory_order_relaxed);
+      hi = _hi.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      g1 = _gen.load(std::memory_order_relaxed);
+    } while ((g0 & 1) || g0 != g1);
+    return ((uint64_t)hi << 32) | lo;
+  }
+
+  // Copies up to maxCount samples with index >= seq (oldest first) into out.
+  // Returns the count; `first` receives the index of out[0], which is > seq
+  // if the requested samples were already overwritten (a gap).
+  size_t readSince(uint64_t seq, T* out, size_t maxCount, uint64_t& first) const {
+    for (;;) {
+      uint64_t h = head();
+      uint64_t oldest = (h >= N) ? h - N + 1 : 0;
+      uint64_t s = seq < oldest ? oldest : (seq > h ? h : seq);
+      size_t n = (size_t)(h - s);
+      if (n > maxCount) n = maxCount;
+      _copy(s, out, n);
+      // The copy's loads must complete before the index is read again;
+      // head()'s acquire load alone would let them sink below it.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // still valid if the producer has not started overwriting index s
+      if (head() < s + N) { first = s; return n; }
+      seq = s;
+    }
+  }
+
+  // Copies the newest maxCount samples (oldest first).
+  size_t readLatest(T* out, size_t maxCount) const {
+    uint64_t h = head(), first;
+    uint64_t seq = (h > maxCount) ? h - maxCount : 0;
+    return readSince(seq, out, maxCount, first);
+  }
+
+private:
+  static constexpr size_t MASK = N - 1;
+
+  T        _buf[N];
+  uint64_t _w = 0;                       // producer-private copy of the index
+  std::atomic<uint32_t> _gen{0};         // odd while the index is being updated
+  std::atomic<uint32_t> _lo{0};
+  std::atomic<uint32_t> _hi{0};
+
+  void _publish(uint64_t w) {
+    uint32_t g = _gen.load(std::memory_order_relaxed);
+    _gen.store(g + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _lo.store((uint32_t)w, std::memory_order_relaxed);
+    _hi.store((uint32_t)(w >> 32), std::memory_order_relaxed);
+    _gen.store(g + 2, std::memory_order_release);
+  }
+
+  // at most two contiguous spans
+  void _copy(uint64_t s, T* out, size_t n) const {
+    size_t i0 = (size_t)(s & MASK);
+    size_t a  = (n < N - i0) ? n : N - i0;
+    memcpy(out, &_buf[i0], a * sizeof(T));
+    if (n > a) memcpy(out + a, &_buf[0], (n - a) * sizeof(T));
+  }
+};
@@ -0,0 +1,55 @@
+// util_stats.cpp
+#include "util_stats.h"
+
+#ifdef ENABLE_STATS
+
+StatHist g_stats[STAT_COUNT];
+
+const char* statName(StatProbe p) {
+  switch (p) {
+    case STAT_ECG_SAMPLE: return "ecgSample";
+    case STAT_ECG_DSP:    return "ecgDsp";
+    case STAT_SPO2_POLL:  return "spo2Poll";
+    case STAT_SPO2_DSP:   return "spo2Dsp";
+    case STAT_PPG_RATE:   return "ppgRate";
+    case STAT_WEB:        return "web";
+    case STAT_BLE:        return "ble";
+    case STAT_OLED:       return "oled";
+    case STAT_OTA:        return "ota";
+    case STAT_LOG:        return "log";
+    default:              return "?";
+  }
+}
+
+uint32_t StatHist::quantileCycles(float q) const {
+  if (!count) return 0;
+  uint32_t want = (uint32_t)(q * count), seen = 0;
+  for (int k = 0; k < BUCKETS; k++) {
+    seen += bucket[k];
+    if (seen > want) return k < BUCKETS - 1 && (2u << k) < maxCycles ? (2u << k) : maxCycles;
+  }
+  return maxCycles;
+}
+
+void statsReset() {
+  memset(g_stats, 0, sizeof(g_stats));
+}
+
+void statsPrint(Print& out) {
+  uint32_t mhz = getCpuFrequencyMhz();
+  out.printf("%-10s %8s %8s %8s %8s %8s\n", "probe", "n", "mean us", "p50 us", "p99 us", "max us");
+  for (int i = 0; i < STAT_COUNT; i++) {
+    const StatHist& h = g_stats[i];
+    if (!h.count) continue;
+    out.printf("%-10s %8lu %8lu %8lu %8lu %8lu\n", statName((StatProbe)i),
+               (unsigned long)h.count,
+               (unsigned long)(h.sumCycles / h.count / mhz),
+               (unsigned long)(h.quantileCycles(0.50f) / mhz),
+               (unsigned long)(h.quantileCycles(0.99f) / mhz),
+               (unsigned long)(h.maxCycles / mhz));
+  }
+  out.printf("heap free %lu, min %lu\n",
+             (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap());
+}
+
+#endif // ENABLE_STATS
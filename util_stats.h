@@ -0,0 +1,71 @@
+// util_stats.h
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Timing probes for the hot paths, read out at /api/stats and on Serial.
+// STAT_SCOPE(p) at the top of a block times it with the CPU cycle counter
+// (a single CSR read on either side) into a per-probe histogram with
+// power-of-two buckets, so recording is a few instructions and never
+// allocates. Each probe is written from one task only.
+// Without ENABLE_STATS the macro expands to nothing and no tables exist.
+enum StatProbe : uint8_t {
+  STAT_ECG_SAMPLE,     // ADC read + ring push (timer callback or poll)
+  STAT_ECG_DSP,        // block filter + QRS (ENABLE_RTOS_TASKS)
+  STAT_SPO2_POLL,      // MAX30102 FIFO read
+  STAT_SPO2_DSP,       // SpO2/BPM/PI processing
+  STAT_PPG_RATE,       // pulse-rate autocorrelation (1 Hz, inside spo2Dsp)
+  STAT_WEB,            // web.handle(), incl. SSE pump
+  STAT_BLE,            // ble.handle() + ECG frames
+  STAT_OLED,           // one OLED frame
+  STAT_OTA,
+  STAT_LOG,            // flash log poll (incl. block writes)
+  STAT_COUNT
+};
+
+#ifdef ENABLE_STATS
+
+struct StatHist {
+  // bucket k holds durations of [2^k, 2^(k+1)) cycles; the last is open
+  static const int BUCKETS = 24;
+  uint32_t count;
+  uint32_t maxCycles;
+  uint64_t sumCycles;
+  uint32_t bucket[BUCKETS];
+
+  inline void add(uint32_t cycles) {
+    int k = cycles ? 31 - __builtin_clz(cycles) : 0;
+    bucket[k < BUCKETS ? k : BUCKETS - 1]++;
+    count++;
+    sumCycles += cycles;
+    if (cycles > maxCycles) maxCycles = cycles;
+  }
+  // upper bound of the bucket holding the q-quantile, in cycles, but no
+  // more than maxCycles
+  uint32_t quantileCycles(float q) const;
+};
+
+extern StatHist g_stats[STAT_COUNT];
+
+const char* statName(StatProbe p);
+void        statsReset();
+void        statsPrint(Print& out);
+
+class StatScope {
+public:
+  explicit StatScope(StatProbe p) : _p(p), _t0(ESP.getCycleCount()) {}
+  ~StatScope() { g_stats[_p].add(ESP.getCycleCount() - _t0); }
+private:
+  StatProbe _p;
+  uint32_t  _t0;
+};
+
+#define STAT_CAT2(a, b) a##b
+#define STAT_CAT(a, b)  STAT_CAT2(a, b)
+#define STAT_SCOPE(p)   StatScope STAT_CAT(_statScope, __LINE__)(p)
+
+#else
+
+#define STAT_SCOPE(p)   do {} while (0)
+
+#endif // ENABLE_STATS
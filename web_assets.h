@@ -0,0 +1,158 @@
+// web_assets.h
+// Generated by tools/embed_assets.py from web/ -- do not edit.
+#pragma once
+#include <Arduino.h>
+
+// index.html: 5624 bytes -> 2363 gzipped
+static const uint8_t WEB_INDEX_HTML_GZ[] PROGMEM = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0xcd,0x58,0xcd,0x72,0xdb,0x38,
+  0x12,0xbe,0xeb,0x29,0x10,0xa5,0x12,0x91,0x91,0x44,0x91,0xb4,0x63,0x2b,0xa2,0xa8,
+  0x54,0xe2,0xf1,0x6c,0x52,0xb5,0xc9,0xa4,0x92,0xd9,0xcc,0x21,0x95,0x9d,0x82,0x48,
+  0x50,0x84,0x43,0x91,0x34,0x00,0xea,0xc7,0x8a,0x2e,0xf3,0x44,0x7b,0xdb,0xfb,0x3e,
+  0xca,0x3e,0xc9,0x76,0x03,0x94,0x4c,0xd9,0x1e,0x3b,0x35,0xa7,0x2d,0x57,0x99,0x64,
+  0xa3,0xd1,0xbf,0x5f,0x37,0x1a,0x1a,0x3f,0x8a,0x8b,0x48,0xad,0x4b,0x46,0x52,0x35,
+  0xcf,0x26,0xe3,0xfa,0x3f,0xa3,0xf1,0x64,0x3c,0x67,0x8a,0x92,0x28,0xa5,0x42,0x32,
+  0x15,0xb6,0x2b,0x95,0xf4,0x87,0xed,0x49,0xcb,0x90,0x73,0x3a,0x67,0x61,0x7b,0xc1,
+  0xd9,0xb2,0x2c,0x84,0x6a,0x93,0xa8,0xc8,0x15,0xcb,0x81,0x6d,0xc9,0x63,0x95,0x86,
+  0x31,0x5b,0xf0,0x88,0xf5,0xf5,0x47,0x8f,0xe7,0x5c,0x71,0x9a,0xf5,0x65,0x44,0x33,
+  0x16,0x7a,0x28,0x43,0x71,0x95,0xb1,0xc9,0xf9,0xa7,0x0f,0x47,0xfe,0xd9,0x11,0x79,
+  0xc3,0x68,0xa6,0x52,0xf2,0xae,0x00,0xc6,0x42,0x8c,0x07,0x66,0xb5,0x35,0x96,0x6a,
+  0x8d,0xcf,0x69,0x11,0xaf,0x37,0x09,0x28,0xe8,0x27,0x74,0xce,0xb3,0xf5,0x48,0xae,
+  0xa5,0x62,0xf3,0x7e,0xc5,0x7b,0xaf,0x04,0x08,0x0e,0xe6,0x54,0xcc,0x78,0x3e,0xf2,
+  0xdd,0x72,0x15,0x4c,0x69,0xf4,0x6d,0x26,0x8a,0x2a,0x8f,0x47,0x8f,0xdd,0xa9,0xcb,
+  0xbc,0xa3,0x20,0x2a,0xb2,0x42,0x8c,0x1e,0x33,0x96,0x6c,0x5b,0x4e,0x44,0x45,0xbc,
+  0x69,0x32,0x79,0xc7,0x1e,0xf5,0xfd,0x60,0x5a,0x88,0x98,0x89,0xbe,0xa0,0x31,0xaf,
+  0xe4,0xc8,0xf3,0x41,0x54,0x49,0xe3,0x98,0xe7,0xb3,0x91,0x77,0x02,0x1f,0x73,0xba,
+  0x32,0xee,0x8c,0x4e,0x8e,0xb5,0x9e,0x62,0xd5,0x97,0x29,0x8d,0x8b,0xe5,0xc8,0x25,
+  0xc7,0xe5,0x8a,0x20,0x17,0x11,0xb3,0x29,0xb5,0xdc,0x1e,0xfe,0x39,0x47,0xf6,0xb6,
+  0x95,0x7a,0xc6,0x70,0xc9,0xaf,0x98,0xb1,0xaf,0xb6,0xd5,0x25,0x2e,0xf1,0xe0,0x1b,
+  0x2c,0x12,0xc5,0x72,0x13,0x73,0x59,0x66,0x74,0x3d,0x4a,0x32,0xb6,0x0a,0x2e,0x2a,
+  0xa9,0x78,0xb2,0xee,0xd7,0x31,0x1d,0xc9,0x92,0x42,0x2c,0xa7,0x4c,0x2d,0x19,0xcb,
+  0x77,0x02,0x50,0x9b,0x0b,0xbb,0x33,0x3a,0x65,0xd9,0xa6,0x00,0x16,0xae,0xd6,0x23,
+  0x67,0x08,0xa4,0x05,0xcd,0x2a,0x66,0xf4,0x2e,0x19,0x9f,0xa5,0x6a,0x74,0xe2,0x22,
+  0xeb,0x94,0x8a,0x4d,0x6a,0x08,0xde,0xcd,0x50,0xf9,0xb7,0x42,0x80,0x4e,0x17,0x0b,
+  0x26,0x92,0x0c,0x5c,0x4c,0x79,0x1c,0xef,0x75,0xf7,0x55,0x51,0xe2,0x32,0x88,0x4c,
+  0x78,0x96,0x5d,0xcb,0x74,0x9f,0x04,0x26,0x44,0xee,0x81,0xec,0xe3,0x88,0x26,0xcf,
+  0xdd,0x40,0x09,0x9a,0x4b,0x40,0x42,0x91,0x8f,0x34,0x17,0x71,0x7c,0xb9,0x6d,0xc9,
+  0x39,0xcd,0x1a,0xf6,0x9f,0x6e,0x5b,0x74,0x53,0x27,0x6c,0x48,0xa7,0xc7,0x49,0x12,
+  0x28,0xb6,0x52,0xfd,0x98,0x45,0x85,0xa0,0x7a,0x73,0x5e,0xe4,0x6c,0xdb,0x8a,0x68,
+  0xbe,0xa0,0x72,0x63,0xf4,0x69,0xd5,0x3b,0x33,0x4e,0xdc,0x3a,0x5d,0x35,0xc1,0x77,
+  0x6f,0xe1,0x22,0x81,0xa4,0x4f,0x6f,0xf8,0x3b,0xdc,0x27,0x47,0xfb,0x87,0x08,0xd8,
+  0xb6,0xc6,0x03,0x83,0xc1,0xf1,0x40,0x97,0x44,0x6b,0x8c,0x58,0x84,0x47,0xcc,0x17,
+  0x24,0xca,0xa8,0x94,0x61,0x1b,0x01,0x05,0x90,0x26,0x64,0x9c,0x7a,0x06,0xd1,0xfd,
+  0x3b,0x20,0x0d,0x6b,0xc8,0xd2,0xd8,0x07,0x69,0x6f,0x4f,0x9a,0x04,0x9d,0xc9,0xf6,
+  0xe4,0x43,0x95,0x49,0x36,0x1e,0xc0,0xc2,0xc1,0xaa,0x4e,0x6a,0x9b,0xf0,0x38,0x6c,
+  0x4f,0xcb,0x79,0x7b,0xd2,0xef,0x13,0x78,0xd6,0x7c,0xfa,0xff,0x0f,0xca,0xff,0x54,
+  0xfe,0xf2,0xdf,0x3f,0xfe,0xb8,0x57,0x81,0x2c,0x0b,0x5f,0x6b,0x78,0xf2,0x17,0xe4,
+  0xff,0xca,0xe6,0xe5,0xbd,0xd2,0xa1,0x74,0x4b,0x94,0xee,0xf4,0xc9,0x7f,0xfe,0x75,
+  0x76,0x8f,0x86,0x9d,0xc1,0x7c,0x96,0xd3,0xec,0x4e,0x0e,0x40,0xf4,0xa1,0x0d,0x88,
+  0xc7,0x3a,0x48,0x7a,0xe9,0x21,0xf3,0x35,0xfa,0x8c,0xcf,0x8a,0xaa,0x4a,0xb6,0x27,
+  0x09,0x54,0x3c,0x13,0x23,0x92,0x50,0x9d,0x06,0xcd,0x50,0xf3,0x4d,0xc6,0x94,0xa4,
+  0x82,0x25,0x61,0x7b,0x00,0xa5,0x99,0xf0,0x59,0x7b,0x62,0x9e,0xe3,0x01,0x9d,0xec,
+  0x59,0x8d,0x32,0x83,0x07,0xa2,0xd1,0x13,0xb6,0x9b,0xb8,0x82,0xc2,0x69,0x4f,0xce,
+  0xcf,0xfe,0xb6,0xc7,0x84,0x41,0xb2,0x36,0x82,0x45,0xb3,0x36,0x31,0x1d,0xb4,0x0d,
+  0x35,0xdb,0x26,0x06,0xc2,0x61,0x1b,0x40,0x8d,0xde,0x18,0xd6,0x7b,0x5c,0x99,0x24,
+  0x72,0x44,0xc6,0xd0,0x30,0x72,0x2d,0x2f,0x91,0x18,0x68,0x30,0x0d,0x08,0x13,0xf2,
+  0xe6,0xea,0xd0,0x9f,0x9d,0xca,0x9d,0xeb,0x37,0x5c,0xf8,0xb1,0x74,0x83,0x27,0x04,
+  0x0a,0xf3,0x7e,0xc4,0x82,0x92,0x3f,0x03,0xed,0xee,0x21,0x23,0xc1,0x4b,0x35,0x69,
+  0x51,0xb9,0xce,0x23,0x92,0x54,0x79,0x84,0xc5,0x4e,0x14,0x8f,0xbe,0x7d,0xe6,0x0a,
+  0x92,0x61,0xd9,0x1b,0x30,0x49,0x89,0x35,0x3e,0x08,0x1e,0x38,0x52,0x11,0x41,0x42,
+  0x42,0x97,0x94,0x2b,0x92,0x30,0x15,0xa5,0x56,0x67,0x40,0x4b,0x3e,0x80,0x13,0x4a,
+  0xf0,0x48,0x76,0xec,0xa0,0x66,0xbb,0xd8,0xb3,0x09,0xe7,0x42,0x16,0xb9,0x65,0x07,
+  0x5a,0x08,0x9c,0x7d,0xd5,0x1c,0x5a,0xac,0x33,0x63,0xea,0x3c,0x63,0xf8,0xfa,0x7a,
+  0xfd,0x36,0xb6,0x3a,0x60,0x65,0xc7,0x76,0xb0,0xf3,0x9c,0x99,0x26,0x4c,0x40,0x82,
+  0x75,0xe1,0x94,0x58,0x9c,0x61,0x98,0x57,0x59,0xf6,0xb2,0xd3,0xef,0x77,0x46,0x35,
+  0xc9,0xee,0x76,0xd0,0xb3,0xce,0x03,0x62,0xb1,0xb0,0x6e,0xc8,0xd5,0x62,0x91,0x7e,
+  0x28,0x15,0x29,0x28,0xf4,0xc9,0x43,0x22,0xb1,0x9a,0xee,0x12,0x89,0xf4,0xb3,0x6b,
+  0x99,0x0e,0x48,0xb5,0xba,0x35,0x19,0xd8,0x8b,0x9f,0xf9,0x8a,0xc5,0x96,0x67,0xa3,
+  0x12,0x28,0xc3,0x5a,0x8d,0x09,0x57,0xc9,0x41,0xc6,0x3b,0xaa,0x52,0x07,0xda,0x28,
+  0x1c,0x67,0xf5,0x3b,0xcf,0x2d,0x0f,0x3e,0xc0,0x65,0x4e,0xbe,0x7f,0x27,0xae,0xfd,
+  0x60,0x14,0xa9,0x00,0xd3,0x74,0x0d,0x38,0xa6,0xe5,0x83,0x69,0x25,0x7f,0xe6,0xb9,
+  0xa0,0xf5,0x41,0xcf,0x0c,0x2c,0x6f,0xf9,0xd6,0xd9,0x55,0x68,0x07,0xdc,0x31,0xef,
+  0x5d,0x0c,0xe1,0x25,0xdf,0x79,0xdb,0x19,0x81,0x4b,0xff,0x26,0x97,0x15,0xcd,0xe0,
+  0x4c,0xd1,0x7c,0xb0,0xfa,0x90,0xb1,0x06,0xa3,0x77,0x85,0x12,0x56,0x5e,0x97,0xf3,
+  0xc3,0xfc,0x18,0xda,0x2e,0xed,0x68,0x80,0x10,0xef,0x64,0xd3,0x02,0xeb,0xe3,0x47,
+  0xad,0x1a,0xe9,0xc0,0x36,0x97,0x76,0x47,0x9b,0xb0,0x8d,0x28,0x22,0x95,0xd9,0x1b,
+  0x1d,0xed,0x02,0x62,0x93,0x15,0x33,0xf8,0x0e,0xc8,0xb6,0x05,0xe7,0x9a,0xce,0x40,
+  0xb4,0x90,0xa0,0xfb,0x3e,0x5b,0x51,0x58,0xcd,0xab,0x56,0xc0,0x0b,0x3b,0x90,0x4d,
+  0x1b,0xbe,0x52,0x56,0xc7,0x8f,0x91,0x63,0x5f,0x47,0xb1,0xa0,0x4b,0x28,0x55,0x4b,
+  0xd2,0x79,0x99,0x31,0xd9,0x23,0x45,0x92,0xe8,0x82,0x32,0x32,0x96,0x21,0xee,0x37,
+  0xe3,0x5a,0xaa,0xdf,0x4d,0xe7,0x41,0x83,0x41,0xbe,0x13,0x65,0x8c,0x8a,0x8f,0x2c,
+  0x52,0x7a,0xb8,0x59,0xf6,0x52,0x7b,0xb7,0x22,0x95,0x28,0xbe,0xb1,0x4f,0xba,0xcf,
+  0x75,0x1e,0xfb,0xee,0x91,0x7b,0xec,0x76,0x02,0x5c,0xc9,0x78,0xce,0x7e,0xd3,0xbd,
+  0xcc,0xd3,0xdf,0x53,0x06,0x3d,0xf0,0x03,0x20,0x09,0xaa,0x0f,0xbf,0xe7,0x30,0x5d,
+  0xfc,0x5a,0x80,0xc0,0x74,0xe0,0xdb,0xfb,0x1d,0x40,0x59,0x5e,0x53,0x8c,0x74,0x53,
+  0xae,0x3c,0xb1,0x1e,0xd5,0xe6,0x7f,0xff,0x5e,0xbf,0x38,0x19,0xcb,0x67,0xa0,0x21,
+  0x0c,0x5d,0x9b,0x08,0xa6,0x2a,0x91,0x23,0x6b,0xc6,0x14,0x01,0xb8,0x86,0xe4,0xc8,
+  0x3f,0x3d,0x39,0xed,0x01,0x8a,0xc3,0x3e,0xbe,0x0e,0x71,0x31,0x29,0x84,0x85,0x0c,
+  0x3c,0x74,0x03,0x3e,0x3e,0x14,0x14,0xf0,0x6e,0xd7,0xde,0x98,0x98,0x2c,0xc2,0x7a,
+  0xed,0x0b,0xff,0x1a,0xa0,0xf6,0xc5,0x18,0x64,0xda,0x28,0x77,0x61,0xbe,0x27,0x20,
+  0xd8,0x46,0xe1,0x8b,0x60,0x6b,0x0c,0xc4,0xb1,0x03,0x18,0xc6,0xcf,0x5d,0x7b,0x83,
+  0x0b,0xf0,0xde,0x85,0xd1,0x67,0xbb,0x0f,0xf4,0xfb,0xf0,0x86,0xc2,0x3b,0xc2,0x08,
+  0xa9,0x79,0xd9,0x79,0x3c,0x1c,0x0e,0x01,0x46,0xf5,0xf0,0x74,0x33,0xa2,0xfe,0xad,
+  0x88,0xde,0x72,0xec,0xbd,0xf1,0xa5,0x51,0xd6,0xab,0xd0,0xe2,0x03,0xeb,0x7d,0x1f,
+  0x8a,0xfe,0xd9,0xb2,0x59,0xef,0xeb,0x30,0xed,0x5b,0xd6,0xb5,0xb7,0xe8,0x82,0x3d,
+  0xd8,0x39,0x03,0xdc,0xa9,0xe1,0x06,0x07,0xb9,0x09,0x75,0x23,0x7f,0xab,0xde,0x1a,
+  0xa0,0xcb,0xa0,0x09,0x92,0x46,0x0e,0x35,0x15,0xd1,0x7e,0xe0,0x1f,0xda,0xb9,0x83,
+  0x38,0xa0,0xf1,0xf7,0xcf,0x6f,0xcf,0x7f,0x0b,0x4f,0x21,0x40,0x2d,0xb4,0x1b,0x6b,
+  0xaa,0x4a,0xc2,0x2f,0x5f,0x7b,0xf8,0xfa,0x1e,0x60,0xac,0xcb,0x29,0x68,0x0d,0x06,
+  0xe4,0x35,0xcf,0xa9,0x58,0x93,0x44,0xc0,0xbd,0x83,0xe0,0x30,0x08,0x93,0x1b,0xb1,
+  0x24,0x63,0x24,0x67,0xea,0xf7,0x25,0x17,0xcc,0x49,0x6d,0xe8,0x09,0x6f,0xde,0x75,
+  0x7a,0x04,0xa6,0xd6,0x1e,0xc1,0x4b,0x4d,0x8f,0x24,0x19,0x9d,0x01,0xda,0xab,0x23,
+  0x9f,0xa8,0x1e,0x0a,0x02,0xb5,0x23,0x52,0x79,0x27,0x24,0x41,0xf2,0xc9,0x31,0x91,
+  0xec,0xb2,0xa7,0x09,0x11,0x0c,0x87,0xaa,0x47,0xae,0xf8,0xac,0x7f,0x45,0x67,0x64,
+  0x41,0x05,0x87,0x0e,0x10,0xb3,0x4c,0x51,0xe9,0x34,0x2a,0x49,0x2b,0xff,0x19,0x0d,
+  0xb1,0xaa,0x61,0xa3,0x86,0xe2,0x05,0x94,0x61,0xce,0x96,0xe4,0x27,0xaa,0xe8,0x67,
+  0xb8,0x19,0xc1,0xb2,0x33,0xad,0x92,0x04,0xad,0xc1,0xd7,0xb5,0x62,0xbf,0x24,0x09,
+  0x5c,0xa6,0xf6,0x9f,0x7f,0xd7,0x18,0xa8,0xd1,0x4d,0x80,0xff,0x8b,0xfb,0xf5,0x51,
+  0x18,0x9e,0xfa,0xd8,0x5f,0xe1,0xcb,0xd3,0x5f,0xa7,0xf5,0x97,0x8f,0x5f,0xbe,0x4d,
+  0x54,0x0a,0x87,0xb1,0xd6,0x74,0x2e,0x04,0xe4,0x1c,0xfa,0x6c,0x6c,0x22,0x63,0x3a,
+  0x8c,0x31,0x27,0x01,0x6b,0x36,0x3a,0x0a,0x23,0xd8,0x7b,0xf4,0x55,0x97,0xfc,0xe8,
+  0xd1,0x23,0xd4,0x72,0xfc,0xf5,0xa9,0x67,0x43,0x70,0x4c,0x27,0xdd,0xd3,0x7c,0xa0,
+  0xa9,0x51,0xbc,0xc0,0x46,0xf2,0x0f,0x70,0xfe,0xc8,0xb7,0x9e,0xf7,0x94,0xa8,0x98,
+  0x4d,0xb6,0x3b,0x1b,0x13,0x07,0x45,0x02,0x0a,0xbc,0x1a,0x5b,0x89,0x93,0xe8,0x5e,
+  0xb5,0xdf,0xe5,0x9d,0x58,0x2f,0xcc,0xae,0xa0,0x66,0x80,0x10,0x03,0xc7,0xfb,0x6a,
+  0x3e,0x65,0xc2,0x3a,0x10,0xef,0x79,0x86,0xd3,0x26,0x5d,0x72,0xb8,0x50,0x2b,0x7e,
+  0x76,0xec,0xbf,0x38,0x7e,0x71,0x72,0xea,0xbf,0x38,0x69,0x22,0x36,0xbf,0xa9,0xd1,
+  0xab,0x55,0xf6,0x88,0xac,0xb3,0xf0,0x16,0xe9,0xaf,0x84,0xa0,0x6b,0x2b,0xaf,0x2d,
+  0x41,0x90,0x95,0xa1,0xef,0xf5,0x48,0x29,0xd8,0x02,0xaa,0xc4,0xd8,0x57,0x00,0x92,
+  0xae,0xeb,0x26,0x6f,0xd4,0x8d,0xd9,0x72,0x15,0xc2,0xa9,0x27,0x53,0xfc,0x3f,0x0d,
+  0x6a,0x7a,0x5c,0x40,0x70,0xa7,0x21,0xc4,0xad,0xec,0x76,0xa1,0x3d,0x5c,0x91,0xef,
+  0x70,0x56,0x4c,0x9f,0xba,0xab,0xd3,0xc4,0x1e,0x8f,0x65,0x1a,0xc0,0x8e,0x6e,0x78,
+  0x0a,0x4d,0x9d,0x2c,0x53,0x9e,0x31,0xb3,0x38,0x74,0xed,0x9d,0x04,0x34,0x81,0x74,
+  0x61,0xd3,0xd5,0x64,0x32,0xf1,0x6c,0xf2,0x4f,0xd2,0xb7,0xae,0x20,0x2d,0xbb,0x75,
+  0x2c,0x44,0x70,0x05,0xd9,0x0c,0x69,0xbb,0x8b,0x26,0x50,0xe5,0xae,0xb6,0x4c,0xcf,
+  0x23,0x09,0xd6,0xd5,0x1e,0xa2,0xd3,0x93,0x63,0x44,0x97,0xb4,0xa0,0xea,0x1a,0x00,
+  0x9d,0x72,0x0c,0x1b,0x55,0xc5,0x54,0x2f,0x20,0x0a,0xeb,0x58,0x61,0x10,0x87,0x26,
+  0x56,0xc0,0x54,0xb7,0xa6,0x5d,0x4f,0x69,0x06,0xe7,0x7a,0x55,0x47,0x09,0x51,0xa9,
+  0xad,0x44,0x3a,0xfe,0x52,0x70,0x06,0xa5,0xf1,0x4a,0x59,0xe6,0xb0,0xad,0x6d,0xab,
+  0x86,0x68,0x5c,0x5d,0xe0,0x50,0x00,0xa1,0x1e,0xad,0x75,0x8d,0xff,0x04,0xa7,0xd2,
+  0x07,0x96,0xe3,0x2d,0xdb,0x50,0x1b,0x27,0xd6,0x65,0xc5,0x2a,0x86,0x0c,0x66,0xf0,
+  0x43,0xec,0x1d,0xee,0x68,0x36,0xfc,0xc3,0x15,0x30,0x08,0xc1,0x60,0x6c,0x00,0x39,
+  0x52,0xbd,0xca,0xf9,0x5c,0xdf,0x1e,0x4d,0xdd,0x5a,0x76,0x38,0xd9,0xdc,0x6d,0xc0,
+  0xfe,0xa4,0x34,0xdd,0xa8,0x57,0x1b,0x8d,0xa7,0xb3,0x7d,0x10,0x64,0x5a,0x96,0xb0,
+  0xb1,0x71,0xa6,0x6a,0x33,0xcd,0x2e,0x30,0xc0,0xbc,0x38,0x10,0x79,0x38,0xef,0x2d,
+  0x1d,0x5b,0x27,0x11,0xc5,0x7c,0xcf,0xbd,0xaf,0xfa,0x9a,0xd3,0x84,0x75,0xb2,0x6b,
+  0x8b,0xf6,0x2d,0x51,0x32,0xe3,0x11,0x3b,0xe4,0xee,0xef,0xb9,0x0f,0x4c,0x83,0xec,
+  0x32,0x3a,0x47,0xd3,0x1a,0xd9,0x67,0xbb,0xc2,0x38,0x5f,0xc0,0x1c,0xf1,0xa9,0xa8,
+  0x04,0x48,0x33,0xf3,0x32,0xc8,0x1c,0x98,0x3d,0x2f,0x93,0xb9,0x0a,0x21,0x99,0x4f,
+  0xf3,0xb0,0xd3,0x6d,0x08,0x07,0xc7,0xa4,0x53,0xe4,0x73,0x26,0x25,0x9d,0x31,0x1c,
+  0x8b,0xd8,0x02,0x63,0xd8,0x28,0x49,0x9c,0xb1,0x9b,0xbd,0x71,0x0f,0x42,0xb6,0x70,
+  0x62,0xe8,0x88,0x0f,0x4e,0x8b,0xc9,0xed,0x59,0x0f,0x06,0x3c,0xf9,0xf0,0xd8,0xf6,
+  0x27,0x83,0xe2,0x85,0x03,0x0d,0x8f,0xbc,0x24,0x1d,0x98,0x5d,0x62,0x89,0xdd,0xaf,
+  0x43,0xe0,0x84,0xa8,0xc7,0x4e,0x93,0xd6,0x1d,0x9b,0xa1,0x5d,0xa7,0x14,0x26,0xc6,
+  0xda,0xdc,0x06,0x0c,0x75,0xcd,0xed,0x63,0xc1,0xb0,0xf7,0x62,0x24,0x34,0x96,0xfe,
+  0x82,0x7d,0x1d,0x01,0xd1,0xca,0x73,0x18,0xaa,0x00,0x7d,0x9d,0x00,0x45,0x6f,0xef,
+  0xba,0xfe,0xec,0xf3,0x78,0xe3,0xee,0x73,0x69,0xa0,0xa1,0xcf,0x49,0x7d,0x50,0xa2,
+  0xaf,0xda,0xc5,0xa7,0x92,0xe7,0x11,0x8c,0x63,0xdd,0x7a,0x39,0x78,0xf0,0xc6,0x04,
+  0x8c,0x77,0xa6,0xbe,0x7b,0x69,0x07,0xf7,0xe4,0xf8,0x46,0xef,0xd8,0x5d,0xb1,0x28,
+  0x7e,0xbd,0xd6,0x27,0x9f,0x65,0xff,0x9f,0xe5,0xfd,0xae,0x1c,0xd7,0x61,0xd2,0x7b,
+  0xf1,0xac,0xea,0xe2,0xb3,0x31,0xa0,0x91,0x5b,0x4d,0x41,0xeb,0xf8,0x91,0x71,0x1e,
+  0x4e,0x7b,0x38,0x88,0x98,0x80,0xcb,0xb0,0x75,0x7d,0x97,0xed,0x79,0xae,0x0b,0x27,
+  0xc1,0xc1,0xed,0x36,0x68,0x61,0x33,0x58,0xf2,0x3c,0x2e,0x96,0x4e,0xa3,0x46,0xed,
+  0x66,0x39,0x07,0x2d,0x3d,0x68,0x6d,0xc8,0x4d,0xb9,0xb0,0xda,0xf3,0xf7,0x32,0x0d,
+  0x2f,0xd1,0xbf,0x5f,0xd5,0xf7,0xea,0xf1,0x40,0xff,0x74,0x35,0x1e,0xe8,0x5f,0x78,
+  0x5b,0xff,0x03,0xb3,0x7b,0x86,0x40,0xf8,0x15,0x00,0x00,
+};
+static const size_t WEB_INDEX_HTML_GZ_LEN = 2363;
+static const char WEB_INDEX_HTML_ETAG[] = "\"039070d377706918\"";